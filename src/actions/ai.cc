@@ -7,8 +7,44 @@
 #include "core/core.h"
 
 
+// Skips through up to the given number of seconds in which the active Mobiles do nothing but charge their action timers and roll their chances to act, stopping at the first second in which any of them might act. Returns the number of seconds skipped.
+int AI::skip_seconds(const std::vector<std::shared_ptr<Mobile>> &active_mobs, int seconds)
+{
+    if (seconds <= 0) return 0;
+    if (!active_mobs.size()) return seconds;
+
+    // Mobiles with someone to fight make decisions that depend on more than just the RNG, so they have to be ticked every second.
+    for (auto mob : active_mobs)
+        if (mob->is_dead() || mob->hostility_vector().size()) return 0;
+
+    // The chances to act are rolled exactly as tick_mob() rolls them, in the same order, so the RNG ends up in the same state as if each second were ticked. The second in which a chance comes up is rolled again by tick_mob(), from the same RNG state.
+    const auto rng = core()->rng();
+    const uint32_t player_location = core()->world()->player()->location();
+    int skipped = 0;
+    while (skipped < seconds)
+    {
+        const pcg32 rng_state = rng->pcg_rng_;
+        bool might_act = false;
+        for (auto mob : active_mobs)
+        {
+            if (mob->tag(MobileTag::AggroOnSight) && rng->rnd(AGGRO_CHANCE) == 1 && mob->location() == player_location) might_act = true;
+            else if (rng->rnd(TRAVEL_CHANCE) == 1) might_act = true;
+            if (might_act) break;
+        }
+        if (might_act)
+        {
+            rng->pcg_rng_ = rng_state;
+            break;
+        }
+        skipped++;
+    }
+    for (auto mob : active_mobs)
+        mob->add_seconds(skipped);
+    return skipped;
+}
+
 // Processes AI for a specific active Mobile.
-void AI::tick_mob(std::shared_ptr<Mobile> mob, uint32_t)
+void AI::tick_mob(std::shared_ptr<Mobile> mob)
 {
     mob->add_second();  // This is called every second, per active Mobile.
     const auto rng = core()->rng();
@@ -25,10 +61,10 @@ void AI::tick_mob(std::shared_ptr<Mobile> mob, uint32_t)
             attack_target = core()->world()->player();
             break;
         }
-        else for (size_t m = 0; m < core()->world()->mob_count(); m++)
+        else for (auto m : core()->world()->mobs_in_room(location))
         {
             const auto check_mob = core()->world()->mob_vec(m);
-            if (check_mob->id() == h && check_mob->location() == mob->location())
+            if (check_mob->id() == h)
             {
                 attack_target = check_mob;
                 break;
@@ -129,10 +165,13 @@ void AI::tick_mob(std::shared_ptr<Mobile> mob, uint32_t)
 }
 
 // Ticks all the mobiles in active rooms.
-void AI::tick_mobs()
+void AI::tick_mobs(const std::vector<std::shared_ptr<Mobile>> &active_mobs)
 {
-    for (size_t m = 0; m < core()->world()->mob_count(); m++)
-        tick_mob(core()->world()->mob_vec(m), m);
+    for (auto mob : active_mobs)
+    {
+        if (mob->is_dead()) continue;   // Skip any Mobiles killed earlier in this tick.
+        tick_mob(mob);
+    }
 }
 
 // Sends the Mobile in a random direction.
@@ -8,12 +8,14 @@
 
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 
 class AI
 {
 public:
-    static void tick_mobs();    // Ticks all the mobiles in active rooms.
+    static int  skip_seconds(const std::vector<std::shared_ptr<Mobile>> &active_mobs, int seconds);    // Skips through up to the given number of seconds in which the active Mobiles do nothing but charge their action timers and roll their chances to act. Returns the number of seconds skipped.
+    static void tick_mobs(const std::vector<std::shared_ptr<Mobile>> &active_mobs); // Ticks all the mobiles in active rooms.
 
 private:
     static constexpr int    AGGRO_CHANCE =                  60;     // 1 in X chance of starting a fight.
@@ -27,7 +29,7 @@ private:
     static constexpr int    STANCE_RANDOM_CHANCE =          500;    // 1 in X chance to pick a random stance, rather than making a strategic decision.
     static constexpr int    TRAVEL_CHANCE =                 300;    // 1 in X chance of traveling to another room.
 
-    static void tick_mob(std::shared_ptr<Mobile> mob, uint32_t vec_pos);    // Processes AI for a specific active Mobile.
+    static void tick_mob(std::shared_ptr<Mobile> mob);  // Processes AI for a specific active Mobile.
     static bool travel_randomly(std::shared_ptr<Mobile> mob, bool allow_dangerous_exits);   // Sends the Mobile in a random direction.
 };
 
@@ -6,6 +6,7 @@
 #include "core/core.h"
 #include "core/mathx.h"
 #include "core/strx.h"
+#include "core/symbols.h"
 
 #include <cmath>
 
@@ -336,18 +337,22 @@ void Combat::perform_attack(std::shared_ptr<Mobile> attacker, std::shared_ptr<Mo
     const CombatStance attacker_stance = attacker->stance();
     const CombatStance defender_stance = defender->stance();
 
-    std::string weapon_skill;   // If the player is involved in this fight, they will be using combat skills.
+    // The skills used in combat are interned once, rather than looked up by name on every attack.
+    static const uint32_t SKILL_ARCHERY = Symbols::intern("ARCHERY"), SKILL_BLOCK = Symbols::intern("BLOCK"), SKILL_DUAL_WIELD = Symbols::intern("DUAL_WIELD"), SKILL_EVASION = Symbols::intern("EVASION"),
+        SKILL_ONE_HANDED = Symbols::intern("ONE_HANDED"), SKILL_PARRY = Symbols::intern("PARRY"), SKILL_TWO_HANDED = Symbols::intern("TWO_HANDED"), SKILL_UNARMED = Symbols::intern("UNARMED");
+
+    uint32_t weapon_skill = Symbols::NONE;  // If the player is involved in this fight, they will be using combat skills.
     if (attacker_is_player || defender_is_player)
     {
         const WieldType wt = (attacker_is_player ? wield_type_attacker : wield_type_defender);
         switch (wt)
         {
-            case WieldType::NONE: case WieldType::SHIELD_ONLY: case WieldType::UNARMED: case WieldType::UNARMED_PLUS_SHIELD: weapon_skill = "UNARMED"; break;
-            case WieldType::DUAL_WIELD: weapon_skill = "DUAL_WIELD"; break;
-            case WieldType::ONE_HAND_PLUS_EXTRA: case WieldType::ONE_HAND_PLUS_SHIELD: case WieldType::SINGLE_WIELD: weapon_skill = "ONE_HANDED"; break;
-            case WieldType::TWO_HAND: case WieldType::HAND_AND_A_HALF_2H: weapon_skill = "TWO_HANDED"; break;
+            case WieldType::NONE: case WieldType::SHIELD_ONLY: case WieldType::UNARMED: case WieldType::UNARMED_PLUS_SHIELD: weapon_skill = SKILL_UNARMED; break;
+            case WieldType::DUAL_WIELD: weapon_skill = SKILL_DUAL_WIELD; break;
+            case WieldType::ONE_HAND_PLUS_EXTRA: case WieldType::ONE_HAND_PLUS_SHIELD: case WieldType::SINGLE_WIELD: weapon_skill = SKILL_ONE_HANDED; break;
+            case WieldType::TWO_HAND: case WieldType::HAND_AND_A_HALF_2H: weapon_skill = SKILL_TWO_HANDED; break;
         }
-        if (weapon_ptr->subtype() == ItemSub::RANGED) weapon_skill = "ARCHERY";
+        if (weapon_ptr->subtype() == ItemSub::RANGED) weapon_skill = SKILL_ARCHERY;
     }
 
     // Roll to hit!
@@ -369,7 +374,7 @@ void Combat::perform_attack(std::shared_ptr<Mobile> attacker, std::shared_ptr<Mo
         defender->set_tag(MobileTag::Success_QuickRoll);
     }
     if (attacker_is_player) to_hit += (WEAPON_SKILL_TO_HIT_PER_LEVEL * player->skill_level(weapon_skill));
-    else if (defender_is_player) to_hit -= (EVASION_SKILL_BONUS_PER_LEVEL * player->skill_level("EVASION"));
+    else if (defender_is_player) to_hit -= (EVASION_SKILL_BONUS_PER_LEVEL * player->skill_level(SKILL_EVASION));
     to_hit *= hit_multiplier;
 
     // Check if the defender can attempt to block or parry.
@@ -406,7 +411,7 @@ void Combat::perform_attack(std::shared_ptr<Mobile> attacker, std::shared_ptr<Mo
         {
             float parry_chance = BASE_PARRY_CHANCE;
             if (wield_type_attacker == WieldType::TWO_HAND || wield_type_attacker == WieldType::HAND_AND_A_HALF_2H) parry_chance *= PARRY_PENALTY_TWO_HANDED;
-            if (defender_is_player) parry_chance += (PARRY_SKILL_BONUS_PER_LEVEL * player->skill_level("PARRY"));
+            if (defender_is_player) parry_chance += (PARRY_SKILL_BONUS_PER_LEVEL * player->skill_level(SKILL_PARRY));
             parry_chance *= defender->parry_mod();
             if (defender->tag(MobileTag::Agile) || attacker->tag(MobileTag::Clumsy)) parry_chance *= DEFENDER_PARRY_MODIFIER_AGILE;
             else if (defender->tag(MobileTag::Clumsy) || attacker->tag(MobileTag::Agile)) parry_chance *= DEFENDER_PARRY_MODIFIER_CLUMSY;
@@ -417,7 +422,7 @@ void Combat::perform_attack(std::shared_ptr<Mobile> attacker, std::shared_ptr<Mo
         if (!parried && can_block)
         {
             float block_chance = BASE_BLOCK_CHANCE_MELEE;
-            if (defender_is_player) block_chance += (BLOCK_SKILL_BONUS_PER_LEVEL * player->skill_level("BLOCK"));
+            if (defender_is_player) block_chance += (BLOCK_SKILL_BONUS_PER_LEVEL * player->skill_level(SKILL_BLOCK));
             if (defender->has_buff(Buff::Type::SHIELD_WALL))
             {
                 block_chance += defender->buff_power(Buff::Type::SHIELD_WALL);
@@ -443,13 +448,13 @@ void Combat::perform_attack(std::shared_ptr<Mobile> attacker, std::shared_ptr<Mo
                 if (defender_is_player) core()->message("{G}You parry the " + attacker_your_string + " " + weapon_name + "!");
                 else core()->message((attacker_is_player ? "{Y}" : "{U}") + attacker_your_string_c + " " + weapon_name + " is parried by " + defender_name + ".");
             }
-            if (defender_is_player) player->gain_skill_xp("PARRY", XP_PER_PARRY);
+            if (defender_is_player) player->gain_skill_xp(SKILL_PARRY, XP_PER_PARRY);
         }
         else
         {
             if (player_can_see_attacker || player_can_see_defender)
                 core()->message((attacker_is_player ? "{Y}" : (defender_is_player ? "{U}" : "{U}")) + attacker_your_string_c + " " + weapon_name + " misses " + defender_name + ".");
-            if (defender_is_player) player->gain_skill_xp("EVASION", XP_PER_EVADE);
+            if (defender_is_player) player->gain_skill_xp(SKILL_EVASION, XP_PER_EVADE);
         }
     }
     else
@@ -607,7 +612,7 @@ void Combat::perform_attack(std::shared_ptr<Mobile> attacker, std::shared_ptr<Mo
         if (poison) weapon_poison_effect(defender, damage);
         defender->reduce_hp(damage, false);
         if (attacker_is_player) player->gain_skill_xp(weapon_skill, (critical_hit ? XP_PER_CRITICAL_HIT : XP_PER_SUCCESSFUL_HIT));
-        else if (defender_is_player && blocked) player->gain_skill_xp("BLOCK", XP_PER_BLOCK);
+        else if (defender_is_player && blocked) player->gain_skill_xp(SKILL_BLOCK, XP_PER_BLOCK);
     }
 
     // Remove ammo if we're using a ranged weapon.
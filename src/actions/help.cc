@@ -4,6 +4,7 @@
 #include "3rdparty/yaml-cpp/yaml.h"
 #include "actions/help.h"
 #include "core/core.h"
+#include "core/data-cache.h"
 #include "core/strx.h"
 
 
@@ -30,6 +31,23 @@ void ActionHelp::help(std::string topic)
 // Loads the help pages from data/misc/help.yml
 void ActionHelp::load_pages()
 {
+    DataCache cache("help", { "data/misc/help.yml" });
+    if (cache.loaded())
+    {
+        try
+        {
+            help_pages_ = cache.read_map();
+            cache.finish_read();
+            return;
+        }
+        catch (std::exception &e)
+        {
+            core()->guru()->log("Could not read the data cache, so it will be rebuilt: " + std::string(e.what()), Guru::GURU_WARN);
+            help_pages_.clear();
+            cache.reset();
+        }
+    }
+
     try
     {
         const YAML::Node help_pages = YAML::LoadFile("data/misc/help.yml");
@@ -47,6 +65,8 @@ void ActionHelp::load_pages()
             else help_text = help_entry.second.as<std::string>();
             help_pages_.insert(std::make_pair(help_word, help_text));
         }
+        cache.write_map(help_pages_);
+        cache.save();
     }
     catch (std::exception &e)
     {
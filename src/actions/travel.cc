@@ -9,6 +9,7 @@
 #include "core/core.h"
 #include "core/mathx.h"
 #include "core/strx.h"
+#include "core/symbols.h"
 
 #include <cmath>
 
@@ -163,7 +164,8 @@ bool ActionTravel::travel(std::shared_ptr<Mobile> mob, Direction dir, bool confi
             fallen_dist = 1;
         }
         float damage_perc = static_cast<float>(min_perc + core()->rng()->rnd(rng_perc)) / 100.0f;
-        const int safe_fall = (is_player ? player->skill_level("SAFE_FALL") : 0);
+        static const uint32_t SKILL_SAFE_FALL = Symbols::intern("SAFE_FALL");
+        const int safe_fall = (is_player ? player->skill_level(SKILL_SAFE_FALL) : 0);
         if (safe_fall > 0) damage_perc -= (static_cast<float>(core()->rng()->rnd(safe_fall)) / 100.0f);
 
         if (damage_perc > 0)
@@ -173,7 +175,7 @@ bool ActionTravel::travel(std::shared_ptr<Mobile> mob, Direction dir, bool confi
             if (is_player)
             {
                 core()->message("{R}You land badly, and the impact " + Combat::damage_str(hp_damage, mob, false) + " {R}you! {W}<{R}-" + StrX::intostr_pretty(hp_damage) + "{W}>");
-                if (mob->hp() > 0) player->gain_skill_xp("SAFE_FALL", XP_PER_SAFE_FALL_FAIL * fallen_dist);
+                if (mob->hp() > 0) player->gain_skill_xp(SKILL_SAFE_FALL, XP_PER_SAFE_FALL_FAIL * fallen_dist);
             }
             else
             {
@@ -201,7 +203,7 @@ bool ActionTravel::travel(std::shared_ptr<Mobile> mob, Direction dir, bool confi
         else if (is_player)
         {
             core()->message("{g}Despite the distance fallen, you manage to land safely on your feet.");
-            player->gain_skill_xp("SAFE_FALL", XP_PER_SAFE_FALL_SUCCESS * fallen_dist);
+            player->gain_skill_xp(SKILL_SAFE_FALL, XP_PER_SAFE_FALL_SUCCESS * fallen_dist);
         }
     }
 
@@ -0,0 +1,420 @@
+// core/bench.cc -- Headless benchmark driver, which plays through a scripted sequence of commands and reports how long each phase took.
+// Copyright (c) 2021 Raine "Gravecat" Simmons. Licensed under the GNU Affero General Public License v3 or any later version.
+
+#include "3rdparty/SQLiteCpp/SQLiteCpp.h"
+#include "core/bench.h"
+#include "core/core.h"
+#include "core/filex.h"
+#include "core/save-manifest.h"
+#include "core/snapshot.h"
+#include "core/strx.h"
+#include "world/room.h"
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#ifdef GREAVE_TARGET_LINUX
+#include <sys/resource.h>
+#endif
+
+
+const char Bench::ATTACK_MOB_ID[] =     "GIANT_RAT";    // The Mobile to spawn and fight in the attack phase.
+const char Bench::ATTACK_MOB_NAME[] =   "rat";          // The name used to target the spawned Mobile.
+const char Bench::SCALE_CONTAINER_ID[] = "CORPSE";      // The Item used for containers in the synthetic world.
+const char Bench::WILDLIFE_MOB_ID[] =   "FALLOW_DEER";  // The peaceful Mobile to spawn for the wildlife phase.
+
+// The Items scattered around the synthetic world. None of these can stack, so each one stays a separate Item.
+const std::vector<std::string> Bench::SCALE_ITEM_IDS = { "CAP_LEATHER", "COIF_MAIL", "DAGGER", "DIRK", "GREATSWORD", "KATANA", "STILETTO" };
+
+// The Mobiles scattered around the synthetic world.
+const std::vector<std::string> Bench::SCALE_MOB_IDS = { "FALLOW_DEER", "FOREST_BADGER", "GIANT_RAT", "GIANT_SPIDER" };
+
+
+// Runs a single command through the parser, as the main game loop would.
+void Bench::command(const std::string &input)
+{
+    core()->world()->main_loop_events_pre_input();
+    core()->journal()->append(input);
+    core()->parser()->parse(input);
+    core()->world()->main_loop_events_post_input();
+    if (core()->world()->player()->is_dead()) throw std::runtime_error("The player died during the benchmark, on command: " + input);
+}
+
+// Deletes the benchmark's saved game files, and their save manifest entry.
+void Bench::delete_saves()
+{
+    core()->save_wait();    // The save thread might otherwise write the files, or the manifest entry, again afterwards.
+    for (int i = 0; i < 2; i++)
+    {
+        const std::string filename = core()->save_filename(SAVE_SLOT, i);
+        if (FileX::file_exists(filename)) FileX::delete_file(filename);
+    }
+    if (FileX::file_exists(Snapshot::filename(SAVE_SLOT))) FileX::delete_file(Snapshot::filename(SAVE_SLOT));
+    core()->journal()->discard();
+    SaveManifest::remove(SAVE_SLOT);
+}
+
+// Spawns a Mobile followed by some peaceful ones, then fights it to the death, so that it's removed from the middle of the Mobiles.
+void Bench::journal_fight()
+{
+    const auto world = core()->world();
+    command("#spawnmob " + std::string(ATTACK_MOB_ID));
+    const uint32_t target_id = world->mob_vec(world->mob_count() - 1)->id();
+    for (uint32_t i = 0; i < JOURNAL_MOBS; i++)
+        command("#spawnmob " + std::string(WILDLIFE_MOB_ID));
+    for (uint32_t i = 0; i < ATTACK_MAX_ROUNDS; i++)
+    {
+        bool target_alive = false;
+        for (size_t j = 0; j < world->mob_count() && !target_alive; j++)
+            if (world->mob_vec(j)->id() == target_id) target_alive = true;
+        if (!target_alive) break;
+        command("attack " + std::string(ATTACK_MOB_NAME));
+    }
+}
+
+// Prints a line of the benchmark results, and writes it to the log.
+void Bench::output(const std::string &str)
+{
+    std::cout << str << std::endl;
+    core()->guru()->log("[BENCH] " + str);
+}
+
+// Returns the peak memory use of the process in kilobytes, or 0 if it can't be determined on this platform.
+uint64_t Bench::peak_memory()
+{
+#ifdef GREAVE_TARGET_LINUX
+    struct rusage usage;
+    if (!getrusage(RUSAGE_SELF, &usage)) return usage.ru_maxrss;
+#endif
+    return 0;
+}
+
+// Reports the time taken for a benchmark phase.
+void Bench::report(const std::string &phase, uint32_t iterations, std::chrono::steady_clock::time_point start)
+{
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::stringstream ss;
+    ss << std::left << std::setw(10) << phase << std::right << std::fixed << std::setprecision(2) << std::setw(12) << ms << " ms";
+    if (iterations) ss << std::setw(8) << iterations << " iterations" << std::setw(12) << ms * 1000.0 / iterations << " us/iteration";
+    output(ss.str());
+}
+
+// Runs the full benchmark, then reports the results.
+void Bench::run()
+{
+    const auto bench_start = std::chrono::steady_clock::now();
+    core()->rng()->set_prand_seed(SEED);
+
+    // Starting a new game includes loading all the static game data, which means parsing the YAML files unless the data cache is current.
+    auto start = std::chrono::steady_clock::now();
+    core()->start_game(SAVE_SLOT, false);
+    report("new game", 1, start);
+
+    run_commands("look", { "look" }, LOOK_REPEATS);
+    run_commands("travel", { "north", "south" }, TRAVEL_REPEATS);
+
+    // The main game loop takes a rewind snapshot after every command. That's timed separately here, then everything is rewound in one go.
+    start = std::chrono::steady_clock::now();
+    core()->rewind_record("");
+    for (uint32_t i = 0; i < REWIND_REPEATS; i++)
+    {
+        const std::string input = (i % 2 ? "south" : "north");
+        command(input);
+        core()->rewind_record(input);
+    }
+    report("snapshot", REWIND_REPEATS, start);
+    start = std::chrono::steady_clock::now();
+    command("rewind " + std::to_string(REWIND_REPEATS));
+    report("rewind", 1, start);
+
+    // Spawn some Mobiles and fight them to the death. Attacks continue until the spawned Mobile is gone from the room.
+    start = std::chrono::steady_clock::now();
+    uint32_t attacks = 0;
+    const auto world = core()->world();
+    for (uint32_t i = 0; i < ATTACK_MOBS; i++)
+    {
+        const size_t mobs_before = world->mobs_in_room(world->player()->location()).size();
+        command("#spawnmob " + std::string(ATTACK_MOB_ID));
+        for (uint32_t j = 0; j < ATTACK_MAX_ROUNDS && world->mobs_in_room(world->player()->location()).size() > mobs_before; j++)
+        {
+            command("attack " + std::string(ATTACK_MOB_NAME));
+            attacks++;
+        }
+    }
+    report("attack", attacks, start);
+    const bool journal_match = run_journal();
+
+    run_commands("rest", { "rest 24 hours" }, REST_REPEATS);
+
+    // Resting again with peaceful Mobiles wandering around nearby, which have to be ticked while time passes.
+    for (uint32_t i = 0; i < WILDLIFE_MOBS; i++)
+        command("#spawnmob " + std::string(WILDLIFE_MOB_ID));
+    run_commands("wildlife", { "rest 24 hours" }, WILDLIFE_REPEATS);
+    run_commands("save", { "save" }, SAVE_REPEATS);
+    run_commands("quicksave", { "quicksave" }, SAVE_REPEATS);
+    core()->save_wait();    // Saved games are written in the background; don't let the last write count towards loading.
+    run_commands("quickload", { "quickload" }, LOAD_REPEATS);
+    core()->save_wait();
+
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < LOAD_REPEATS; i++)
+        core()->start_game(SAVE_SLOT, true);
+    report("load", LOAD_REPEATS, start);
+
+    report("total", 0, bench_start);
+    delete_saves();
+    if (!journal_match) throw std::runtime_error("Replaying the benchmark's journal did not end in the same game as playing it.");
+}
+
+// Runs a list of commands a number of times, and reports the time taken.
+void Bench::run_commands(const std::string &phase, const std::vector<std::string> &commands, uint32_t repeats)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < repeats; i++)
+        for (auto cmd : commands)
+            command(cmd);
+    report(phase, repeats * commands.size(), start);
+}
+
+// Plays on from a save while recording the journal, then replays the journal over that save. Returns true if both games end up saving exactly the same tables.
+bool Bench::run_journal()
+{
+    if (!core()->prefs()->journal_size)
+    {
+        output("journal       skipped, as the journal is disabled in prefs.yml");
+        return true;
+    }
+
+    // Mobiles are removed both before the save and while the journal is recorded, as either can leave the Mobiles in a different order from a freshly-loaded game.
+    const auto start = std::chrono::steady_clock::now();
+    journal_fight();
+    core()->save();
+    core()->save_wait();
+    journal_fight();
+    command("rest 1 hour");
+    command("north");
+    command("south");
+    const uint32_t commands = static_cast<uint32_t>(core()->journal()->size());
+
+    // The game as played is saved in full, with the saved game moved aside and the journal kept in memory, as saving replaces the journal.
+    const std::string save_fn = core()->save_filename(SAVE_SLOT);
+    const std::string journal_fn = Journal::filename(SAVE_SLOT);
+    std::vector<std::string> journal_lines;
+    std::ifstream journal_in(journal_fn);
+    std::string line;
+    while (std::getline(journal_in, line))
+        journal_lines.push_back(line);
+    journal_in.close();
+    FileX::rename_file(save_fn, save_fn + ".bench");
+    core()->set_world(core()->world());
+    core()->save();
+    core()->save_wait();
+    auto played_tables = table_checksums(save_fn);
+
+    // Then the saved game and its journal are put back, and loading the saved game replays the journal.
+    core()->journal()->discard();
+    FileX::delete_file(save_fn);
+    FileX::rename_file(save_fn + ".bench", save_fn);
+    std::ofstream journal_out(journal_fn);
+    for (auto journal_line : journal_lines)
+        journal_out << journal_line << "\n";
+    journal_out.close();
+    core()->start_game(SAVE_SLOT, true);
+    core()->set_world(core()->world());
+    core()->save();
+    core()->save_wait();
+    report("journal", commands, start);
+
+    // The message log is left out, as replaying the journal echoes each command, and reports how many were recovered.
+    auto replayed_tables = table_checksums(save_fn);
+    played_tables.erase("msglog_blocks");
+    replayed_tables.erase("msglog_blocks");
+    const bool match = (replayed_tables == played_tables);
+    output(std::string("journal       ") + (match ? "replay OK" : "replay MISMATCH"));
+    return match;
+}
+
+// Builds a synthetic world, optionally sized by a "rooms,mobiles,items" string, then times saving and loading it.
+void Bench::run_scale(const std::string &sizes)
+{
+    uint32_t rooms = SCALE_ROOMS, mobs = SCALE_MOBS, items = SCALE_ITEMS;
+    if (sizes.size())
+    {
+        const std::vector<std::string> size_vec = StrX::string_explode(sizes, ",");
+        if (size_vec.size() != 3 || !StrX::is_number(size_vec.at(0)) || !StrX::is_number(size_vec.at(1)) || !StrX::is_number(size_vec.at(2)))
+            throw std::runtime_error("Invalid scaling benchmark size, expected rooms,mobiles,items: " + sizes);
+        rooms = std::stoul(size_vec.at(0));
+        mobs = std::stoul(size_vec.at(1));
+        items = std::stoul(size_vec.at(2));
+    }
+    if (!rooms) throw std::runtime_error("The scaling benchmark needs at least one room.");
+    output("Scaling benchmark: " + std::to_string(rooms) + " rooms, " + std::to_string(mobs) + " mobiles, " + std::to_string(items) + " items");
+
+    const auto bench_start = std::chrono::steady_clock::now();
+    core()->rng()->set_prand_seed(SEED);
+    auto start = std::chrono::steady_clock::now();
+    core()->start_game(SAVE_SLOT, false);
+    report("new game", 1, start);
+
+    // Every synthetic Room gets a scar, so that it has to be saved. Mobiles and Items are spread evenly across the Rooms.
+    start = std::chrono::steady_clock::now();
+    const auto world = core()->world();
+    scale_rooms(world, rooms);
+    for (uint32_t i = 0; i < rooms; i++)
+        world->get_room("SCALE_ROOM_" + std::to_string(i))->add_scar(static_cast<Room::ScarType>(i % 4), 5);
+    for (uint32_t i = 0; i < mobs; i++)
+    {
+        const auto mob = world->get_mob(SCALE_MOB_IDS.at(i % SCALE_MOB_IDS.size()));
+        mob->set_location("SCALE_ROOM_" + std::to_string(i % rooms));
+        world->add_mobile(mob);
+    }
+
+    // Each container is either left in a Room, or nested inside the previous container, up to the maximum depth. The Items in between go into the most recent container.
+    std::shared_ptr<Item> container = nullptr;
+    for (uint32_t i = 0; i < items; i++)
+    {
+        if (i % SCALE_CONTAINER_EVERY)
+        {
+            const auto item = world->get_item(SCALE_ITEM_IDS.at(i % SCALE_ITEM_IDS.size()));
+            if (container) container->inv()->add_item(item);
+            else world->get_room("SCALE_ROOM_" + std::to_string(i % rooms))->inv()->add_item(item);
+            continue;
+        }
+        const uint32_t container_count = i / SCALE_CONTAINER_EVERY;
+        const auto new_container = world->get_item(SCALE_CONTAINER_ID);
+        new_container->new_inventory();
+        if (container && container_count % SCALE_CONTAINER_DEPTH) container->inv()->add_item(new_container);
+        else world->get_room("SCALE_ROOM_" + std::to_string(container_count % rooms))->inv()->add_item(new_container);
+        container = new_container;
+    }
+    report("generate", rooms + mobs + items, start);
+
+    // The save is timed in two parts: building the save in memory on the main thread, then writing it to disk in the background.
+    start = std::chrono::steady_clock::now();
+    core()->save();
+    report("snapshot", 1, start);
+    start = std::chrono::steady_clock::now();
+    core()->save_wait();
+    report("write", 1, start);
+    const std::string save_fn = core()->save_filename(SAVE_SLOT);
+    const auto saved_tables = table_checksums(save_fn);
+    uint64_t total_rows = 0;
+    for (auto table : saved_tables)
+        total_rows += table.second.first;
+    output("file size " + StrX::intostr_pretty(FileX::file_size(save_fn) / 1024) + " KB, " + StrX::intostr_pretty(total_rows) + " rows");
+
+    // Quicksaving also updates the in-memory save, so the save file is converted separately to check the snapshot format. Converted back again, it should hold exactly the same tables.
+    start = std::chrono::steady_clock::now();
+    core()->quicksave();
+    core()->save_wait();
+    report("quicksave", 1, start);
+    const std::string quick_fn = Snapshot::filename(SAVE_SLOT);
+    start = std::chrono::steady_clock::now();
+    {
+        SQLite::Database save_db(save_fn, SQLite::OPEN_READONLY);
+        Snapshot::from_sqlite(save_db, quick_fn);
+    }
+    report("to snapshot", total_rows, start);
+    output("snapshot size " + StrX::intostr_pretty(FileX::file_size(quick_fn) / 1024) + " KB");
+    start = std::chrono::steady_clock::now();
+    bool snapshot_match;
+    {
+        const auto snapshot_db = Snapshot::to_sqlite(quick_fn);
+        report("to sqlite", total_rows, start);
+        snapshot_match = (table_checksums(*snapshot_db) == saved_tables);
+    }
+    output(std::string("snapshot      ") + (snapshot_match ? "round-trip OK" : "round-trip MISMATCH"));
+
+    // The loaded World needs the same synthetic Rooms, as Rooms missing from the area data are skipped when loading.
+    start = std::chrono::steady_clock::now();
+    auto loaded_world = std::make_shared<World>();
+    scale_rooms(loaded_world, rooms);
+    report("new world", 1, start);
+    start = std::chrono::steady_clock::now();
+    {
+        std::shared_ptr<SQLite::Database> save_db = std::make_shared<SQLite::Database>(save_fn, SQLite::OPEN_READONLY);
+        loaded_world->load(save_db);
+    }
+    report("load", total_rows, start);
+
+    // Save the loaded World again from scratch. Saves are deterministic, so every table should come out exactly the same as before.
+    core()->set_world(loaded_world);
+    start = std::chrono::steady_clock::now();
+    core()->save();
+    core()->save_wait();
+    report("resave", 1, start);
+    const auto resaved_tables = table_checksums(save_fn);
+
+    // Change a single Room and save again. Only the rows written since the last save are copied to the file this time, rather than the whole database.
+    loaded_world->get_room("SCALE_ROOM_0")->add_scar(Room::ScarType::BLOOD, 5);
+    start = std::chrono::steady_clock::now();
+    core()->save();
+    core()->save_wait();
+    report("update", 1, start);
+
+    bool all_match = (snapshot_match && saved_tables.size() == resaved_tables.size());
+    for (auto table : saved_tables)
+    {
+        const auto resaved = resaved_tables.find(table.first);
+        const bool match = (resaved != resaved_tables.end() && resaved->second == table.second);
+        if (!match) all_match = false;
+        std::stringstream ss;
+        ss << std::left << std::setw(14) << table.first << std::right << std::setw(10) << table.second.first << " rows    " << (match ? "round-trip OK" : "round-trip MISMATCH");
+        output(ss.str());
+    }
+
+    const uint64_t peak_kb = peak_memory();
+    if (peak_kb) output("peak memory " + StrX::intostr_pretty(peak_kb / 1024) + " MB");
+    report("total", 0, bench_start);
+    delete_saves();
+    if (!all_match) throw std::runtime_error("The scaling benchmark's saved game did not survive a round trip.");
+}
+
+// Adds the synthetic world's Rooms to a World.
+void Bench::scale_rooms(std::shared_ptr<World> world, uint32_t rooms)
+{
+    for (uint32_t i = 0; i < rooms; i++)
+    {
+        const std::string room_id = "SCALE_ROOM_" + std::to_string(i);
+        auto room = std::make_shared<Room>(room_id);
+        room->set_name("Synthetic Room " + std::to_string(i), "synthetic room");
+        world->add_room(room);
+    }
+}
+
+// Counts the rows in each table of a saved game file, and hashes their contents.
+std::map<std::string, std::pair<uint64_t, uint32_t>> Bench::table_checksums(const std::string &filename)
+{
+    SQLite::Database save_db(filename, SQLite::OPEN_READONLY);
+    return table_checksums(save_db);
+}
+
+// As above, but for a saved game database that's already open.
+std::map<std::string, std::pair<uint64_t, uint32_t>> Bench::table_checksums(SQLite::Database &save_db)
+{
+    std::map<std::string, std::pair<uint64_t, uint32_t>> tables;
+    SQLite::Statement table_query(save_db, "SELECT name FROM sqlite_master WHERE type = 'table'");
+    while (table_query.executeStep())
+    {
+        const std::string table = table_query.getColumn(0).getString();
+        uint64_t rows = 0;
+        uint32_t checksum = 0;
+        SQLite::Statement row_query(save_db, "SELECT * FROM " + table);
+        while (row_query.executeStep())
+        {
+            std::string row;
+            for (int i = 0; i < row_query.getColumnCount(); i++)
+            {
+                const SQLite::Column column = row_query.getColumn(i);
+                if (column.isNull()) row += "\x1E";
+                else row += column.getString() + "\x1F";
+            }
+            checksum = (checksum * 16777619) ^ StrX::hash(row);
+            rows++;
+        }
+        tables.insert(std::make_pair(table, std::make_pair(rows, checksum)));
+    }
+    return tables;
+}
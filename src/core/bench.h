@@ -0,0 +1,62 @@
+// core/bench.h -- Headless benchmark driver, which plays through a scripted sequence of commands and reports how long each phase took.
+// Copyright (c) 2021 Raine "Gravecat" Simmons. Licensed under the GNU Affero General Public License v3 or any later version.
+
+#ifndef GREAVE_CORE_BENCH_H_
+#define GREAVE_CORE_BENCH_H_
+
+#include "world/world.h"
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+class Bench
+{
+public:
+    static void run();  // Runs the full benchmark, then reports the results.
+    static void run_scale(const std::string &sizes);    // Builds a synthetic world, optionally sized by a "rooms,mobiles,items" string, then times saving and loading it.
+
+private:
+    static constexpr uint32_t   ATTACK_MAX_ROUNDS = 100;    // The maximum amount of attacks to make on each spawned Mobile, in case the fight goes nowhere.
+    static constexpr uint32_t   ATTACK_MOBS =       5;      // How many Mobiles to spawn and fight in the attack phase.
+    static constexpr uint32_t   JOURNAL_MOBS =      3;      // How many peaceful Mobiles to spawn after each one fought in the journal phase, so that it's killed from the middle of the Mobiles.
+    static constexpr uint32_t   LOAD_REPEATS =      5;      // How many times to load the saved game.
+    static constexpr uint32_t   LOOK_REPEATS =      500;    // How many times to look around the room.
+    static constexpr uint32_t   REST_REPEATS =      7;      // How many times to rest for 24 hours.
+    static constexpr uint32_t   REWIND_REPEATS =    20;     // How many commands to take rewind snapshots of, before rewinding them all.
+    static constexpr uint32_t   SCALE_CONTAINER_DEPTH = 3;  // How deeply the synthetic world's containers are nested inside each other.
+    static constexpr uint32_t   SCALE_CONTAINER_EVERY = 10; // One in this many of the synthetic world's Items is a container, holding the Items generated after it.
+    static constexpr uint32_t   SCALE_ITEMS =       100000; // The default number of Items in the synthetic world.
+    static constexpr uint32_t   SCALE_MOBS =        5000;   // The default number of Mobiles in the synthetic world.
+    static constexpr uint32_t   SCALE_ROOMS =       10000;  // The default number of extra Rooms in the synthetic world.
+    static constexpr int        SAVE_SLOT =         0;      // The save slot used by the benchmark. Slot 0 never appears on the title screen.
+    static constexpr uint32_t   SAVE_REPEATS =      5;      // How many times to save the game.
+    static constexpr uint32_t   SEED =              12345;  // The fixed RNG seed, so each run plays out the same way.
+    static constexpr uint32_t   TRAVEL_REPEATS =    100;    // How many times to walk back and forth between two rooms.
+    static constexpr uint32_t   WILDLIFE_MOBS =     10;     // How many peaceful Mobiles to spawn for the wildlife phase.
+    static constexpr uint32_t   WILDLIFE_REPEATS =  2;      // How many times to rest for 24 hours in the wildlife phase. Any more, and the player dies of thirst.
+    static const char           ATTACK_MOB_ID[];            // The Mobile to spawn and fight in the attack phase.
+    static const char           ATTACK_MOB_NAME[];          // The name used to target the spawned Mobile.
+    static const char           SCALE_CONTAINER_ID[];       // The Item used for containers in the synthetic world.
+    static const char           WILDLIFE_MOB_ID[];          // The peaceful Mobile to spawn for the wildlife phase.
+    static const std::vector<std::string>   SCALE_ITEM_IDS; // The Items scattered around the synthetic world.
+    static const std::vector<std::string>   SCALE_MOB_IDS;  // The Mobiles scattered around the synthetic world.
+
+    static void command(const std::string &input);  // Runs a single command through the parser, as the main game loop would.
+    static void delete_saves();                     // Deletes the benchmark's saved game files, and their save manifest entry.
+    static void journal_fight();                    // Spawns a Mobile followed by some peaceful ones, then fights it to the death, so that it's removed from the middle of the Mobiles.
+    static void output(const std::string &str);     // Prints a line of the benchmark results, and writes it to the log.
+    static uint64_t peak_memory();                  // Returns the peak memory use of the process in kilobytes, or 0 if it can't be determined on this platform.
+    static void report(const std::string &phase, uint32_t iterations, std::chrono::steady_clock::time_point start); // Reports the time taken for a benchmark phase.
+    static void run_commands(const std::string &phase, const std::vector<std::string> &commands, uint32_t repeats);  // Runs a list of commands a number of times, and reports the time taken.
+    static bool run_journal();                      // Plays on from a save while recording the journal, then replays the journal over that save. Returns true if both games end up saving exactly the same tables.
+    static void scale_rooms(std::shared_ptr<World> world, uint32_t rooms);  // Adds the synthetic world's Rooms to a World.
+    static std::map<std::string, std::pair<uint64_t, uint32_t>> table_checksums(const std::string &filename);  // Counts the rows in each table of a saved game file, and hashes their contents.
+    static std::map<std::string, std::pair<uint64_t, uint32_t>> table_checksums(SQLite::Database &save_db);    // As above, but for a saved game database that's already open.
+};
+
+#endif  // GREAVE_CORE_BENCH_H_
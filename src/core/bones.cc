@@ -16,6 +16,9 @@ constexpr char Bones::BONES_FILENAME[] = "userdata/bones.sqlite";
 // SQL table construction string.
 constexpr char Bones::SQL_BONES[] = "CREATE TABLE highscores ( death_reason TEXT NOT NULL, id INTEGER PRIMARY KEY UNIQUE NOT NULL, name TEXT NOT NULL, score INTEGER NOT NULL )";
 
+// The Hall of Legends is permanent, with no .old copy to fall back on, so the bones file is always written with a synced rollback journal, whatever save_profile is set to.
+constexpr char Bones::SQL_DURABLE[] = "PRAGMA journal_mode = DELETE; PRAGMA synchronous = FULL";
+
 
 // Checks the version of the bones file, 0 if the file doesn't exist or version cannot be determined.
 uint32_t Bones::bones_version()
@@ -89,6 +92,7 @@ void Bones::init_bones()
     // Create a new, clean bones file.
     core()->guru()->log("Creating fresh bones file.");
     SQLite::Database bones_db(BONES_FILENAME, SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
+    bones_db.exec(SQL_DURABLE);
     bones_db.exec("PRAGMA user_version = " + std::to_string(BONES_VERSION));
     bones_db.exec(SQL_BONES);
 }
@@ -103,6 +107,7 @@ bool Bones::record_death()
         try
         {
             SQLite::Database bones_db(BONES_FILENAME, SQLite::OPEN_READWRITE);
+            bones_db.exec(SQL_DURABLE);
 
             // First, check if this player ID is already present on the scoreboard.
             SQLite::Statement duplicate_query(bones_db, "SELECT id FROM highscores WHERE id = :id");
@@ -20,6 +20,7 @@ private:
     static constexpr int        MAX_HIGHSCORES =    10; // The maximum amount of highscores to store.
     static const char           BONES_FILENAME[];       // The filename for the bones file.
     static const char           SQL_BONES[];            // SQL table construction string.
+    static const char           SQL_DURABLE[];          // The journal and sync settings for the bones file, which are always durable.
 
     static uint32_t bones_version();    // Checks the version of the bones file, 0 if the file doesn't exist or version cannot be determined.
 };
@@ -1,17 +1,23 @@
 // core/core.cc -- Main program entry, initialization and cleanup routines, and the core game loop.
 // Copyright (c) 2020-2021 Raine "Gravecat" Simmons. Licensed under the GNU Affero General Public License v3 or any later version.
 
+#include "3rdparty/SQLiteCpp/Backup.h"
 #include "3rdparty/SQLiteCpp/SQLiteCpp.h"
+#include "3rdparty/sqlite3/sqlite3.h"
 #ifdef GREAVE_TOLK
 #include "3rdparty/Tolk/Tolk.h"
 #endif
 #include "actions/help.h"
+#include "core/bench.h"
 #include "core/core.h"
 #include "core/core-constants.h"
 #include "core/bones.h"
 #include "core/filex.h"
+#include "core/save-manifest.h"
+#include "core/snapshot.h"
 #include "core/strx.h"
 #include "core/terminal-curses.h"
+#include "core/terminal-headless.h"
 #include "core/terminal-sdl2.h"
 
 #ifdef GREAVE_TOLK
@@ -31,19 +37,32 @@ int main(int argc, char* argv[])
 {
     // Check command-line parameters.
     std::vector<std::string> parameters(argv, argv + argc);
-    bool dry_run = false;
+    bool dry_run = false, bench = false, bench_scale = false;
+    std::string bench_scale_sizes, convert_save;
     if (parameters.size() >= 2)
         for (auto param : parameters)
+        {
             if (!param.compare("-dry-run")) dry_run = true;
+            else if (!param.compare("-bench")) bench = true;
+            else if (!param.compare(0, 12, "-bench-scale"))
+            {
+                bench = bench_scale = true;
+                if (param.size() > 13 && param[12] == '=') bench_scale_sizes = param.substr(13);
+            }
+            else if (!param.compare(0, 14, "-convert-save=")) convert_save = param.substr(14);
+        }
 
     greave = std::make_shared<Core>();
     try
     {
-        greave->init(dry_run);
+        greave->init(dry_run, bench || convert_save.size());
         if (dry_run)
         {
             auto new_world =std::make_shared<World>();
         }
+        else if (convert_save.size()) Snapshot::convert(convert_save);
+        else if (bench_scale) Bench::run_scale(bench_scale_sizes);
+        else if (bench) Bench::run();
         else
         {
             greave->title();
@@ -60,11 +79,16 @@ int main(int argc, char* argv[])
 }
 
 // Constructor, doesn't do too much aside from setting default values for member variables. Use init() to set things up.
-Core::Core() : message_log_(nullptr), parser_(nullptr), rng_(nullptr), save_slot_(0), sql_unique_id_(0), terminal_(nullptr), prefs_(nullptr), world_(nullptr) { }
+Core::Core() : journal_(nullptr), message_log_(nullptr), parser_(nullptr), rewind_(nullptr), rewind_in_place_(false), rng_(nullptr), save_backed_up_(false), save_db_busy_(false), save_in_place_(false), save_slot_(0), save_synced_(false), sql_unique_id_(0), terminal_(nullptr), prefs_(nullptr), world_(nullptr) { }
 
 // Cleans up after we're d one.
 void Core::cleanup()
 {
+    // Make sure any saved game still being written in the background has finished.
+    save_wait();
+    sql_statements_clear();
+    save_db_.reset();
+
     // Tell Guru to revert to exit() if an error happens at this point.
     guru()->console_ready(false);
 
@@ -84,7 +108,7 @@ const std::shared_ptr<Guru> Core::guru() const
 }
 
 // Sets up the core game classes and data.
-void Core::init(bool dry_run)
+void Core::init(bool dry_run, bool headless)
 {
     FileX::make_dir("userdata");
     FileX::make_dir("userdata/save");
@@ -124,6 +148,9 @@ void Core::init(bool dry_run)
         terminal_choice = "sdl2";
 #endif
 
+        // Headless mode ignores the user's choice of terminal entirely, as nothing will be rendered.
+        if (headless) terminal_choice = "headless";
+
         // Set up our terminal emulator.
 #ifdef GREAVE_INCLUDE_SDL
         if (terminal_choice == "sdl" || terminal_choice == "sdl2")
@@ -146,11 +173,12 @@ void Core::init(bool dry_run)
 #ifdef GREAVE_INCLUDE_CURSES
         if (terminal_choice == "curses") terminal_ = std::make_shared<TerminalCurses>();
 #endif
+        if (terminal_choice == "headless") terminal_ = std::make_shared<TerminalHeadless>();
         if (!terminal_) guru_meditation_->halt("Invalid terminal specified in prefs.yml");
 
 #ifdef GREAVE_TARGET_WINDOWS
 #ifdef GREAVE_INCLUDE_CURSES
-        if (terminal_choice != "curses") FreeConsole();
+        if (terminal_choice != "curses" && !headless) FreeConsole();
 #endif
 #endif
 
@@ -177,27 +205,58 @@ void Core::load(int save_slot)
     save_slot_ = save_slot;
     std::shared_ptr<SQLite::Database> save_db = std::make_shared<SQLite::Database>(save_filename(save_slot), SQLite::OPEN_READONLY);
     world_->load(save_db);
+
+    // Keep a copy of the save file in memory, so that saving only needs to update what has changed.
+    auto memory_db = std::make_shared<SQLite::Database>(":memory:", SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
+    SQLite::Backup backup(*memory_db, *save_db);
+    backup.executeStep();
+    use_save_db(memory_db);
 }
 
 // The main game loop.
 void Core::main_loop()
 {
-    const auto player = world_->player();
-    // bröther may I have some lööps
-    do
-    {
-        world_->main_loop_events_pre_input();
-        const std::string input = message_log_->render_message_log();
-        parser_->parse(input);
-        world_->main_loop_events_post_input();
-    } while (!player->is_dead());
-
-    Bones::record_death();
+    // The player is looked up again each turn, as a quickload or rewind replaces the World.
+    std::shared_ptr<Player> player;
+    rewind_record("");
     while (true)
     {
-        message("{R}You are dead! Type {M}quit {R}when you are ready to end the game.");
-        const std::string input = StrX::str_tolower(message_log_->render_message_log());
-        if (input == "quit") return;
+        // bröther may I have some lööps
+        do
+        {
+            world_->main_loop_events_pre_input();
+            const std::string input = message_log_->render_message_log();
+            journal_->append(input);
+            parser_->parse(input);
+            world_->main_loop_events_post_input();
+            player = world_->player();
+            rewind_record(input);
+
+            // Report on any save that has finished writing in the background, and autosave if it's time, or if the journal is getting long.
+            if (save_future_.valid() && save_future_.wait_for(std::chrono::seconds(0)) == std::future_status::ready) save_wait();
+            if (player->is_dead()) break;
+            if (prefs_->autosave_interval > 0 && std::chrono::steady_clock::now() - autosave_time_ >= std::chrono::minutes(prefs_->autosave_interval)) save(true);
+            else if (prefs_->journal_size > 0 && journal_->size() >= static_cast<size_t>(prefs_->journal_size)) save(true);
+        } while (!player->is_dead());
+
+        // The saved game is left as it was, so the journal leading up to the player's death is thrown away. Rewinding starts a new one.
+        journal_->discard();
+        const bool can_rewind = (rewind_->count() > 1);
+        while (player->is_dead())
+        {
+            message(can_rewind ? "{R}You are dead! Type {M}rewind {R}to undo your last action, or {M}quit {R}when you are ready to end the game." : "{R}You are dead! Type {M}quit {R}when you are ready to end the game.");
+            const std::string input = StrX::str_tolower(message_log_->render_message_log());
+            if (input == "quit")
+            {
+                Bones::record_death();
+                return;
+            }
+            if (can_rewind && input == "rewind")
+            {
+                rewind(1);
+                player = world_->player();
+            }
+        }
     }
 }
 
@@ -232,21 +291,171 @@ void Core::screen_read(std::string msg, bool interrupt)
 void Core::screen_read(std::string, bool) { }
 #endif
 
+// Returns a pointer to the crash-recovery Journal object.
+const std::shared_ptr<Journal> Core::journal() const { return journal_; }
+
 // Returns a pointer to the MessageLog object.
 const std::shared_ptr<MessageLog> Core::messagelog() const { return message_log_; }
 
 // Returns a pointer to the Parser object.
 const std::shared_ptr<Parser> Core::parser() const { return parser_; }
 
+// Restores the game from the quicksave in the current save slot. The slot's saved game is left alone until the game is next saved.
+void Core::quickload()
+{
+    const std::string quick_fn = Snapshot::filename(save_slot_);
+    if (!FileX::file_exists(quick_fn))
+    {
+        message("{y}There is no quicksave in this slot to load.");
+        return;
+    }
+    save_wait();
+    std::shared_ptr<SQLite::Database> save_db;
+    try
+    {
+        save_db = Snapshot::to_sqlite(quick_fn);
+    } catch (std::exception &e)
+    {
+        guru_meditation_->nonfatal("Could not read quicksave: " + std::string(e.what()), Guru::GURU_ERROR);
+        return;
+    }
+    if (save_db->execAndGet("PRAGMA user_version").getUInt() != CoreConstants::SAVE_VERSION)
+    {
+        message("{R}The quicksave in this slot is from an incompatible version of the game, and cannot be loaded.");
+        return;
+    }
+
+    world_ = std::make_shared<World>();
+    world_->load(save_db);
+    use_save_db(save_db);
+    message("{M}Quicksave loaded from slot {Y}" + std::to_string(save_slot_) + "{M}.");
+
+    // The crash-recovery journal can't replay a quickload, as the quicksave might be replaced before it's replayed. Until the next save, a crash goes back to the slot's saved game as it stands.
+    journal_->discard();
+}
+
+// Writes a quicksave snapshot of the game, alongside the slot's saved game. The file itself is written in the background.
+void Core::quicksave()
+{
+    save_wait();
+    if (!save_snapshot()) return;
+    save_db_busy_ = true;
+    save_future_ = std::async(std::launch::async, &Core::quicksave_write, this, save_slot_);
+    message("{M}Game quicksaved in slot {Y}" + std::to_string(save_slot_) + "{M}.");
+}
+
+// Writes the in-memory copy of the save file to a quicksave snapshot. Runs on a worker thread; returns an error message if it fails.
+std::string Core::quicksave_write(int slot)
+{
+    try
+    {
+        Snapshot::from_sqlite(*save_db_, Snapshot::filename(slot));
+    } catch (std::exception &e)
+    {
+        return e.what();
+    }
+    return "";
+}
+
 // Returns a pointer to the Prefs object.
 const std::shared_ptr<Prefs> Core::prefs() const { return prefs_; }
 
+// Undoes the given number of recent actions, by restoring an in-memory snapshot of the game.
+void Core::rewind(uint32_t steps)
+{
+    if (!prefs_->rewind_snapshots)
+    {
+        message("{y}Rewinding is disabled in {Y}prefs.yml{y}.");
+        return;
+    }
+    rewind_catch_up();
+    if (rewind_->count() < 2)
+    {
+        message("{y}There is nothing to rewind yet.");
+        return;
+    }
+    if (!steps || steps >= rewind_->count())
+    {
+        message("{y}You can rewind between {Y}1 {y}and {Y}" + std::to_string(rewind_->count() - 1) + " {y}actions.");
+        return;
+    }
+
+    const Rewind::Point point = rewind_->rewind(steps);
+    auto save_db = Snapshot::decode(rewind_->data(point), "Rewind snapshot");
+
+    // The message log isn't part of the snapshot, so the current log is written into it before it's loaded, and carries on as it was.
+    save_db->exec(MessageLog::SQL_MSGLOG);
+    message_log_->save(save_db, false);
+
+    world_ = std::make_shared<World>();
+    world_->load(save_db);
+    use_save_db(save_db);
+    rng_->pcg_rng_ = point.rng;
+    message("{M}Rewound {Y}" + std::to_string(steps) + " {M}action" + (steps == 1 ? "" : "s") + ".");
+
+    // The crash-recovery journal can't replay a rewind, as the snapshots only exist in memory. Until the next save, a crash goes back to the slot's saved game as it stands.
+    journal_->discard();
+}
+
+// Takes the rewind snapshot of any commands that were left out while a save was being written, once the save has finished.
+void Core::rewind_catch_up()
+{
+    save_wait();
+    if (rewind_skipped_.size()) rewind_record("");
+}
+
+// Lists the recent actions that can be rewound.
+void Core::rewind_list()
+{
+    rewind_catch_up();
+    rewind_->report();
+}
+
+// Takes an in-memory snapshot of the game after the player's command, so it can be rewound to later.
+void Core::rewind_record(const std::string &input)
+{
+    if (!prefs_->rewind_snapshots || journal_->replaying()) return;
+
+    // The in-memory save can't be updated while it's being copied to disk. Rather than wait for that, this command is left out, and the next snapshot covers it too, under both commands.
+    if (save_future_.valid() && save_future_.wait_for(std::chrono::seconds(0)) == std::future_status::ready) save_wait();
+    if (save_future_.valid() && save_db_busy_)
+    {
+        if (input.size()) rewind_skipped_ += (rewind_skipped_.size() ? ", " : "") + input;
+        return;
+    }
+    if (!save_snapshot()) return;
+    const std::string command = (rewind_skipped_.size() && input.size() ? rewind_skipped_ + ", " + input : rewind_skipped_ + input);
+    try
+    {
+        rewind_->record(*save_db_, command, rng_->pcg_rng_, rewind_in_place_ ? &rewind_changes_ : nullptr);
+        rewind_in_place_ = true;
+    } catch (std::exception &e)
+    {
+        guru_meditation_->nonfatal("Could not take rewind snapshot: " + std::string(e.what()), Guru::GURU_WARN);
+        rewind_in_place_ = false;
+    }
+    rewind_changes_.clear();
+    rewind_skipped_.clear();
+}
+
+// Returns a pointer to the Rewind object, which keeps the in-memory snapshots.
+const std::shared_ptr<Rewind> Core::rewinds() const { return rewind_; }
+
 // Returns a pointer to the Random object.
 const std::shared_ptr<Random> Core::rng() const { return rng_; }
 
-// Saves the game to disk.
-void Core::save()
+// Saves the game to disk. The World is written to an in-memory copy of the save file here, then a worker thread writes that copy to disk.
+void Core::save(bool autosave)
 {
+    if (journal_->replaying()) return;  // Saving while the journal is replayed would throw away the rest of the journal.
+    if (save_future_.valid())
+    {
+        // If the last save is still being written, an autosave can just be skipped; anything else has to wait for it.
+        if (autosave && save_future_.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return;
+        save_wait();
+    }
+    autosave_time_ = std::chrono::steady_clock::now();
+
     const std::string save_fn = save_filename(save_slot_);
     const std::string save_fn_old = save_filename(save_slot_, true);
     if (FileX::is_read_only(save_fn) || (FileX::file_exists(save_fn_old) && FileX::is_read_only(save_fn_old)))
@@ -254,44 +463,86 @@ void Core::save()
         core()->guru()->nonfatal("Saved game file is read-only!", Guru::GURU_ERROR);
         return;
     }
-    if (FileX::file_exists(save_fn_old)) FileX::delete_file(save_fn_old);
-    if (FileX::file_exists(save_fn))
+    if (!save_snapshot()) return;
+
+    const bool backup_old = !save_backed_up_;
+    save_backed_up_ = true;
+
+    // Once the file on disk matches the in-memory save, only the rows written since then need copying over. Moving the old file aside as a backup means writing the whole thing again.
+    std::shared_ptr<const std::vector<char>> changes;
+    if (save_synced_ && !backup_old && FileX::file_exists(save_fn))
     {
-        FileX::rename_file(save_fn, save_fn_old);
-        if (FileX::file_exists(save_fn))
+        try
+        {
+            changes = std::make_shared<const std::vector<char>>(Snapshot::encode_changes(*save_db_, save_changes_));
+        } catch (std::exception &e)
         {
-            guru_meditation_->nonfatal("Could not rename saved game file. Is it read-only?", Guru::GURU_ERROR);
-            return;
+            guru_meditation_->nonfatal("SQL error while gathering changes to the saved game, writing the whole file instead: " + std::string(e.what()), Guru::GURU_WARN);
         }
     }
+    save_changes_.clear();
+    save_synced_ = true;    // If the write fails, save_wait() will clear this again.
+    save_db_busy_ = !changes;   // Only a full write reads the in-memory save; a set of changes has everything it needs.
+    journal_->begin_save();
+    save_future_ = std::async(std::launch::async, &Core::save_write, this, save_slot_, backup_old, changes, SaveManifest::describe(), journal_);
+    message(std::string(autosave ? "{M}Game autosaved" : "{M}Game saved") + " in slot {Y}" + std::to_string(save_slot_) + "{M}.");
+}
 
-    try
+// Returns a filename for a saved game file.
+const std::string Core::save_filename(int slot, bool old_save) const { return "userdata/save/save-" + std::to_string(slot) + (old_save ? ".old" : ".sqlite"); }
+
+// Writes the World to the in-memory copy of the save file, updating it in place where possible. Returns false if the save failed.
+bool Core::save_snapshot()
+{
+    if (save_in_place_ && save_db_)
     {
-        std::shared_ptr<SQLite::Database> save_db = std::make_shared<SQLite::Database>(save_fn, SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
-        save_db->exec("PRAGMA user_version = " + std::to_string(CoreConstants::SAVE_VERSION));
-        sql_unique_id_ = 0; // We're making a new save file each time, so we can reset the unique ID counter.
+        // Every row written here is noted, so that only those rows have to be written to disk. Changes to the tables themselves aren't, so they mean writing the whole file.
+        bool updated = false;
+        sqlite3_update_hook(save_db_->getHandle(), &Core::sql_note_change, this);
+        try
+        {
+            const int schema_version = save_db_->execAndGet("PRAGMA schema_version").getInt();
+            SQLite::Transaction transaction(*save_db_);
+            world_->save(save_db_, true);
+            transaction.commit();
+            if (save_db_->execAndGet("PRAGMA schema_version").getInt() != schema_version) save_synced_ = rewind_in_place_ = false;
+            updated = true;
+        } catch (std::exception &e)
+        {
+            // The transaction is rolled back, but the World no longer knows what has changed since the last save, so a full save is needed instead.
+            guru_meditation_->nonfatal("SQL error while attempting to update the saved game, making a full save instead: " + std::string(e.what()), Guru::GURU_WARN);
+        }
+        sqlite3_update_hook(save_db_->getHandle(), nullptr, nullptr);
+        if (updated) return true;
+    }
 
-        SQLite::Transaction transaction(*save_db);
-        world_->save(save_db);
+    sql_statements_clear();     // The cached statements must be finalized before the database is closed.
+    save_db_.reset();
+    save_changes_.clear();
+    rewind_changes_.clear();
+    save_in_place_ = save_synced_ = rewind_in_place_ = false;
+    try
+    {
+        save_db_ = std::make_shared<SQLite::Database>(":memory:", SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
+        sqlite3_set_authorizer(save_db_->getHandle(), &Core::sql_authorize, nullptr);
+        sql_profile(*save_db_); // The page size is copied over to the file on disk.
+        save_db_->exec("PRAGMA user_version = " + std::to_string(CoreConstants::SAVE_VERSION));
+        sql_unique_id_ = 0; // We're making a new save file, so we can reset the unique ID counter.
+
+        SQLite::Transaction transaction(*save_db_);
+        world_->save(save_db_);
         transaction.commit();
-
-        message("{M}Game saved in slot {Y}" + std::to_string(save_slot_) + "{M}.");
+        save_in_place_ = true;
+        return true;
     } catch (std::exception &e)
     {
+        sql_statements_clear();
+        save_db_.reset();
         guru_meditation_->nonfatal("SQL error while attempting to save the game: " + std::string(e.what()), Guru::GURU_CRITICAL);
-        if (FileX::file_exists(save_fn_old))
-        {
-            guru_meditation_->nonfatal("Attempting to restore backup saved game file.", Guru::GURU_WARN);
-            FileX::delete_file(save_fn);
-            if (FileX::file_exists(save_fn)) guru_meditation_->nonfatal("Could not delete current saved game file! Is it read-only?", Guru::GURU_ERROR);
-            else FileX::rename_file(save_fn_old, save_fn);
-        }
+        return false;
     }
 }
 
-// Returns a filename for a saved game file.
-const std::string Core::save_filename(int slot, bool old_save) const { return "userdata/save/save-" + std::to_string(slot) + (old_save ? ".old" : ".sqlite"); }
-
 // Checks the saved game version of a save file.
 uint32_t Core::save_version(int slot)
 {
@@ -302,12 +553,161 @@ uint32_t Core::save_version(int slot)
     return version;
 }
 
+// Waits for any saved game still being written to disk, and reports any error that happened while writing it.
+void Core::save_wait()
+{
+    if (!save_future_.valid()) return;
+    const std::string error = save_future_.get();
+    if (!error.size()) return;
+    save_synced_ = false;   // Whatever state the file was left in, the next save will replace all of it.
+    guru_meditation_->nonfatal("Error while writing saved game file: " + error, Guru::GURU_CRITICAL);
+}
+
+// Writes a set of changed rows to the save file on disk, or the whole in-memory copy of it if there's no change set. This runs on a worker thread, so it can't touch anything else; returns an error message if it fails.
+std::string Core::save_write(int slot, bool backup_old, std::shared_ptr<const std::vector<char>> changes, SaveManifest::Entry manifest_entry, std::shared_ptr<Journal> journal)
+{
+    const std::string save_fn = save_filename(slot);
+    const std::string save_fn_old = save_filename(slot, true);
+    try
+    {
+        // The first save of each session moves the existing save file aside, so the game as it was at the start of the session can be recovered.
+        if (backup_old && FileX::file_exists(save_fn))
+        {
+            if (FileX::file_exists(save_fn_old)) FileX::delete_file(save_fn_old);
+            FileX::rename_file(save_fn, save_fn_old);
+            if (FileX::file_exists(save_fn)) return "Could not rename saved game file. Is it read-only?";
+        }
+
+        // The changed rows are replayed into the file in a single transaction; failing that, the backup API writes the whole database in one. With the durable profile, either transaction is journaled and synced, so an interrupted write leaves the previous save intact.
+        {
+            SQLite::Database file_db(save_fn, SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
+            sql_profile(file_db);
+            if (changes) Snapshot::apply_changes(file_db, *changes);
+            else
+            {
+                SQLite::Backup backup(file_db, *save_db_);
+                backup.executeStep();
+            }
+        }
+    } catch (std::exception &e)
+    {
+        journal->abandon_save();
+        std::string error = e.what();
+        if (backup_old && FileX::file_exists(save_fn_old))
+        {
+            FileX::delete_file(save_fn);
+            if (FileX::file_exists(save_fn)) error += " Could not delete current saved game file! Is it read-only?";
+            else
+            {
+                FileX::rename_file(save_fn_old, save_fn);
+                error += " The backup saved game file has been restored.";
+            }
+        }
+        return error;
+    }
+
+    // The commands recorded before the save are no longer needed, so the journal starts again from here.
+    journal->commit_save();
+
+    // The save file is safely written by now, so a problem with the manifest isn't worth reporting; the title screen will just check the save file itself.
+    try
+    {
+        SaveManifest::update(slot, manifest_entry, save_fn);
+    } catch (std::exception&) { }
+    return "";
+}
+
+// Replaces the World with one that was set up elsewhere. The next save will be a full save.
+void Core::set_world(std::shared_ptr<World> new_world)
+{
+    save_wait();
+    world_ = new_world;
+    save_in_place_ = false;
+}
+
+// Lets through everything done to the in-memory save, but stops SQLite from clearing whole tables in one go, as rows deleted that way are never passed to sql_note_change().
+int Core::sql_authorize(void*, int action, const char*, const char*, const char*, const char*) { return (action == SQLITE_DELETE ? SQLITE_IGNORE : SQLITE_OK); }
+
+// Notes a row written to the in-memory save, so that it can be written to disk with the next save.
+void Core::sql_note_change(void *owner, int, const char*, const char *table, long long rowid)
+{
+    Core *core_ptr = static_cast<Core*>(owner);
+    core_ptr->save_changes_[table].insert(rowid);
+    if (core_ptr->prefs_->rewind_snapshots) core_ptr->rewind_changes_[table].insert(rowid);
+}
+
+// Applies the SQLite write profile from prefs.yml to a database that's about to be written to.
+void Core::sql_profile(SQLite::Database &db) const
+{
+    db.exec("PRAGMA page_size = " + std::to_string(SQL_PAGE_SIZE));
+    if (prefs_->save_profile == "fast") db.exec("PRAGMA journal_mode = MEMORY; PRAGMA synchronous = OFF");
+    else db.exec("PRAGMA journal_mode = DELETE; PRAGMA synchronous = FULL");
+}
+
+// Retrieves a cached prepared statement for the save database, reset and ready to bind. Statements are kept until the database is replaced, rather than prepared once per row. The cache holds on to its database, so it can never be freed while its statements are still around.
+SQLite::Statement& Core::sql_statement(std::shared_ptr<SQLite::Database> save_db, const std::string &sql)
+{
+    if (sql_statements_db_ != save_db)
+    {
+        sql_statements_clear();
+        sql_statements_db_ = save_db;
+    }
+    auto &statement = sql_statements_[sql];
+    if (!statement) statement = std::unique_ptr<SQLite::Statement>(new SQLite::Statement(*save_db, sql));
+    else
+    {
+        statement->reset();
+        statement->clearBindings();
+    }
+    return *statement;
+}
+
+// Finalizes the cached prepared statements, and releases the database they belong to.
+void Core::sql_statements_clear()
+{
+    sql_statements_.clear();
+    sql_statements_db_.reset();
+}
+
 // Retrieves a new unique SQL ID.
 uint32_t Core::sql_unique_id() { return ++sql_unique_id_; }
 
 // Returns a pointer  to the terminal emulator object.
 const std::shared_ptr<Terminal> Core::terminal() const { return terminal_; }
 
+// Starts a new game in the specified save slot, or loads the saved game in that slot.
+void Core::start_game(int save_slot, bool load_save)
+{
+    save_wait();
+    sql_statements_clear();
+    save_db_.reset();
+    save_slot_ = save_slot;
+    save_changes_.clear();
+    rewind_changes_.clear();
+    rewind_skipped_.clear();
+    save_backed_up_ = save_in_place_ = save_synced_ = rewind_in_place_ = false;
+    autosave_time_ = std::chrono::steady_clock::now();
+    journal_ = std::make_shared<Journal>(save_slot_);
+    rewind_ = std::make_shared<Rewind>();
+    if (load_save)
+    {
+        guru_meditation_->cache_nonfatal();
+        world_ = std::make_shared<World>();
+        load(save_slot_);
+        guru_meditation_->dump_nonfatal();
+
+        // If the game ended without saving last time, anything done since the last save is recovered from the journal.
+        const uint32_t replayed = journal_->replay();
+        if (replayed) message("{M}Recovered {Y}" + std::to_string(replayed) + " {M}action" + (replayed == 1 ? "" : "s") + " from the journal, made since the game was last saved.");
+    }
+    else
+    {
+        journal_->discard();
+        world_ = std::make_shared<World>();
+        world_->new_game();
+    }
+}
+
 // The 'title screen' and saved game selection.
 void Core::title()
 {
@@ -317,7 +717,9 @@ void Core::title()
 #endif
 
     std::vector<bool> save_exists;
+    std::vector<uint32_t> save_versions;
     save_exists.resize(prefs_->save_file_slots);
+    save_versions.resize(prefs_->save_file_slots);
     bool deleting_file = false;
     while (!save_slot_)
     {
@@ -333,16 +735,22 @@ void Core::title()
             message("{0}{U}[{C}Q{U}] {R}Quit game");
             message("{0}{U}[{C}L{U}] {W}Hall of Legends");
         }
+        // The save manifest describes each saved game without having to open it. Save files are only opened if their manifest entry is missing or out of date.
+        const std::map<int, SaveManifest::Entry> manifest = SaveManifest::load();
         for (int i = 1; i <= prefs_->save_file_slots; i++)
         {
             if (FileX::file_exists(save_filename(i)))
             {
                 std::string save_str = "Saved game #" + std::to_string(i);
-                const uint32_t save_ver = save_version(i);
-                if (save_ver == CoreConstants::SAVE_VERSION) save_str = "{W}" + save_str;
-                else save_str = "{R}" + save_str + " {M}<incompatible>";
+                const auto manifest_entry = manifest.find(i);
+                const bool manifest_current = (manifest_entry != manifest.end() && SaveManifest::is_current(manifest_entry->second, save_filename(i)));
+                const uint32_t save_ver = (manifest_current ? manifest_entry->second.version : save_version(i));
+                if (save_ver != CoreConstants::SAVE_VERSION) save_str = "{R}" + save_str + " {M}<incompatible>";
+                else if (manifest_current) save_str = "{W}" + save_str + "{U}: " + SaveManifest::summary(manifest_entry->second);
+                else save_str = "{W}" + save_str;
                 message("{0}{U}[{C}" + std::to_string(i) + "{U}] " + save_str);
                 save_exists.at(i - 1) = true;
+                save_versions.at(i - 1) = save_ver;
             }
             else
             {
@@ -421,6 +829,8 @@ void Core::title()
                                         inner_loop = yes_no_loop = deleting_file = false;
                                         FileX::delete_file(save_filename(input_num));
                                         if (FileX::file_exists(save_filename(input_num, true))) FileX::delete_file(save_filename(input_num, true));
+                                        if (FileX::file_exists(Journal::filename(input_num))) FileX::delete_file(Journal::filename(input_num));
+                                        if (FileX::file_exists(Snapshot::filename(input_num))) FileX::delete_file(Snapshot::filename(input_num));
                                         message("{M}Save file {W}#" + std::to_string(input_num) + " {M}has been deleted!");
                                     }
                                     else if (yes_no[0] == 'n' || yes_no[0] == 'N')
@@ -435,9 +845,8 @@ void Core::title()
                     }
                     else
                     {
-                        uint32_t save_file_ver = 0;
-                        const bool file_exists = FileX::file_exists(save_filename(input_num));
-                        if (file_exists) save_file_ver = save_version(input_num);
+                        const bool file_exists = save_exists.at(input_num - 1);
+                        const uint32_t save_file_ver = save_versions.at(input_num - 1);
                         if (!file_exists || save_file_ver == CoreConstants::SAVE_VERSION)
                         {
                             save_slot_ = input_num;
@@ -450,18 +859,23 @@ void Core::title()
         }
     }
 
-    if (save_exists.at(save_slot_ - 1))
-    {
-        guru_meditation_->cache_nonfatal();
-        world_ = std::make_shared<World>();
-        load(save_slot_);
-        guru_meditation_->dump_nonfatal();
-    }
-    else
-    {
-        world_ = std::make_shared<World>();
-        world_->new_game();
-    }
+    start_game(save_slot_, save_exists.at(save_slot_ - 1));
+}
+
+// Keeps an in-memory copy of a loaded save file, so that saving only needs to update what has changed.
+void Core::use_save_db(std::shared_ptr<SQLite::Database> save_db)
+{
+    sql_statements_clear();
+    save_db_ = save_db;
+    sqlite3_set_authorizer(save_db_->getHandle(), &Core::sql_authorize, nullptr);
+    save_changes_.clear();
+    rewind_changes_.clear();
+    save_synced_ = rewind_in_place_ = false;
+    save_in_place_ = (save_db_->execAndGet("PRAGMA user_version").getUInt() == CoreConstants::SAVE_VERSION);
+
+    // New rows need SQL IDs that won't clash with any of the rows being kept.
+    sql_unique_id_ = save_db_->execAndGet("SELECT MAX(id) FROM ( SELECT MAX(sql_id) AS id FROM buffs UNION ALL SELECT MAX(sql_id) FROM items UNION ALL SELECT MAX(owner_id) FROM items UNION ALL SELECT MAX(inventory) FROM items "
+        "UNION ALL SELECT MAX(sql_id) FROM mobiles UNION ALL SELECT MAX(sql_id) FROM rooms UNION ALL SELECT MAX(inventory_id) FROM shops )").getUInt();
 }
 
 // Returns a pointer to the World object.
@@ -4,17 +4,26 @@
 #ifndef GREAVE_CORE_CORE_H_
 #define GREAVE_CORE_CORE_H_
 
+#include "3rdparty/SQLiteCpp/Statement.h"
 #include "core/guru.h"
+#include "core/journal.h"
+#include "core/rewind.h"
 #include "core/message.h"
 #include "core/parser.h"
 #include "core/prefs.h"
 #include "core/random.h"
+#include "core/save-manifest.h"
 #include "core/terminal.h"
 #include "world/world.h"
 
+#include <chrono>
 #include <cstdint>
+#include <future>
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <vector>
 
 
 class Core
@@ -23,30 +32,67 @@ public:
                                         Core();                 // Constructor, doesn't do too much aside from setting default values for member variables. Use init() to set things up.
     void                                cleanup();              // Cleans up after we're done.
     const std::shared_ptr<Guru>         guru() const;           // Returns a pointer to the Guru Meditation object.
-    void                                init(bool dry_run);     // Sets up the core game classes and data.
+    void                                init(bool dry_run, bool headless = false);  // Sets up the core game classes and data.
+    const std::shared_ptr<Journal>      journal() const;        // Returns a pointer to the crash-recovery Journal object.
     void                                load(int save_slot);    // Loads a specified slot's saved game.
     void                                main_loop();            // The main game loop.
     void                                message(std::string msg, bool interrupt = false);   // Prints a message.
     const std::shared_ptr<MessageLog>   messagelog() const;     // Returns a pointer to the MessageLog object.
     const std::shared_ptr<Parser>       parser() const;         // Returns a pointer to the Parser object.
+    void                                quickload();            // Restores the game from the quicksave in the current save slot. The slot's saved game is left alone until the game is next saved.
+    void                                quicksave();            // Writes a quicksave snapshot of the game, alongside the slot's saved game. The file itself is written in the background.
+    void                                rewind(uint32_t steps); // Undoes the given number of recent actions, by restoring an in-memory snapshot of the game.
+    void                                rewind_list();          // Lists the recent actions that can be rewound.
+    void                                rewind_record(const std::string &input);    // Takes an in-memory snapshot of the game after the player's command, so it can be rewound to later.
+    const std::shared_ptr<Rewind>       rewinds() const;        // Returns a pointer to the Rewind object, which keeps the in-memory snapshots.
     const std::shared_ptr<Random>       rng() const;            // Returns a pointer to the Random object.
-    void                                save();                 // Saves the game to disk.
+    void                                save(bool autosave = false);    // Saves the game to disk. The file itself is written in the background.
+    const std::string                   save_filename(int slot, bool old_save = false) const;   // Returns a filename for a saved game file.
+    void                                save_wait();            // Waits for any saved game still being written to disk, and reports any error that happened while writing it.
     void                                screen_read(std::string msg, bool interrupt);   // Reads a string in a screen reader, if any are active.
+    void                                set_world(std::shared_ptr<World> new_world);    // Replaces the World with one that was set up elsewhere. The next save will be a full save.
+    void                                sql_profile(SQLite::Database &db) const;    // Applies the SQLite write profile from prefs.yml to a database that's about to be written to.
+    SQLite::Statement&                  sql_statement(std::shared_ptr<SQLite::Database> save_db, const std::string &sql);   // Retrieves a cached prepared statement for the save database, reset and ready to bind.
     uint32_t                            sql_unique_id();        // Retrieves a new unique SQL ID.
+    void                                start_game(int save_slot, bool load_save);  // Starts a new game in the specified save slot, or loads the saved game in that slot.
     const std::shared_ptr<Terminal>     terminal() const;       // Returns a pointer  to the terminal emulator object.
     void                                title();                // The 'title screen' and saved game selection.
     const std::shared_ptr<Prefs>        prefs() const;          // Returns a pointer to the Prefs object.
     const std::shared_ptr<World>        world() const;          // Returns a pointer to the World object.
 
 private:
-    const std::string           save_filename(int slot, bool old_save = false) const;   // Returns a filename for a saved game file.
+    static constexpr int        SQL_PAGE_SIZE = 8192;   // The page size for saved game files, which are written in one go and read back all at once.
+
+    std::string                 quicksave_write(int slot);  // Writes the in-memory copy of the save file to a quicksave snapshot. Runs on a worker thread; returns an error message if it fails.
+    void                        rewind_catch_up();      // Takes the rewind snapshot of any commands that were left out while a save was being written, once the save has finished.
+    bool                        save_snapshot();        // Writes the World to the in-memory copy of the save file, updating it in place where possible. Returns false if the save failed.
     uint32_t                    save_version(int slot); // Checks the saved game version of a save file.
+    static int                  sql_authorize(void*, int action, const char*, const char*, const char*, const char*);  // Lets through everything done to the in-memory save, but stops SQLite from clearing whole tables in one go, as rows deleted that way are never passed to sql_note_change().
+    static void                 sql_note_change(void *owner, int, const char*, const char *table, long long rowid);    // Notes a row written to the in-memory save, so that it can be written to disk with the next save, and read again for the next rewind snapshot.
+    void                        sql_statements_clear(); // Finalizes the cached prepared statements, and releases the database they belong to.
+    std::string                 save_write(int slot, bool backup_old, std::shared_ptr<const std::vector<char>> changes, SaveManifest::Entry manifest_entry, std::shared_ptr<Journal> journal); // Writes a set of changed rows to the save file on disk, or the whole in-memory copy of it if there's no change set, then updates the save manifest and journal. Runs on a worker thread; returns an error message if it fails.
+    void                        use_save_db(std::shared_ptr<SQLite::Database> save_db); // Keeps an in-memory copy of a loaded save file, so that saving only needs to update what has changed.
 
+    std::chrono::steady_clock::time_point   autosave_time_; // When the game was last saved, for timing autosaves.
     std::shared_ptr<Guru>       guru_meditation_;   // The Guru Meditation error-handling system.
+    std::shared_ptr<Journal>    journal_;           // The crash-recovery journal, which records commands entered since the last save.
     std::shared_ptr<MessageLog> message_log_;       // The MessageLog object, which handles the scrolling message-log input/output window.
     std::shared_ptr<Parser>     parser_;            // The Parser object, which processes the player's input.
+    std::shared_ptr<Rewind>     rewind_;            // The in-memory snapshots of recent actions, for rewinding.
+    std::map<std::string, std::set<int64_t>>    rewind_changes_;    // The rows of the in-memory save which have been written to since the last rewind snapshot, by table and rowid.
+    bool                        rewind_in_place_;   // Does the last rewind snapshot match the in-memory save, apart from the rows in rewind_changes_? If not, the next snapshot reads the whole save.
+    std::string                 rewind_skipped_;    // The commands left out of the rewind snapshots while a save was being written, which are added to the next snapshot's command.
     std::shared_ptr<Random>     rng_;               // The random number generator.
+    bool                        save_backed_up_;    // Has the save file been backed up to the .old file yet this session?
+    std::map<std::string, std::set<int64_t>>    save_changes_;  // The rows of the in-memory save which have been written to since it was last written to disk, by table and rowid.
+    std::shared_ptr<SQLite::Database>   save_db_;   // An in-memory copy of the save file, updated on the main thread and then written to disk in the background.
+    bool                        save_db_busy_;      // Is the save being written in the background reading the in-memory save? If so, the in-memory save can't be updated until it's done.
+    std::future<std::string>    save_future_;       // The save currently being written to disk by a worker thread, if any. Holds an error message if the write failed.
+    bool                        save_in_place_;     // Does the in-memory save match the game as it was last saved or loaded, so it can be updated in place?
     int                         save_slot_;         // The currently-active saved game slot, or 0 if no game is in progress.
+    bool                        save_synced_;       // Does the save file on disk match the in-memory save, apart from the rows in save_changes_? If not, the next save writes the whole file.
+    std::shared_ptr<SQLite::Database>   sql_statements_db_; // The database that the cached prepared statements belong to. Holding it here keeps it open until the statements have been finalized.
+    std::map<std::string, std::unique_ptr<SQLite::Statement>>   sql_statements_;    // Prepared statements cached during a save, keyed by their SQL.
     uint32_t                    sql_unique_id_;     // The last unique SQL ID to have been used.
     std::shared_ptr<Terminal>   terminal_;          // The Terminal class, which handles low-level interaction with terminal emulation libraries.
     std::shared_ptr<Prefs>      prefs_;             // The Prefs object, containing various user settings in prefs.yml
@@ -0,0 +1,240 @@
+// core/data-cache.cc -- A compiled binary copy of the game's static data, so the YAML files only need to be parsed again when they change.
+// Copyright (c) 2021 Raine "Gravecat" Simmons and the Greave contributors. Licensed under the GNU Affero General Public License v3 or any later version.
+
+#include "3rdparty/LodePNG/lodepng.h"
+#include "core/core.h"
+#include "core/core-constants.h"
+#include "core/data-cache.h"
+#include "core/filex.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+
+// The folder where the cache files are kept.
+const char DataCache::DATA_CACHE_DIR[] = "userdata/cache";
+
+// The identifier at the start of every cache file. It's followed by the hash of the source files it was built from, then the cached data, then a CRC32 of everything before it.
+// The cached data has no structure of its own; it's read back in exactly the order it was written.
+const char DataCache::DATA_CACHE_HEADER[] = "GREAVE DATA CACHE";
+
+
+// Hashes the source files and directories, and reads the cache file if it was built from the same sources.
+DataCache::DataCache(const std::string &name, const std::vector<std::string> &sources) : filename_(std::string(DATA_CACHE_DIR) + "/" + name + ".bin"), loaded_(false),
+    nonfatal_count_(core()->guru()->nonfatal_count()), pos_(0), source_hash_(0)
+{
+    if (!core()->prefs()->data_cache) return;
+
+    // Directories are listed in a fixed order, as the order in which the filesystem returns them can change without any of the files changing.
+    std::vector<std::string> files;
+    for (auto source : sources)
+    {
+        if (!FileX::directory_exists(source))
+        {
+            files.push_back(source);
+            continue;
+        }
+        std::vector<std::string> dir_files = FileX::files_in_dir(source, true);
+        std::sort(dir_files.begin(), dir_files.end());
+        for (auto file : dir_files)
+            files.push_back(source + "/" + file);
+    }
+
+    // The hash covers the name and contents of every source file, so adding, removing, renaming or editing any of them means the cache has to be rebuilt.
+    const std::string versions = std::string(CoreConstants::GAME_VERSION) + " " + std::to_string(CoreConstants::SAVE_VERSION) + " " + std::to_string(DATA_CACHE_VERSION);
+    std::vector<char> hash_data(versions.begin(), versions.end());
+    for (auto file : files)
+    {
+        hash_data.push_back('\0');
+        hash_data.insert(hash_data.end(), file.begin(), file.end());
+        hash_data.push_back('\0');
+        std::ifstream source_file(file, std::ios::binary);
+        if (!source_file.good()) continue;  // Missing files are left for the YAML parser to report.
+        const std::string size_str = std::to_string(FileX::file_size(file));
+        hash_data.insert(hash_data.end(), size_str.begin(), size_str.end());
+        hash_data.push_back('\0');
+        hash_data.insert(hash_data.end(), std::istreambuf_iterator<char>(source_file), std::istreambuf_iterator<char>());
+    }
+    source_hash_ = lodepng_crc32(reinterpret_cast<const unsigned char*>(hash_data.data()), hash_data.size());
+
+    if (!FileX::file_exists(filename_)) return;
+    std::ifstream cache_file(filename_, std::ios::binary);
+    if (!cache_file.good()) return;
+    std::vector<char> cache_data((std::istreambuf_iterator<char>(cache_file)), std::istreambuf_iterator<char>());
+    cache_file.close();
+
+    // A cache file that's damaged, from another version, or built from different source files is just ignored, and gets rebuilt once the source files have been parsed.
+    if (cache_data.size() < sizeof(DATA_CACHE_HEADER) + 8 || std::memcmp(cache_data.data(), DATA_CACHE_HEADER, sizeof(DATA_CACHE_HEADER))) return;
+    uint32_t file_crc = 0, file_hash = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        file_hash |= static_cast<uint32_t>(static_cast<unsigned char>(cache_data[sizeof(DATA_CACHE_HEADER) + i])) << (i * 8);
+        file_crc |= static_cast<uint32_t>(static_cast<unsigned char>(cache_data[cache_data.size() - 4 + i])) << (i * 8);
+    }
+    cache_data.resize(cache_data.size() - 4);
+    if (file_hash != source_hash_ || file_crc != lodepng_crc32(reinterpret_cast<const unsigned char*>(cache_data.data()), cache_data.size())) return;
+
+    data_ = std::move(cache_data);
+    pos_ = sizeof(DATA_CACHE_HEADER) + 4;
+    loaded_ = true;
+}
+
+// Throws an exception if fewer than this many bytes of cached data remain to be read.
+void DataCache::check_remaining(size_t bytes) const { if (data_.size() - pos_ < bytes) throw std::runtime_error("Data cache " + filename_ + " is truncated."); }
+
+// Checks that all of the cached data has been read, throwing an exception if any was left over.
+void DataCache::finish_read() const { if (pos_ != data_.size()) throw std::runtime_error("Data cache " + filename_ + " has unexpected data at the end."); }
+
+// Checks if the cache file was current, so its data can be read instead of the source files.
+bool DataCache::loaded() const { return loaded_; }
+
+// Reads a boolean value from the cached data.
+bool DataCache::read_bool()
+{
+    check_remaining(1);
+    return data_[pos_++];
+}
+
+// Reads a floating-point value from the cached data.
+float DataCache::read_float()
+{
+    check_remaining(sizeof(float));
+    float value;
+    std::memcpy(&value, data_.data() + pos_, sizeof(float));
+    pos_ += sizeof(float);
+    return value;
+}
+
+// Reads a signed integer from the cached data.
+int64_t DataCache::read_int()
+{
+    const uint64_t zigzag = read_uint();
+    return static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+}
+
+// Reads a map of strings from the cached data.
+std::map<std::string, std::string> DataCache::read_map()
+{
+    std::map<std::string, std::string> value;
+    const uint64_t count = read_uint();
+    for (uint64_t i = 0; i < count; i++)
+    {
+        const std::string key = read_string();
+        value.insert(std::make_pair(key, read_string()));
+    }
+    return value;
+}
+
+// Reads a string from the cached data.
+std::string DataCache::read_string()
+{
+    const uint64_t size = read_uint();
+    check_remaining(size);
+    const std::string value(data_.data() + pos_, size);
+    pos_ += size;
+    return value;
+}
+
+// Reads an unsigned integer from the cached data.
+uint64_t DataCache::read_uint()
+{
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        check_remaining(1);
+        const unsigned char byte = static_cast<unsigned char>(data_[pos_++]);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return value;
+    }
+    throw std::runtime_error("Data cache " + filename_ + " is damaged (integer too long).");
+}
+
+// Discards the cached data, so the cache can be rebuilt from the source files instead.
+void DataCache::reset()
+{
+    data_.clear();
+    pos_ = 0;
+    loaded_ = false;
+}
+
+// Writes the cache file, unless any errors were reported while the source files were being parsed.
+void DataCache::save()
+{
+    if (!core()->prefs()->data_cache) return;
+
+    // Data with errors in it isn't cached, so that the errors are reported again the next time it's loaded, rather than only the first time.
+    if (core()->guru()->nonfatal_count() != nonfatal_count_)
+    {
+        core()->guru()->log("Not writing data cache " + filename_ + ", as errors were reported while parsing the data files.", Guru::GURU_WARN);
+        return;
+    }
+
+    std::vector<char> file_data(DATA_CACHE_HEADER, DATA_CACHE_HEADER + sizeof(DATA_CACHE_HEADER));
+    for (int i = 0; i < 4; i++)
+        file_data.push_back(static_cast<char>((source_hash_ >> (i * 8)) & 0xFF));
+    file_data.insert(file_data.end(), data_.begin(), data_.end());
+    const uint32_t crc = lodepng_crc32(reinterpret_cast<const unsigned char*>(file_data.data()), file_data.size());
+    for (int i = 0; i < 4; i++)
+        file_data.push_back(static_cast<char>((crc >> (i * 8)) & 0xFF));
+
+    // The cache is written to a temporary file first, so a half-written cache file is never read back. Failing to write it isn't a problem, it'll just be tried again next time.
+    FileX::make_dir(DATA_CACHE_DIR);
+    const std::string temp_fn = filename_ + ".tmp";
+    std::ofstream temp_file(temp_fn, std::ios::binary | std::ios::trunc);
+    temp_file.write(file_data.data(), file_data.size());
+    temp_file.close();
+    if (!temp_file.good())
+    {
+        if (FileX::file_exists(temp_fn)) FileX::delete_file(temp_fn);
+        core()->guru()->log("Could not write data cache " + filename_, Guru::GURU_WARN);
+        return;
+    }
+    if (FileX::file_exists(filename_)) FileX::delete_file(filename_);
+    FileX::rename_file(temp_fn, filename_);
+    core()->guru()->log("Rebuilt data cache " + filename_);
+}
+
+// Adds a boolean value to the cached data.
+void DataCache::write_bool(bool value) { data_.push_back(value ? 1 : 0); }
+
+// Adds a floating-point value to the cached data.
+void DataCache::write_float(float value)
+{
+    const char *bytes = reinterpret_cast<const char*>(&value);
+    data_.insert(data_.end(), bytes, bytes + sizeof(float));
+}
+
+// Adds a signed integer to the cached data.
+void DataCache::write_int(int64_t value) { write_uint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63)); }
+
+// Adds a map of strings to the cached data.
+void DataCache::write_map(const std::map<std::string, std::string> &value)
+{
+    write_uint(value.size());
+    for (const auto &entry : value)
+    {
+        write_string(entry.first);
+        write_string(entry.second);
+    }
+}
+
+// Adds a string to the cached data.
+void DataCache::write_string(const std::string &value)
+{
+    write_uint(value.size());
+    data_.insert(data_.end(), value.begin(), value.end());
+}
+
+// Adds an unsigned integer to the cached data.
+void DataCache::write_uint(uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        data_.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    data_.push_back(static_cast<char>(value));
+}
@@ -0,0 +1,50 @@
+// core/data-cache.h -- A compiled binary copy of the game's static data, so the YAML files only need to be parsed again when they change.
+// Copyright (c) 2021 Raine "Gravecat" Simmons and the Greave contributors. Licensed under the GNU Affero General Public License v3 or any later version.
+
+#ifndef GREAVE_CORE_DATA_CACHE_H_
+#define GREAVE_CORE_DATA_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+
+class DataCache
+{
+public:
+                DataCache(const std::string &name, const std::vector<std::string> &sources);   // Hashes the source files and directories, and reads the cache file if it was built from the same sources.
+    void        finish_read() const;            // Checks that all of the cached data has been read, throwing an exception if any was left over.
+    bool        loaded() const;                 // Checks if the cache file was current, so its data can be read instead of the source files.
+    bool        read_bool();                    // Reads a boolean value from the cached data.
+    float       read_float();                   // Reads a floating-point value from the cached data.
+    int64_t     read_int();                     // Reads a signed integer from the cached data.
+    std::map<std::string, std::string>  read_map(); // Reads a map of strings from the cached data.
+    std::string read_string();                  // Reads a string from the cached data.
+    uint64_t    read_uint();                    // Reads an unsigned integer from the cached data.
+    void        reset();                        // Discards the cached data, so the cache can be rebuilt from the source files instead.
+    void        save();                         // Writes the cache file, unless any errors were reported while the source files were being parsed.
+    void        write_bool(bool value);         // Adds a boolean value to the cached data.
+    void        write_float(float value);       // Adds a floating-point value to the cached data.
+    void        write_int(int64_t value);       // Adds a signed integer to the cached data.
+    void        write_map(const std::map<std::string, std::string> &value); // Adds a map of strings to the cached data.
+    void        write_string(const std::string &value); // Adds a string to the cached data.
+    void        write_uint(uint64_t value);     // Adds an unsigned integer to the cached data.
+
+private:
+    static constexpr uint32_t   DATA_CACHE_VERSION =    1;  // The cache format version. This should increment whenever anything cached is read or written differently; changes to the tag enums are covered by the saved game version.
+    static const char           DATA_CACHE_DIR[];           // The folder where the cache files are kept.
+    static const char           DATA_CACHE_HEADER[];        // The identifier at the start of every cache file.
+
+    void        check_remaining(size_t bytes) const;    // Throws an exception if fewer than this many bytes of cached data remain to be read.
+
+    std::vector<char>   data_;          // The cached data, either as read from the cache file or as it's being built.
+    std::string         filename_;      // The filename of the cache file.
+    bool                loaded_;        // Was the cache file current, and read successfully?
+    uint32_t            nonfatal_count_;    // The number of nonfatal errors reported before the source files were parsed, so the cache isn't written if parsing them reported more.
+    size_t              pos_;           // The read position in the cached data.
+    uint32_t            source_hash_;   // The hash of the source files' names and contents, along with the game and cache versions.
+};
+
+#endif  // GREAVE_CORE_DATA_CACHE_H_
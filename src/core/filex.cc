@@ -32,6 +32,22 @@ bool FileX::file_exists(const std::string &file)
     return (stat(file.c_str(), &info) == 0);
 }
 
+// Returns the last modification time of a file, or 0 if it doesn't exist.
+int64_t FileX::file_modified(const std::string &file)
+{
+    struct stat info;
+    if (stat(file.c_str(), &info) != 0) return 0;
+    return static_cast<int64_t>(info.st_mtime);
+}
+
+// Returns the size of a file in bytes, or 0 if it doesn't exist.
+uint64_t FileX::file_size(const std::string &file)
+{
+    struct stat info;
+    if (stat(file.c_str(), &info) != 0) return 0;
+    return static_cast<uint64_t>(info.st_size);
+}
+
 // Returns a list of files in a given directory.
 std::vector<std::string> FileX::files_in_dir(const std::string &directory, bool recursive)
 {
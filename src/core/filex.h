@@ -4,6 +4,7 @@
 #ifndef GREAVE_CORE_FILEX_H_
 #define GREAVE_CORE_FILEX_H_
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -14,6 +15,8 @@ public:
     static void delete_file(const std::string &filename);   // Deletes a specified file.
     static bool directory_exists(const std::string &dir);   // Check if a directory exists.
     static bool file_exists(const std::string &file);       // Checks if a file exists.
+    static int64_t  file_modified(const std::string &file); // Returns the last modification time of a file, or 0 if it doesn't exist.
+    static uint64_t file_size(const std::string &file);     // Returns the size of a file in bytes, or 0 if it doesn't exist.
     static std::vector<std::string> files_in_dir(const std::string &directory, bool recursive = false); // Returns a list of files in a given directory.
     static bool is_read_only(const std::string &file);      // Checks if a file is read-only.
     static void make_dir(const std::string &dir);           // Makes a new directory, if it doesn't already exist.
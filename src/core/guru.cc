@@ -10,13 +10,14 @@
 
 
     constexpr char  Guru::FILENAME_LOG[] = "log.txt";   // The default name of the log file. Another filename can be specified with open_syslog().
+    constexpr int   Guru::GURU_INFO, Guru::GURU_WARN, Guru::GURU_ERROR, Guru::GURU_CRITICAL;   // The message severity levels are defined here as well, so they can be passed by reference.
 
 
     // This has to be a non-class function because C.
     void guru_intercept_signal(int sig) { core()->guru()->intercept_signal(sig); }
 
     // Opens the output log for messages.
-    Guru::Guru(std::string log_filename) : cache_nonfatal_(false), cascade_count_(0), cascade_failure_(false), cascade_timer_(std::time(0)), console_ready_(false), dead_already_(false)
+    Guru::Guru(std::string log_filename) : cache_nonfatal_(false), cascade_count_(0), cascade_failure_(false), cascade_timer_(std::time(0)), console_ready_(false), dead_already_(false), nonfatal_count_(0)
     {
         if (!log_filename.size()) log_filename = Guru::FILENAME_LOG;
         FileX::delete_file(log_filename);
@@ -135,6 +136,7 @@
     void Guru::nonfatal(std::string error, int type)
     {
         if (cascade_failure_ || dead_already_) return;
+        nonfatal_count_++;
         int cascade_weight = 0;
         switch(type)
         {
@@ -176,3 +178,6 @@
         else throw std::runtime_error(error);
         if (cache_nonfatal_) nonfatal_cache_.push_back(error);
     }
+
+    // Returns the number of non-fatal errors reported so far.
+    uint32_t Guru::nonfatal_count() const { return nonfatal_count_; }
@@ -4,6 +4,7 @@
 #ifndef GREAVE_CORE_GURU_H_
 #define GREAVE_CORE_GURU_H_
 
+#include <cstdint>
 #include <ctime>
 #include <exception>
 #include <fstream>
@@ -30,6 +31,7 @@ public:
     void    intercept_signal(int sig);                          // Catches a segfault or other fatal signal.
     void    log(std::string msg, int type = Guru::GURU_INFO);   // Logs a message in the system log file.
     void    nonfatal(std::string error, int type);              // Reports a non-fatal error, which will be logged but will not halt execution unless it cascades.
+    uint32_t nonfatal_count() const;                            // Returns the number of non-fatal errors reported so far.
 
 private:
     bool                        cache_nonfatal_;                // Temporarily caches nonfatal error messages.
@@ -40,6 +42,7 @@ private:
     bool                        dead_already_;                  // Have we already died? Is this crash within the Guru subsystem?
     std::string                 last_log_message_;              // Records the last log message, to avoid spamming the log with repeats.
     std::vector<std::string>    nonfatal_cache_;                // Cache of nonfatal error messages.
+    uint32_t                    nonfatal_count_;                // The number of non-fatal errors reported so far.
     std::ofstream               syslog_;                        // The system log file.
 
     static constexpr int    CASCADE_THRESHOLD =         25;     // The amount cascade_count can reach within CASCADE_TIMEOUT seconds before it triggers an abort screen.
@@ -0,0 +1,154 @@
+// core/journal.cc -- The crash-recovery journal, which records the player's commands between saves, so they can be replayed over the last save if the game ends unexpectedly.
+// Copyright (c) 2021 Raine "Gravecat" Simmons and the Greave contributors. Licensed under the GNU Affero General Public License v3 or any later version.
+
+#include "core/core.h"
+#include "core/filex.h"
+#include "core/journal.h"
+
+#include <sstream>
+
+
+const char Journal::JOURNAL_HEADER[] = "GREAVE JOURNAL";    // The first line of every journal file, followed by the state of the random number generator.
+
+
+// Sets up the journal for a given save slot. Nothing is recorded until the journal has a saved game to build on.
+Journal::Journal(int slot) : filename_(filename(slot)), pending_active_(false), replaying_(false), size_(0) { }
+
+// Drops the journal started by begin_save(), if the save file couldn't be written.
+void Journal::abandon_save()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.clear();
+    pending_active_ = false;
+}
+
+// Records a command entered by the player. Each command is flushed straight away, so it survives a crash.
+void Journal::append(const std::string &input)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (replaying_ || !input.size()) return;
+    if (pending_active_) pending_.push_back(input);
+    size_++;
+    if (!file_.is_open()) return;
+    file_ << input << std::endl;
+}
+
+// Starts a new journal, at the point where the game is saved.
+void Journal::begin_save()
+{
+    if (!core()->prefs()->journal_size) return;
+
+    // The commands are only replayed the same way if the random number generator is in the same state as it was when the game was saved.
+    std::stringstream header;
+    header << JOURNAL_HEADER << " " << core()->rng()->pcg_rng_;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.clear();
+    pending_.push_back(header.str());
+    pending_active_ = true;
+    size_ = 0;
+}
+
+// Replaces the journal on disk with the one started by begin_save(), now that the save file has been written. Called from the save thread.
+void Journal::commit_save()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!pending_active_) return;
+    open(pending_);
+    pending_.clear();
+    pending_active_ = false;
+}
+
+// Deletes the journal, when the progress since the last save is deliberately abandoned.
+void Journal::discard()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    file_.close();
+    pending_.clear();
+    pending_active_ = false;
+    size_ = 0;
+    if (FileX::file_exists(filename_)) FileX::delete_file(filename_);
+}
+
+// Returns the journal filename for a save slot.
+std::string Journal::filename(int slot) { return "userdata/save/save-" + std::to_string(slot) + ".journal"; }
+
+// Writes a new journal file with the given lines, then keeps it open for appending.
+void Journal::open(const std::vector<std::string> &lines)
+{
+    // The new journal is written in full before it replaces the old one. If that fails, no journal at all is better than one that doesn't match the save file.
+    file_.close();
+    const std::string temp_fn = filename_ + ".tmp";
+    std::ofstream temp_file(temp_fn);
+    for (auto line : lines)
+        temp_file << line << "\n";
+    temp_file.close();
+    if (FileX::file_exists(filename_)) FileX::delete_file(filename_);
+    if (!temp_file.good())
+    {
+        FileX::delete_file(temp_fn);
+        return;
+    }
+    FileX::rename_file(temp_fn, filename_);
+    file_.open(filename_, std::ios::app);
+}
+
+// Checks if the journal is currently being replayed.
+bool Journal::replaying() const { return replaying_; }
+
+// Replays the journal over the saved game that was just loaded, or starts a new journal if there isn't one. Returns the number of commands replayed.
+uint32_t Journal::replay()
+{
+    if (!core()->prefs()->journal_size) return 0;
+    std::vector<std::string> lines;
+    std::ifstream journal_file(filename_);
+    std::string line;
+    while (std::getline(journal_file, line))
+        lines.push_back(line);
+    journal_file.close();
+
+    // If there's no journal, or it's damaged, the saved game is used as it is, and a new journal is started.
+    std::string header = std::string(JOURNAL_HEADER) + " ";
+    if (!lines.size() || lines.at(0).substr(0, header.size()) != header)
+    {
+        if (lines.size()) core()->guru()->nonfatal("The journal file is damaged, and will not be replayed.", Guru::GURU_WARN);
+        begin_save();
+        commit_save();
+        return 0;
+    }
+    std::stringstream rng_state(lines.at(0).substr(header.size()));
+    pcg32 rng = core()->rng()->pcg_rng_;
+    if (!(rng_state >> rng))
+    {
+        core()->guru()->nonfatal("The journal file is damaged, and will not be replayed.", Guru::GURU_WARN);
+        begin_save();
+        commit_save();
+        return 0;
+    }
+    core()->rng()->pcg_rng_ = rng;
+
+    // Each command is run exactly as the main game loop ran it. The World is looked up each time, as a quickload replaces it.
+    uint32_t replayed = 0;
+    replaying_ = true;
+    for (size_t i = 1; i < lines.size() && !core()->world()->player()->is_dead(); i++)
+    {
+        core()->message("{c}> " + lines.at(i));
+        core()->world()->main_loop_events_pre_input();
+        core()->parser()->parse(lines.at(i));
+        core()->world()->main_loop_events_post_input();
+        replayed++;
+    }
+    replaying_ = false;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_ = replayed;
+    file_.open(filename_, std::ios::app);
+    return replayed;
+}
+
+// The number of commands recorded since the game was last saved.
+size_t Journal::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return size_;
+}
@@ -0,0 +1,42 @@
+// core/journal.h -- The crash-recovery journal, which records the player's commands between saves, so they can be replayed over the last save if the game ends unexpectedly.
+// Copyright (c) 2021 Raine "Gravecat" Simmons and the Greave contributors. Licensed under the GNU Affero General Public License v3 or any later version.
+
+#ifndef GREAVE_CORE_JOURNAL_H_
+#define GREAVE_CORE_JOURNAL_H_
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+class Journal
+{
+public:
+                Journal(int slot);              // Sets up the journal for a given save slot. Nothing is recorded until the journal has a saved game to build on.
+    void        abandon_save();                 // Drops the journal started by begin_save(), if the save file couldn't be written.
+    void        append(const std::string &input);   // Records a command entered by the player. Each command is flushed straight away, so it survives a crash.
+    void        begin_save();                   // Starts a new journal, at the point where the game is saved.
+    void        commit_save();                  // Replaces the journal on disk with the one started by begin_save(), now that the save file has been written. Called from the save thread.
+    void        discard();                      // Deletes the journal, when the progress since the last save is deliberately abandoned.
+    static std::string  filename(int slot);     // Returns the journal filename for a save slot.
+    bool        replaying() const;              // Checks if the journal is currently being replayed.
+    uint32_t    replay();                       // Replays the journal over the saved game that was just loaded, or starts a new journal if there isn't one. Returns the number of commands replayed.
+    size_t      size() const;                   // The number of commands recorded since the game was last saved.
+
+private:
+    static const char   JOURNAL_HEADER[];       // The first line of every journal file, followed by the state of the random number generator.
+
+    void        open(const std::vector<std::string> &lines);    // Writes a new journal file with the given lines, then keeps it open for appending.
+
+    std::ofstream               file_;          // The journal file on disk, open for appending.
+    std::string                 filename_;      // The journal's filename.
+    mutable std::mutex          mutex_;         // The journal is swapped over by the save thread, while the main thread keeps appending to it.
+    std::vector<std::string>    pending_;       // The journal started by begin_save(), which replaces the one on disk once the save file has been written.
+    bool                        pending_active_;    // Has begin_save() been called, with the save file not yet written?
+    bool                        replaying_;     // Is the journal currently being replayed?
+    size_t                      size_;          // The number of commands recorded since the game was last saved.
+};
+
+#endif  // GREAVE_CORE_JOURNAL_H_
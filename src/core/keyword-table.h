@@ -0,0 +1,160 @@
+// core/keyword-table.h -- Fixed keyword lookup tables for the data file parsers, built at compile time as perfect hash tables, so each lookup is one hash and one string comparison.
+// Copyright (c) 2021 Raine "Gravecat" Simmons and the Greave contributors. Licensed under the GNU Affero General Public License v3 or any later version.
+
+#ifndef GREAVE_CORE_KEYWORD_TABLE_H_
+#define GREAVE_CORE_KEYWORD_TABLE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+
+// The number of hash slots for a table of this many keywords: at least four per keyword, so a seed with no collisions turns up after a handful of tries.
+constexpr size_t keyword_table_slots(size_t keywords)
+{
+    size_t slots = 4;
+    while (slots < keywords * 4) slots *= 2;
+    return slots;
+}
+
+// A table of keywords and the values they stand for. Tables should be declared constexpr, so that a missing, blank or duplicate keyword, or a table that can't be perfectly hashed, is a compile error.
+template<class T, size_t N> class KeywordTable
+{
+public:
+    struct Keyword { const char *str; T value; };   // One keyword and the value it stands for.
+
+    constexpr KeywordTable(const Keyword (&keywords)[N]) : lengths_{}, prefix_count_(0), prefix_lengths_{}, seed_(0), slots_{}, strings_{}, values_{}   // Builds the table from a list of keywords.
+    {
+        for (size_t i = 0; i < N; i++)
+            add(i, keywords[i].str, keywords[i].value);
+        build();
+    }
+    bool        contains(const std::string &str) const { return index(str.data(), str.size()) < N; }   // Checks if a string is one of the keywords.
+    const T*    find(const std::string &str) const { return find(str.data(), str.size()); }         // Looks up a keyword, returning its value, or nullptr if it isn't in the table.
+    const T*    find(const char *str, size_t len) const                 // As above, but with a string that isn't null-terminated.
+    {
+        const size_t i = index(str, len);
+        return (i < N ? &values_[i] : nullptr);
+    }
+    const T*    find_prefix(const std::string &str, size_t &len) const  // Finds the longest keyword that starts a longer string, setting len to the keyword's length. Returns nullptr if none do.
+    {
+        for (size_t p = 0; p < prefix_count_; p++)
+        {
+            if (str.size() <= prefix_lengths_[p]) continue;
+            const T* value = find(str.data(), prefix_lengths_[p]);
+            if (!value) continue;
+            len = prefix_lengths_[p];
+            return value;
+        }
+        return nullptr;
+    }
+    std::string name(T value) const                                     // Returns the first keyword with a given value, or a blank string if none have it. This is a linear search, intended for error messages.
+    {
+        for (size_t i = 0; i < N; i++)
+            if (values_[i] == value) return strings_[i];
+        return "";
+    }
+    static constexpr size_t size() { return N; }                        // The number of keywords in this table.
+
+protected:
+    constexpr KeywordTable() : lengths_{}, prefix_count_(0), prefix_lengths_{}, seed_(0), slots_{}, strings_{}, values_{} { }  // Creates an empty table, for KeywordSet to fill in.
+    constexpr void  add(size_t pos, const char *str, T value)           // Sets one of the keywords, before the table is built.
+    {
+        if (!str || !str[0]) throw std::logic_error("Missing or blank keyword in keyword table.");
+        size_t len = 0;
+        while (str[len]) len++;
+        lengths_[pos] = len;
+        strings_[pos] = str;
+        values_[pos] = value;
+    }
+    constexpr void  build()                                             // Finds a hash seed which gives every keyword its own slot, and the keyword lengths to try when matching prefixes.
+    {
+        for (size_t i = 0; i < N; i++)
+        {
+            for (size_t j = 0; j < i; j++)
+                if (lengths_[i] == lengths_[j] && equal(strings_[i], strings_[j], lengths_[i])) throw std::logic_error("Duplicate keyword in keyword table.");
+
+            // The distinct keyword lengths are kept longest first, so find_prefix() matches "northeast" before "north".
+            size_t p = 0;
+            while (p < prefix_count_ && prefix_lengths_[p] > lengths_[i]) p++;
+            if (p < prefix_count_ && prefix_lengths_[p] == lengths_[i]) continue;
+            for (size_t q = prefix_count_; q > p; q--)
+                prefix_lengths_[q] = prefix_lengths_[q - 1];
+            prefix_lengths_[p] = lengths_[i];
+            prefix_count_++;
+        }
+
+        for (uint32_t seed = 0; seed < MAX_SEEDS; seed++)
+        {
+            bool collision = false;
+            for (size_t s = 0; s < SLOTS; s++)
+                slots_[s] = 0;
+            for (size_t i = 0; i < N && !collision; i++)
+            {
+                const size_t slot = hash(strings_[i], lengths_[i], seed) & (SLOTS - 1);
+                if (slots_[slot]) collision = true;
+                else slots_[slot] = i + 1;
+            }
+            if (collision) continue;
+            seed_ = seed;
+            return;
+        }
+        throw std::logic_error("Could not find a perfect hash for keyword table.");
+    }
+
+private:
+    static constexpr uint32_t   MAX_SEEDS = 4096;                       // The number of hash seeds to try before giving up.
+    static constexpr size_t     SLOTS =     keyword_table_slots(N);     // The number of hash slots in the table.
+
+    static_assert(N > 0 && N < 255, "Keyword tables must have between 1 and 254 keywords.");
+
+    static constexpr bool       equal(const char *a, const char *b, size_t len)     // Compares two strings of the same length, at compile time.
+    {
+        for (size_t i = 0; i < len; i++)
+            if (a[i] != b[i]) return false;
+        return true;
+    }
+    static constexpr uint32_t   hash(const char *str, size_t len, uint32_t seed)    // FNV-1a, started from the seed, with a final mix so the low bits depend on every character.
+    {
+        uint32_t result = 2166136261u ^ (seed * 0x9E3779B9u);
+        for (size_t i = 0; i < len; i++)
+        {
+            result ^= static_cast<unsigned char>(str[i]);
+            result *= 16777619u;
+        }
+        result ^= result >> 15;
+        result *= 0x2C1B3C6Du;
+        result ^= result >> 12;
+        return result;
+    }
+    size_t      index(const char *str, size_t len) const                // Returns the position of a keyword, or N if it isn't in the table.
+    {
+        const uint8_t slot = slots_[hash(str, len, seed_) & (SLOTS - 1)];
+        if (!slot || lengths_[slot - 1] != len || std::memcmp(strings_[slot - 1], str, len)) return N;
+        return slot - 1;
+    }
+
+    size_t      lengths_[N];        // The length of each keyword.
+    size_t      prefix_count_;      // The number of distinct keyword lengths.
+    size_t      prefix_lengths_[N]; // The distinct keyword lengths, longest first.
+    uint32_t    seed_;              // The hash seed which gives every keyword its own slot.
+    uint8_t     slots_[SLOTS];      // The position of the keyword in each slot, plus one, or 0 for an empty slot.
+    const char* strings_[N];        // The keywords themselves.
+    T           values_[N];         // The value each keyword stands for.
+};
+
+// A set of keywords with no values attached, for checking that strings are valid.
+template<size_t N> class KeywordSet : public KeywordTable<bool, N>
+{
+public:
+    constexpr KeywordSet(const char* const (&keywords)[N]) : KeywordTable<bool, N>()  // Builds the set from a list of keywords.
+    {
+        for (size_t i = 0; i < N; i++)
+            this->add(i, keywords[i], true);
+        this->build();
+    }
+};
+
+#endif  // GREAVE_CORE_KEYWORD_TABLE_H_
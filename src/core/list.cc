@@ -3,25 +3,19 @@
 
 #include "core/core.h"
 #include "core/list.h"
+#include "core/symbols.h"
+
+
+// The suffixes of the Lists linked to by a & link, in the order of ListEntry::refs.
+const std::string List::RARITY_SUFFIXES[4] = { "_COMMON", "_UNCOMMON", "_RARE", "_SPECIAL" };
 
 
 // Returns the element at the given position of the List.
 ListEntry List::at(size_t pos, bool nofollow) const
 {
     if (pos >= data_.size()) throw std::runtime_error("Invalid list position: " + std::to_string(pos));
-    if (data_.at(pos).str[0] == '#' && !nofollow) return core()->world()->get_list(data_.at(pos).str.substr(1))->rnd();
-    else if (data_.at(pos).str[0] == '&' && !nofollow)
-    {
-        const int roll = core()->rng()->rnd(LIST_RARITY_RARE);
-        std::string rarity = "COMMON";
-        if (roll == 1)
-        {
-            if (core()->rng()->rnd(LIST_RARITY_SPECIAL) == 1) rarity = "SPECIAL";
-            else rarity = "RARE";
-        }
-        else if (roll >= 2 && roll <= LIST_RARITY_UNCOMMON) rarity = "UNCOMMON";
-        return core()->world()->get_list(data_.at(pos).str.substr(1) + "_" + rarity)->rnd();
-    }
+    if (data_.at(pos).str[0] == '#' && !nofollow) return core()->world()->get_list(data_.at(pos).refs[0])->rnd();
+    else if (data_.at(pos).str[0] == '&' && !nofollow) return core()->world()->get_list(data_.at(pos).refs[rnd_rarity()])->rnd();
     else return data_.at(pos);
 }
 
@@ -32,20 +26,32 @@ bool List::contains(const std::string &query) const
     {
         std::string list_data = le.str;
         if (!list_data.size()) continue;
-        if (list_data[0] == '#' && core()->world()->get_list(list_data.substr(1))->contains(query)) return true;
+        if (list_data[0] == '#' && core()->world()->get_list(le.refs[0])->contains(query)) return true;
         else if (list_data[0] == '&')
         {
-            const std::string sublist_name = list_data.substr(1);
-            if (core()->world()->get_list(sublist_name + "_COMMON")->contains(query)) return true;
-            if (core()->world()->get_list(sublist_name + "_UNCOMMON")->contains(query)) return true;
-            if (core()->world()->get_list(sublist_name + "_RARE")->contains(query)) return true;
-            if (core()->world()->get_list(sublist_name + "_SPECIAL")->contains(query)) return true;
+            for (auto ref : le.refs)
+                if (core()->world()->get_list(ref)->contains(query)) return true;
         }
         else if (list_data == query) return true;
     }
     return false;
 }
 
+// Interns the IDs of any Lists this List links to, so they can be looked up by symbol.
+void List::intern_refs()
+{
+    for (auto &entry : data_)
+    {
+        if (!entry.str.size()) continue;
+        if (entry.str[0] == '#' || entry.str[0] == '+') entry.refs[0] = Symbols::intern(entry.str.substr(1));
+        else if (entry.str[0] == '&')
+        {
+            for (size_t i = 0; i < entry.refs.size(); i++)
+                entry.refs[i] = Symbols::intern(entry.str.substr(1) + RARITY_SUFFIXES[i]);
+        }
+    }
+}
+
 // Merges a second List into this List.
 void List::merge_with(std::shared_ptr<List> second_list)
 {
@@ -68,22 +74,24 @@ ListEntry List::rnd() const
         if (!list_copy->size()) throw std::runtime_error("Could not find suitable result on list.");
         const size_t choice = core()->rng()->rnd(0, list_copy->data_.size() - 1);
         ListEntry result = list_copy->data_.at(choice);
-        if (result.str.size() && result.str[0] == '#') return core()->world()->get_list(result.str.substr(1))->rnd();
-        else if (result.str.size() && result.str[0] == '&')
-        {
-            const int roll = core()->rng()->rnd(LIST_RARITY_RARE);
-            std::string rarity = "COMMON";
-            if (roll == 1)
-            {
-                if (core()->rng()->rnd(LIST_RARITY_SPECIAL) == 1) rarity = "SPECIAL";
-                else rarity = "RARE";
-            }
-            else if (roll >= 2 && roll <= LIST_RARITY_UNCOMMON) rarity = "UNCOMMON";
-            return core()->world()->get_list(result.str.substr(1) + "_" + rarity)->rnd();
-        }
+        if (result.str.size() && result.str[0] == '#') return core()->world()->get_list(result.refs[0])->rnd();
+        else if (result.str.size() && result.str[0] == '&') return core()->world()->get_list(result.refs[rnd_rarity()])->rnd();
         else return result;
     }
 }
 
+// Picks the rarity of the List to use from a & link, as an index into ListEntry::refs.
+size_t List::rnd_rarity()
+{
+    const int roll = core()->rng()->rnd(LIST_RARITY_RARE);
+    if (roll == 1)
+    {
+        if (core()->rng()->rnd(LIST_RARITY_SPECIAL) == 1) return 3;
+        else return 2;
+    }
+    else if (roll >= 2 && roll <= LIST_RARITY_UNCOMMON) return 1;
+    return 0;
+}
+
 // Returns the size of the List.
 size_t List::size() const { return data_.size(); }
@@ -4,7 +4,9 @@
 #ifndef GREAVE_CORE_LIST_H_
 #define GREAVE_CORE_LIST_H_
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -14,6 +16,7 @@ struct ListEntry
 {
     uint32_t    count;
     std::string str;
+    std::array<uint32_t, 4> refs = { };     // The symbols of any Lists this entry links to, set by List::intern_refs(): one for a # or + link, or one for each rarity of a & link.
 };
 
 class List
@@ -21,6 +24,7 @@ class List
 public:
     ListEntry   at(size_t pos, bool nofollow = false) const;    // Returns the element at the given position of the List.
     bool        contains(const std::string &query) const;       // Checks to see if an entry exists on this List.
+    void        intern_refs();                                  // Interns the IDs of any Lists this List links to, so they can be looked up by symbol.
     void        merge_with(std::shared_ptr<List> second_list);  // Merges a second List into this List.
     void        push_back(ListEntry item);                      // Adds a new item to an existing List.
     ListEntry   rnd() const;                                    // Returns a random element from the List, parsing any sub-lists in the process.
@@ -30,6 +34,9 @@ private:
     static constexpr int    LIST_RARITY_UNCOMMON =  5;      // Rarity value (1 in X chance) of an uncommon item being chosen from a weighted list.
     static constexpr int    LIST_RARITY_RARE =      12;     // As above, but for rare list items.
     static constexpr int    LIST_RARITY_SPECIAL =   100;    // As above, for special list items.
+    static const std::string    RARITY_SUFFIXES[4];         // The suffixes of the Lists linked to by a & link, in the order of ListEntry::refs.
+
+    static size_t   rnd_rarity();   // Picks the rarity of the List to use from a & link, as an index into ListEntry::refs.
 
     std::vector<ListEntry>  data_;  // The list's data, a vector.
 };
@@ -5,20 +5,22 @@
 #ifdef GREAVE_TARGET_WINDOWS
 #include "3rdparty/Tolk/Tolk.h"
 #endif
+#include "3rdparty/LodePNG/lodepng.h"
 #include "core/core.h"
 #include "core/message.h"
 #include "core/strx.h"
 
+#include <algorithm>
 #include <cmath>
 #include <regex>
 
 
 // SQL string to construct database table.
-constexpr char MessageLog::SQL_MSGLOG[] = "CREATE TABLE 'msglog' ( line INTEGER PRIMARY KEY, text TEXT NOT NULL )";
+constexpr char MessageLog::SQL_MSGLOG[] = "CREATE TABLE msglog_blocks ( block INTEGER PRIMARY KEY, data BLOB NOT NULL, first_line INTEGER NOT NULL, lines INTEGER NOT NULL )";
 
 
 // Constructor, sets some default values.
-MessageLog::MessageLog() : dragging_scrollbar_(false), dragging_scrollbar_offset_(0), offset_(0) { recalc_window_sizes(); }
+MessageLog::MessageLog() : dragging_scrollbar_(false), dragging_scrollbar_offset_(0), output_processed_width_(0), legacy_table_(false), lines_saved_(0), lines_trimmed_(0), offset_(0) { recalc_window_sizes(); }
 
 #ifdef GREAVE_TOLK
 // Adds a message to the latest messages vector.
@@ -28,12 +30,33 @@ void MessageLog::add_latest_message(const std::string &msg) { latest_messages_.p
 void MessageLog::clear_latest_messages() { latest_messages_.clear(); }
 #endif
 
+// Word-wraps a single raw message and appends it to the processed output.
+void MessageLog::append_processed(const std::string &line)
+{
+    const std::vector<std::string> wrapped = wrap_message(line);
+    output_processed_.insert(output_processed_.end(), wrapped.begin(), wrapped.end());
+    output_line_counts_.push_back(wrapped.size());
+}
+
+// The number of messages still compressed in archived blocks.
+uint32_t MessageLog::archived_lines() const
+{
+    uint32_t lines = 0;
+    for (auto &block : archived_blocks_)
+        lines += block.lines;
+    return lines;
+}
+
 // Clears the message log.
 void MessageLog::clear_messages()
 {
     output_raw_.clear();
     output_processed_.clear();
+    output_line_counts_.clear();
     input_buffer_.clear();
+    archived_blocks_.clear();
+    legacy_table_ = false;
+    lines_saved_ = lines_trimmed_ = 0;
 #ifdef GREAVE_TOLK
     latest_messages_.clear();
 #endif
@@ -44,9 +67,41 @@ void MessageLog::load(std::shared_ptr<SQLite::Database> save_db)
 {
     clear_messages();
     last_input_.clear();
-    SQLite::Statement query(*save_db, "SELECT text FROM msglog ORDER BY line ASC");
-    while (query.executeStep())
-        output_raw_.push_back(query.getColumn("text").getString());
+    if (save_db->tableExists("msglog_blocks"))
+    {
+        SQLite::Statement query(*save_db, "SELECT * FROM msglog_blocks ORDER BY block ASC");
+        while (query.executeStep())
+        {
+            ArchivedBlock block;
+            block.block = query.getColumn("block").getUInt();
+            const SQLite::Column data = query.getColumn("data");
+            const unsigned char *blob = static_cast<const unsigned char*>(data.getBlob());
+            block.data.assign(blob, blob + data.getBytes());
+            block.first_line = query.getColumn("first_line").getUInt();
+            block.lines = query.getColumn("lines").getUInt();
+            archived_blocks_.push_back(block);
+        }
+        if (archived_blocks_.size())
+        {
+            lines_trimmed_ = archived_blocks_.front().first_line;
+            lines_saved_ = archived_blocks_.back().first_line + archived_blocks_.back().lines;
+        }
+
+        // Only the newest block is decoded for now; the rest are decoded when the player scrolls back to them.
+        restore_block();
+    }
+    else
+    {
+        // Older save files store the message log with one row per line.
+        SQLite::Statement query(*save_db, "SELECT line, text FROM msglog ORDER BY line ASC");
+        while (query.executeStep())
+        {
+            if (!output_raw_.size()) lines_trimmed_ = query.getColumn("line").getUInt();
+            lines_saved_ = query.getColumn("line").getUInt() + 1;
+            output_raw_.push_back(query.getColumn("text").getString());
+        }
+        legacy_table_ = true;
+    }
 
     reprocess_output();
     offset_ = static_cast<int>(output_processed_.size() - output_window_height_);    // Move the offset back to the bottom of the message log.
@@ -58,7 +113,14 @@ void MessageLog::load(std::shared_ptr<SQLite::Database> save_db)
 void MessageLog::msg(std::string str)
 {
     output_raw_.push_back(str);
-    reprocess_output();
+    recalc_window_sizes();
+    if (output_window_width_ != output_processed_width_) reprocess_output();
+    else
+    {
+        // The window hasn't changed, so only the new message needs word-wrapping.
+        append_processed(str);
+        trim_log();
+    }
     offset_ = output_processed_.size() - output_window_height_;
     dragging_scrollbar_ = false;
 }
@@ -113,6 +175,10 @@ std::string MessageLog::render_message_log(bool accept_blank_input)
 
     while(true)
     {
+        // Older messages are only decoded when the player scrolls back far enough to see them.
+        while (offset_ <= 1 && archived_blocks_.size())
+            offset_ += restore_block();
+
         // Clear the screen, fill in dark gray areas for the input and output areas.
         core()->terminal()->cls();
         core()->terminal()->fill(output_window_x_, output_window_y_, output_window_width_, output_window_height_, Terminal::Colour::DARKEST_GREY);
@@ -166,7 +232,8 @@ std::string MessageLog::render_message_log(bool accept_blank_input)
         }
         else if (key == Terminal::Key::RESIZED)
         {
-            reprocess_output();
+            recalc_window_sizes();
+            if (output_window_width_ != output_processed_width_) reprocess_output();
             offset_ = output_processed_.size() - output_window_height_;
         }
         else if (key >= ' ' && key <= '~' && key != '{' && key != '}') input_buffer_ += static_cast<char>(key);
@@ -241,38 +308,136 @@ std::string MessageLog::render_message_log(bool accept_blank_input)
     return "";
 }
 
+// Decodes the newest archived block, adding its messages to the start of the log. Returns the number of processed lines added.
+size_t MessageLog::restore_block()
+{
+    if (!archived_blocks_.size()) return 0;
+    const ArchivedBlock block = archived_blocks_.back();
+    archived_blocks_.pop_back();
+
+    std::vector<unsigned char> text;
+    const unsigned int error = lodepng::decompress(text, block.data);
+    if (error)
+    {
+        // If a block can't be decoded, it and everything older than it is dropped from the log.
+        core()->guru()->nonfatal("Could not decompress message log: " + std::string(lodepng_error_text(error)), Guru::GURU_ERROR);
+        lines_trimmed_ = block.first_line + block.lines;
+        archived_blocks_.clear();
+        return 0;
+    }
+
+    std::vector<std::string> lines(1);
+    for (auto ch : text)
+    {
+        if (ch) lines.back() += static_cast<char>(ch);
+        else lines.push_back("");
+    }
+    lines.resize(block.lines);
+    output_raw_.insert(output_raw_.begin(), lines.begin(), lines.end());
+    if (output_processed_width_ != output_window_width_)
+    {
+        // The window has changed size since the log was last word-wrapped, so the whole log is wrapped again, the restored block included.
+        reprocess_output();
+        size_t processed_lines = 0;
+        for (size_t i = 0; i < lines.size() && i < output_line_counts_.size(); i++)
+            processed_lines += output_line_counts_.at(i);
+        return processed_lines;
+    }
+
+    std::vector<std::string> processed;
+    std::vector<size_t> line_counts;
+    for (auto line : lines)
+    {
+        const std::vector<std::string> wrapped = wrap_message(line);
+        processed.insert(processed.end(), wrapped.begin(), wrapped.end());
+        line_counts.push_back(wrapped.size());
+    }
+    output_processed_.insert(output_processed_.begin(), processed.begin(), processed.end());
+    output_line_counts_.insert(output_line_counts_.begin(), line_counts.begin(), line_counts.end());
+    return processed.size();
+}
+
 // Reprocesses the raw output to fit into the message window.
 void MessageLog::reprocess_output()
 {
     recalc_window_sizes();
-    while (output_raw_.size() > static_cast<unsigned int>(core()->prefs()->log_max_size))
-        output_raw_.erase(output_raw_.begin());
-
     output_processed_.clear();
+    output_line_counts_.clear();
+    trim_log();
     for (auto line : output_raw_)
+        append_processed(line);
+    output_processed_width_ = output_window_width_;
+}
+
+// Saves the message log to disk.
+void MessageLog::save(std::shared_ptr<SQLite::Database> save_db, bool in_place)
+{
+    const uint32_t raw_first_line = lines_trimmed_ + archived_lines();
+    const uint32_t end_line = raw_first_line + output_raw_.size();
+    uint32_t first_block = raw_first_line / SAVE_BLOCK_LINES;
+
+    if (in_place && !legacy_table_)
+    {
+        // Each message keeps the same line number for as long as it's in the log, so saving in place only needs to drop the trimmed blocks and write the blocks with new lines in them.
+        SQLite::Statement &trim_query = core()->sql_statement(save_db, "DELETE FROM msglog_blocks WHERE block < :block");
+        trim_query.bind(":block", lines_trimmed_ / SAVE_BLOCK_LINES);
+        trim_query.exec();
+        first_block = std::max(first_block, lines_saved_ / SAVE_BLOCK_LINES);
+
+        // If the oldest block has had lines trimmed from it, it needs rewriting too.
+        if (!archived_blocks_.size() && lines_trimmed_ % SAVE_BLOCK_LINES && lines_trimmed_ / SAVE_BLOCK_LINES < first_block) save_block(save_db, lines_trimmed_ / SAVE_BLOCK_LINES);
+    }
+    else
     {
-        bool same_line = false;
-        if (line.size() >= 3 && line.substr(0, 3) == "{0}")
+        // Older save files are converted to the new format when they're next saved.
+        if (in_place)
         {
-            line = line.substr(3);
-            same_line = true;
+            save_db->exec("DROP TABLE msglog");
+            save_db->exec(SQL_MSGLOG);
+        }
+
+        // Archived blocks haven't changed since they were loaded, so they can be written back as they are.
+        for (auto &block : archived_blocks_)
+        {
+            SQLite::Statement &query = core()->sql_statement(save_db, "INSERT INTO msglog_blocks ( block, data, first_line, lines ) VALUES ( :block, :data, :first_line, :lines )");
+            query.bind(":block", block.block);
+            query.bind(":data", block.data.data(), block.data.size());
+            query.bind(":first_line", block.first_line);
+            query.bind(":lines", block.lines);
+            query.exec();
         }
-        std::vector<std::string> split_line = StrX::string_explode_colour(line, output_window_width_);
-        if (!same_line) output_processed_.push_back("");
-        output_processed_.insert(output_processed_.end(), split_line.begin(), split_line.end());
     }
+    legacy_table_ = false;
+
+    for (uint32_t block = first_block; block * SAVE_BLOCK_LINES < end_line; block++)
+        save_block(save_db, block);
+    lines_saved_ = end_line;
 }
 
-// Saves the message log to disk.
-void MessageLog::save(std::shared_ptr<SQLite::Database> save_db)
+// Compresses and saves a single block of messages.
+void MessageLog::save_block(std::shared_ptr<SQLite::Database> save_db, uint32_t block)
 {
-    for (unsigned int i = 0; i < output_raw_.size(); i++)
+    const uint32_t raw_first_line = lines_trimmed_ + archived_lines();
+    const uint32_t first_line = std::max(block * SAVE_BLOCK_LINES, raw_first_line);
+    const uint32_t end_line = std::min<uint32_t>((block + 1) * SAVE_BLOCK_LINES, raw_first_line + output_raw_.size());
+    if (first_line >= end_line) return;
+
+    std::string text;
+    for (uint32_t line = first_line; line < end_line; line++)
     {
-        SQLite::Statement query(*save_db, "INSERT INTO msglog ( line, text ) VALUES ( :line, :text )");
-        query.bind(":line", i);
-        query.bind(":text", output_raw_.at(i));
-        query.exec();
+        if (line > first_line) text += '\0';
+        text += output_raw_.at(line - raw_first_line);
     }
+    std::vector<unsigned char> data;
+    const unsigned int error = lodepng::compress(data, reinterpret_cast<const unsigned char*>(text.data()), text.size());
+    if (error) throw std::runtime_error("Could not compress message log: " + std::string(lodepng_error_text(error)));
+
+    SQLite::Statement &query = core()->sql_statement(save_db, "INSERT OR REPLACE INTO msglog_blocks ( block, data, first_line, lines ) VALUES ( :block, :data, :first_line, :lines )");
+    query.bind(":block", block);
+    query.bind(":data", data.data(), data.size());
+    query.bind(":first_line", first_line);
+    query.bind(":lines", end_line - first_line);
+    query.exec();
 }
 
 // Scrolls the scrollbar to the given position.
@@ -282,3 +447,40 @@ void MessageLog::scroll_to_pixel(int pixel_y)
     const float factor = pixel_y / (static_cast<float>(output_window_height_) * core()->terminal()->cell_height());
     offset_ = std::max<int>(1, std::min<int>(output_processed_.size() - output_window_height_, output_processed_.size() * factor));
 }
+
+// Drops the oldest messages once the log grows past its maximum size.
+void MessageLog::trim_log()
+{
+    // Archived blocks can only be dropped whole, so the log can run up to a block over its maximum size until they're all gone.
+    const unsigned int max_size = core()->prefs()->log_max_size;
+    while (archived_blocks_.size() && archived_lines() + output_raw_.size() - archived_blocks_.front().lines >= max_size)
+    {
+        lines_trimmed_ += archived_blocks_.front().lines;
+        archived_blocks_.pop_front();
+    }
+    if (archived_blocks_.size()) return;
+
+    while (output_raw_.size() > max_size)
+    {
+        output_raw_.pop_front();
+        lines_trimmed_++;
+        if (!output_line_counts_.size()) continue;
+        output_processed_.erase(output_processed_.begin(), output_processed_.begin() + output_line_counts_.front());
+        output_line_counts_.pop_front();
+    }
+}
+
+// Word-wraps a single raw message, including the blank line that separates it from the previous message.
+std::vector<std::string> MessageLog::wrap_message(const std::string &line) const
+{
+    bool same_line = false;
+    std::string wrap_line = line;
+    if (wrap_line.size() >= 3 && wrap_line.substr(0, 3) == "{0}")
+    {
+        wrap_line = wrap_line.substr(3);
+        same_line = true;
+    }
+    std::vector<std::string> wrapped = StrX::string_explode_colour(wrap_line, output_window_width_);
+    if (!same_line) wrapped.insert(wrapped.begin(), "");
+    return wrapped;
+}
@@ -7,6 +7,8 @@
 
 #include "3rdparty/SQLiteCpp/Database.h"
 
+#include <cstdint>
+#include <deque>
 #include <string>
 #include <vector>
 
@@ -24,23 +26,46 @@ public:
     void            load(std::shared_ptr<SQLite::Database> save_db);        // Loads the message log from disk.
     void            msg(std::string str);                                   // Adds a message to the log.
     std::string     render_message_log(bool accept_blank_input = false);    // Renders the message log, returns user input.
-    void            save(std::shared_ptr<SQLite::Database> save_db);        // Saves the message log to disk.
+    void            save(std::shared_ptr<SQLite::Database> save_db, bool in_place = false); // Saves the message log to disk, optionally only writing what changed since the last save.
 
 private:
+    struct ArchivedBlock
+    {
+        uint32_t                    block;      // The block number, which is the line number of its first message divided by SAVE_BLOCK_LINES.
+        std::vector<unsigned char>  data;       // The block's messages, separated by null characters and zlib-compressed.
+        uint32_t                    first_line; // The line number of the first message in this block.
+        uint32_t                    lines;      // The number of messages in this block.
+    };
+
+    static constexpr uint32_t   SAVE_BLOCK_LINES =  100;    // How many lines of the message log are compressed together into each block when saving.
+
+    void            append_processed(const std::string &line);  // Word-wraps a single raw message and appends it to the processed output.
+    uint32_t        archived_lines() const;                 // The number of messages still compressed in archived blocks.
     void            clear_messages();                       // Clears the message log.
     void            recalc_window_sizes();                  // Recalculates the size and coordinates of the windows.
     void            reprocess_output();                     // Reprocesses the raw output to fit into the message window.
+    size_t          restore_block();                        // Decodes the newest archived block, adding its messages to the start of the log. Returns the number of processed lines added.
+    void            save_block(std::shared_ptr<SQLite::Database> save_db, uint32_t block);  // Compresses and saves a single block of messages.
     void            scroll_to_pixel(int pixel_y);           // Scrolls the scrollbar to the given position.
+    void            trim_log();                             // Drops the oldest messages once the log grows past its maximum size.
+    std::vector<std::string>    wrap_message(const std::string &line) const;    // Word-wraps a single raw message, including the blank line that separates it from the previous message.
+
+    std::deque<ArchivedBlock>   archived_blocks_;           // Older blocks of loaded messages, still compressed, which are only decoded if the player scrolls back to them.
 
     bool                        dragging_scrollbar_;        // Is the player currently dragging the scrollbar?
     int                         dragging_scrollbar_offset_; // Used to calculate movement when dragging the scrollbar.
-    std::vector<std::string>    output_processed_;          // Processed messages, word-wrapped to fit on the screen.
-    std::vector<std::string>    output_raw_;                // Unprocessed messages, which have not yet been word-wrapped to fit on the screen.
+    std::deque<size_t>          output_line_counts_;        // How many processed lines each raw message was word-wrapped into.
+    std::deque<std::string>     output_processed_;          // Processed messages, word-wrapped to fit on the screen.
+    unsigned int                output_processed_width_;    // The window width that the processed messages were word-wrapped to.
+    std::deque<std::string>     output_raw_;                // Unprocessed messages, which have not yet been word-wrapped to fit on the screen.
     std::string                 input_buffer_;              // The input buffer, where the player enters commands.
     unsigned int                input_window_width_;        // The width of the input window.
     unsigned int                input_window_x_;            // The X coordinate of the input window.
     unsigned int                input_window_y_;            // The Y coordinate of the input window.
     std::string                 last_input_;                // The last input entered by the player.
+    bool                        legacy_table_;              // Was the message log loaded from an older save file, with one row per line?
+    uint32_t                    lines_saved_;               // The line number that the next unsaved message will be written to in the save file.
+    uint32_t                    lines_trimmed_;             // How many messages have been trimmed from the start of the log; the line number of the oldest message.
     int                         offset_;                    // Used for scrolling the text in the output window.
     unsigned int                output_window_height_;      // The height of the output window.
     unsigned int                output_window_width_;       // The width of the output window.
@@ -53,9 +53,12 @@ Parser::Parser() : special_state_(SpecialState::NONE)
     add_command("[north|n|east|e|south|s|west|w|northeast|ne|northwest|nw|southeast|se|southwest|sw|up|u|down|d]", ParserCommand::DIRECTION);
     add_command("open <dir>", ParserCommand::OPEN);
     add_command("participate", ParserCommand::PARTICIPATE);
+    add_command("[quickload|ql]", ParserCommand::QUICKLOAD);
     add_command("[quickroll|qr]", ParserCommand::QUICK_ROLL);
+    add_command("[quicksave|qs]", ParserCommand::QUICKSAVE);
     add_command("[quit|exit]", ParserCommand::QUIT);
     add_command("[rapidstrike|rs] <mobile>", ParserCommand::RAPID_STRIKE);
+    add_command("rewind <txt>", ParserCommand::REWIND);
     add_command("save", ParserCommand::SAVE);
     add_command("[sa|sb|sd]", ParserCommand::STANCE);
     add_command("[score|sc]", ParserCommand::SCORE);
@@ -281,10 +284,10 @@ Parser::ParserSearchResult Parser::parse_target(std::vector<std::string> input,
     }
 
     // Mobiles in the player's room.
-    for (size_t i = 0; i < world->mob_count(); i++)
+    for (auto i : world->mobs_in_room(player_location))
     {
         const std::shared_ptr<Mobile> mob = world->mob_vec(i);
-        if (mob->location() == player_location) candidates.push_back({0, StrX::str_tolower(mob->name(Mobile::NAME_FLAG_NO_COLOUR)), "", mob->parser_id(), i, 0, ParserTarget::TARGET_MOBILE, count});
+        candidates.push_back({0, StrX::str_tolower(mob->name(Mobile::NAME_FLAG_NO_COLOUR)), "", mob->parser_id(), i, 0, ParserTarget::TARGET_MOBILE, count});
     }
 
     // Score each candidate.
@@ -427,7 +430,7 @@ void Parser::parse_pcd(const std::string &first_word, const std::vector<std::str
                     uint32_t target_id = player->mob_target();
                     if (!target_id) continue;
 
-                    for (size_t i = 0; i < world->mob_count(); i++)
+                    for (auto i : world->mobs_in_room(player->location()))
                     {
                         const auto mob = world->mob_vec(i);
                         if (mob->id() == target_id)
@@ -597,6 +600,8 @@ void Parser::parse_pcd(const std::string &first_word, const std::vector<std::str
             break;
         case ParserCommand::PARTICIPATE: Arena::participate(); break;
         case ParserCommand::QUICK_ROLL: Abilities::quick_roll(confirm); break;
+        case ParserCommand::QUICKLOAD: core()->quickload(); break;
+        case ParserCommand::QUICKSAVE: core()->quicksave(); break;
         case ParserCommand::QUIT:
             core()->message("{R}Are you sure you want to quit? {M}Your game will not be saved. {R}Type {C}yes {R}to confirm.");
             special_state_ = SpecialState::QUIT_CONFIRM;
@@ -606,6 +611,12 @@ void Parser::parse_pcd(const std::string &first_word, const std::vector<std::str
             else if (!words.size()) specify("rapidstrike");
             else if (parsed_target_type == ParserTarget::TARGET_NONE) not_here();
             break;
+        case ParserCommand::REWIND:
+            if (!words.size()) core()->rewind(1);
+            else if (words.at(0) == "list") core()->rewind_list();
+            else if (StrX::is_number(words.at(0))) core()->rewind(parse_int(words.at(0)));
+            else core()->message("{y}Please specify {Y}how many actions {y}to rewind, or type {Y}REWIND LIST {y}to see them.");
+            break;
         case ParserCommand::SAVE: core()->save(); break;
         case ParserCommand::SCORE: ActionStatus::score(); break;
         case ParserCommand::SELL:
@@ -680,6 +691,7 @@ void Parser::parse_pcd(const std::string &first_word, const std::vector<std::str
             {
                 if (pcd.command == ParserCommand::YES)
                 {
+                    core()->journal()->discard();   // The player chose not to keep anything since the last save.
                     core()->cleanup();
                     exit(EXIT_SUCCESS);
                 }
@@ -25,7 +25,7 @@ public:
     int32_t     parse_int(const std::string &s);        // Wrapper function to check for out of range values.
 
 private:
-    enum class ParserCommand : uint16_t { NONE, ABILITIES, ADD_MONEY, ATTACK, BROWSE, BUY, CAREFUL_AIM, CLOSE, COLOUR_TEST, DIRECTION, DRINK, DROP, EAT, EMPTY, EQUIP, EQUIPMENT, EXAMINE, EXCLAIM, EXITS, EYE_FOR_AN_EYE, FILL, GO, GRIT, HASH, HEADLONG_STRIKE, HEAL_CHEAT, HELP, INVENTORY, LADY_LUCK, LOCK, LOOK, MIXUP, MIXUP_BIG, NO, OPEN, PARTICIPATE, QUICK_ROLL, RAPID_STRIKE, SAVE, SCORE, SELL, SHIELD_WALL, SKILLS, SNAP_SHOT, SPAWN_ITEM, SPAWN_MOBILE, STANCE, STATUS, SWEAR, TAKE, TELEPORT, TIME, UNEQUIP, UNLOCK, VOMIT, WAIT, WEATHER, XYZZY, YES, QUIT };
+    enum class ParserCommand : uint16_t { NONE, ABILITIES, ADD_MONEY, ATTACK, BROWSE, BUY, CAREFUL_AIM, CLOSE, COLOUR_TEST, DIRECTION, DRINK, DROP, EAT, EMPTY, EQUIP, EQUIPMENT, EXAMINE, EXCLAIM, EXITS, EYE_FOR_AN_EYE, FILL, GO, GRIT, HASH, HEADLONG_STRIKE, HEAL_CHEAT, HELP, INVENTORY, LADY_LUCK, LOCK, LOOK, MIXUP, MIXUP_BIG, NO, OPEN, PARTICIPATE, QUICK_ROLL, QUICKLOAD, QUICKSAVE, RAPID_STRIKE, REWIND, SAVE, SCORE, SELL, SHIELD_WALL, SKILLS, SNAP_SHOT, SPAWN_ITEM, SPAWN_MOBILE, STANCE, STATUS, SWEAR, TAKE, TELEPORT, TIME, UNEQUIP, UNLOCK, VOMIT, WAIT, WEATHER, XYZZY, YES, QUIT };
     enum class SpecialState : uint8_t { NONE, QUIT_CONFIRM, DISAMBIGUATION };
 
     struct ParserCommandData
@@ -45,6 +45,7 @@ Prefs::Prefs()
             return yaml_pref[value].as<std::string>();
         };
 
+        autosave_interval = get_pref("autosave_interval");
         colour_black = get_pref_string("colour_black");
         colour_blue = get_pref_string("colour_blue");
         colour_blue_dark = get_pref_string("colour_blue_dark");
@@ -63,6 +64,8 @@ Prefs::Prefs()
         colour_yellow = get_pref_string("colour_yellow");
         colour_yellow_dark = get_pref_string("colour_yellow_dark");
         curses_custom_colours = get_pref_bool("curses_custom_colours");
+        data_cache = get_pref_bool("data_cache");
+        journal_size = get_pref("journal_size");
         log_max_size = get_pref("log_max_size");
         log_mouse_scroll_step = get_pref("log_mouse_scroll_step");
         log_padding_bottom = get_pref("log_padding_bottom");
@@ -70,7 +73,10 @@ Prefs::Prefs()
         log_padding_right = get_pref("log_padding_right");
         log_padding_top = get_pref("log_padding_top");
         monochrome_mode = get_pref_bool("monochrome_mode");
+        rewind_snapshots = get_pref("rewind_snapshots");
         save_file_slots = get_pref("save_file_slots");
+        save_profile = get_pref_string("save_profile");
+        if (save_profile != "durable" && save_profile != "fast") throw std::runtime_error("Invalid save_profile value in prefs.yml: " + save_profile);
     #ifdef GREAVE_TOLK
         screen_reader_external = get_pref_bool("screen_reader_external");
         screen_reader_process_square_brackets = get_pref_bool("screen_reader_process_square_brackets");
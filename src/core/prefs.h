@@ -12,6 +12,7 @@ class Prefs
 public:
                     Prefs();                // Constructor, loads data from prefs.yml
 
+    int         autosave_interval;      // How many minutes of real time to wait between autosaves, or 0 to disable autosaving.
     std::string colour_black;           // Hex colour definition for black.
     std::string colour_blue;            // Hex colour definition for bold blue.
     std::string colour_blue_dark;       // Hex colour definition for dark blue.
@@ -30,6 +31,8 @@ public:
     std::string colour_yellow;          // Hex colour definition for bold yellow.
     std::string colour_yellow_dark;     // Hex colour definition for dark yellow.
     bool        curses_custom_colours;  // Apply custom colour values above to Curses colours.
+    bool        data_cache;             // Keep a compiled copy of the game data in userdata/cache, so the data files only need to be parsed again when they change.
+    int         journal_size;           // How many actions to record in the crash-recovery journal before autosaving, or 0 to disable the journal.
     int         log_max_size;           // How many lines of text to keep in the message log?
     int         log_mouse_scroll_step;  // How many lines to scroll the window, when using the mouse-wheel.
     int         log_padding_bottom;     // The amount of black space below the message log window. (Must be at least 2, or the input box will be hidden.)
@@ -37,7 +40,9 @@ public:
     int         log_padding_right;      // The amount of black space to the right of the message log window.
     int         log_padding_top;        // The amount of black space above the message log window.
     bool        monochrome_mode;        // Set this to true to only use black/gray for the background and white for the text.
+    int         rewind_snapshots;       // How many recent actions can be undone with the REWIND command (including a fatal one), or 0 to disable rewinding.
     int         save_file_slots;        // The total amount of saved game slots available.
+    std::string save_profile;           // How saved games and the bones file are written: durable (synced, with a rollback journal) or fast (unsynced, journal kept in memory).
 #ifdef GREAVE_TOLK
     bool        screen_reader_external; // Enable automatic screen-reader support? Screen readers supported: JAWS, NVDA, SuperNova, System Access, Window-Eyes, ZoomText.
     bool        screen_reader_process_square_brackets;  // This setting can improve narration on screen readers for square brackets.
@@ -0,0 +1,163 @@
+// core/rewind.cc -- A bounded ring of in-memory snapshots of the game, so recent actions (even fatal ones) can be undone without going through a saved game.
+// Copyright (c) 2021 Raine "Gravecat" Simmons and the Greave contributors. Licensed under the GNU Affero General Public License v3 or any later version.
+
+#include "core/core.h"
+#include "core/rewind.h"
+#include "core/snapshot.h"
+#include "core/strx.h"
+
+#include <algorithm>
+
+
+// The message log isn't rewound, so it's left out of the snapshots.
+const std::vector<std::string> Rewind::SKIPPED_TABLES = { "msglog", "msglog_blocks" };
+
+
+// Adds a chunk to a snapshot, sharing the chunk from the snapshot before instead if it's exactly the same.
+void Rewind::add_chunk(Point &point, const std::string &table, int64_t block, std::vector<char> &&data, std::shared_ptr<const std::vector<char>> previous)
+{
+    point.blocks.push_back(std::make_pair(table, block));
+    point.size += data.size();
+    if (previous && *previous == data) point.chunks.push_back(previous);
+    else
+    {
+        point.unique_size += data.size();
+        point.chunks.push_back(std::make_shared<const std::vector<char>>(std::move(data)));
+    }
+}
+
+// The number of snapshots being kept, including the one of the game as it stands now.
+size_t Rewind::count() const { return points_.size(); }
+
+// Joins a snapshot's chunks back together, into snapshot data that can be decoded.
+std::vector<char> Rewind::data(const Point &point) const
+{
+    std::vector<char> result;
+    result.reserve(point.size);
+    for (auto chunk : point.chunks)
+        result.insert(result.end(), chunk->begin(), chunk->end());
+    return result;
+}
+
+// Takes a snapshot of the game after a command, unless nothing has changed since the last one. Only the rows changed since then are read again, unless the changes are unknown.
+void Rewind::record(SQLite::Database &save_db, const std::string &command, const pcg32 &rng, const std::map<std::string, std::set<int64_t>> *changes)
+{
+    const uint32_t max_points = core()->prefs()->rewind_snapshots;
+    if (!max_points) return;
+
+    Point point;
+    point.command = command;
+    point.rng = rng;
+    point.size = point.unique_size = 0;
+    if (changes && points_.size())
+    {
+        // Each table's schema is followed by its chunks of rows, in order of rowid. Only the chunks covering rows written since the last snapshot are encoded again; the rest are shared with it.
+        const Point &last = points_.back();
+        for (size_t i = 0; i < last.chunks.size();)
+        {
+            const std::string table = last.blocks.at(i).first;
+            share_chunk(point, last, i++);
+            if (!table.size()) continue;    // The snapshot header, or the indexes at the end.
+
+            std::map<int64_t, size_t> old_blocks;
+            for (; i < last.chunks.size() && last.blocks.at(i).first == table; i++)
+                old_blocks.insert(std::make_pair(last.blocks.at(i).second, i));
+            std::set<int64_t> changed_blocks, all_blocks;
+            const auto changed = changes->find(table);
+            if (changed != changes->end())
+            {
+                for (auto rowid : changed->second)
+                    changed_blocks.insert(Snapshot::block_of(rowid, CHUNK_ROWS));
+            }
+            all_blocks = changed_blocks;
+            for (auto block : old_blocks)
+                all_blocks.insert(block.first);
+
+            for (auto block : all_blocks)
+            {
+                const auto old_block = old_blocks.find(block);
+                if (!changed_blocks.count(block)) share_chunk(point, last, old_block->second);
+                else
+                {
+                    auto rows = Snapshot::encode_rows(save_db, table, CHUNK_ROWS, block * CHUNK_ROWS, block * CHUNK_ROWS + CHUNK_ROWS - 1);
+                    if (!rows.size()) continue; // Every row in this chunk has been deleted.
+                    add_chunk(point, table, block, std::move(rows.begin()->second), (old_block == old_blocks.end() ? nullptr : last.chunks.at(old_block->second)));
+                }
+            }
+        }
+    }
+    else
+    {
+        // Without a list of changes, the whole save is encoded, though chunks that haven't changed since the last snapshot can still be shared with it.
+        std::map<std::pair<std::string, int64_t>, std::shared_ptr<const std::vector<char>>> previous;
+        if (points_.size())
+        {
+            for (size_t i = 0; i < points_.back().chunks.size(); i++)
+                previous.insert(std::make_pair(points_.back().blocks.at(i), points_.back().chunks.at(i)));
+        }
+        auto previous_chunk = [&previous](const std::string &table, int64_t block) -> std::shared_ptr<const std::vector<char>>
+        {
+            const auto it = previous.find(std::make_pair(table, block));
+            return (it == previous.end() ? nullptr : it->second);
+        };
+
+        add_chunk(point, "", NO_BLOCK, Snapshot::encode_header(save_db), previous_chunk("", NO_BLOCK));
+        SQLite::Statement table_query(save_db, "SELECT name, sql FROM sqlite_master WHERE type = 'table' AND name NOT LIKE 'sqlite_%' ORDER BY name");
+        while (table_query.executeStep())
+        {
+            const std::string table = table_query.getColumn("name").getString();
+            if (std::find(SKIPPED_TABLES.begin(), SKIPPED_TABLES.end(), table) != SKIPPED_TABLES.end()) continue;
+            add_chunk(point, table, NO_BLOCK, Snapshot::encode_table(table, table_query.getColumn("sql").getString()), previous_chunk(table, NO_BLOCK));
+            for (auto &block : Snapshot::encode_rows(save_db, table, CHUNK_ROWS))
+                add_chunk(point, table, block.first, std::move(block.second), previous_chunk(table, block.first));
+        }
+        add_chunk(point, "", NO_BLOCK, Snapshot::encode_indexes(save_db), nullptr);
+    }
+
+    // Commands that don't change anything, like looking around, don't need a snapshot of their own.
+    if (points_.size() && point.chunks == points_.back().chunks && point.rng == points_.back().rng) return;
+    points_.push_back(point);
+    while (points_.size() > max_points + 1)
+        points_.pop_front();
+}
+
+// Lists the snapshots that can be rewound to, and how much memory each of them uses.
+void Rewind::report() const
+{
+    if (points_.size() < 2)
+    {
+        core()->message("{y}There is nothing to rewind yet.");
+        return;
+    }
+    core()->message("{U}Actions that can be rewound, most recent first:");
+    std::set<const std::vector<char>*> distinct;
+    size_t total = 0;
+    for (size_t steps = 1; steps < points_.size(); steps++)
+    {
+        const Point &point = points_.at(points_.size() - 1 - steps);
+        core()->message("{0}{U}[{C}" + std::to_string(steps) + "{U}] {W}" + points_.at(points_.size() - steps).command + " {U}(snapshot {C}" + StrX::intostr_pretty(point.size / 1024) + " KB{U}, {C}" +
+            StrX::intostr_pretty(point.unique_size / 1024) + " KB {U}not shared)");
+    }
+    for (auto &point : points_)
+    {
+        for (auto chunk : point.chunks)
+            if (distinct.insert(chunk.get()).second) total += chunk->size();
+    }
+    core()->message("{0}{U}All snapshots together use {C}" + StrX::intostr_pretty(total / 1024) + " KB{U}.");
+}
+
+// Adds an unchanged chunk from the snapshot before to a snapshot.
+void Rewind::share_chunk(Point &point, const Point &previous, size_t index)
+{
+    point.blocks.push_back(previous.blocks.at(index));
+    point.chunks.push_back(previous.chunks.at(index));
+    point.size += previous.chunks.at(index)->size();
+}
+
+// Drops the given number of snapshots from the end of the ring, and returns the one that is now the latest.
+Rewind::Point Rewind::rewind(uint32_t steps)
+{
+    if (!steps || steps >= points_.size()) throw std::runtime_error("Invalid rewind: " + std::to_string(steps) + " steps.");
+    points_.erase(points_.end() - steps, points_.end());
+    return points_.back();
+}
@@ -0,0 +1,51 @@
+// core/rewind.h -- A bounded ring of in-memory snapshots of the game, so recent actions (even fatal ones) can be undone without going through a saved game.
+// Copyright (c) 2021 Raine "Gravecat" Simmons and the Greave contributors. Licensed under the GNU Affero General Public License v3 or any later version.
+
+#ifndef GREAVE_CORE_REWIND_H_
+#define GREAVE_CORE_REWIND_H_
+
+#include "3rdparty/pcg/pcg_random.hpp"
+#include "3rdparty/SQLiteCpp/Database.h"
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+class Rewind
+{
+public:
+    struct Point
+    {
+        std::vector<std::pair<std::string, int64_t>>    blocks; // The table and block of rowids held by each chunk, so the chunks holding changed rows can be found in the next snapshot.
+        std::vector<std::shared_ptr<const std::vector<char>>> chunks;   // The snapshot data. Chunks are never changed once made, so unchanged chunks are shared with the snapshot before.
+        std::string command;        // The command that led to this snapshot.
+        pcg32       rng;            // The state of the random number generator.
+        size_t      size;           // The total size of the snapshot data, in bytes.
+        size_t      unique_size;    // How many bytes of the snapshot data aren't shared with the snapshot before.
+    };
+
+    static const std::vector<std::string> SKIPPED_TABLES;   // The message log isn't rewound, so it's left out of the snapshots.
+
+    size_t      count() const;                  // The number of snapshots being kept, including the one of the game as it stands now.
+    std::vector<char> data(const Point &point) const;       // Joins a snapshot's chunks back together, into snapshot data that can be decoded.
+    void        record(SQLite::Database &save_db, const std::string &command, const pcg32 &rng, const std::map<std::string, std::set<int64_t>> *changes);  // Takes a snapshot of the game after a command, unless nothing has changed since the last one. Only the rows changed since then are read again, unless the changes are unknown.
+    void        report() const;                 // Lists the snapshots that can be rewound to, and how much memory each of them uses.
+    Point       rewind(uint32_t steps);         // Drops the given number of snapshots from the end of the ring, and returns the one that is now the latest.
+
+private:
+    static constexpr int64_t    CHUNK_ROWS =    64;         // How many rowids each chunk of rows covers. Smaller chunks are shared more often, but each one has some overhead.
+    static constexpr int64_t    NO_BLOCK =      INT64_MIN;  // The block given to chunks that don't hold rows: the snapshot header, the indexes, and each table's schema.
+
+    static void add_chunk(Point &point, const std::string &table, int64_t block, std::vector<char> &&data, std::shared_ptr<const std::vector<char>> previous);    // Adds a chunk to a snapshot, sharing the chunk from the snapshot before instead if it's exactly the same.
+    static void share_chunk(Point &point, const Point &previous, size_t index); // Adds an unchanged chunk from the snapshot before to a snapshot.
+
+    std::deque<Point>   points_;                // The snapshots, oldest first. The last one is of the game as it stands now.
+};
+
+#endif  // GREAVE_CORE_REWIND_H_
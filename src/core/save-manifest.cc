@@ -0,0 +1,141 @@
+// core/save-manifest.cc -- A small summary of each saved game, so the title screen can describe the save slots without opening every save file.
+// Copyright (c) 2021 Raine "Gravecat" Simmons and the Greave contributors. Licensed under the GNU Affero General Public License v3 or any later version.
+
+#include "3rdparty/yaml-cpp/yaml.h"
+#include "core/core.h"
+#include "core/core-constants.h"
+#include "core/filex.h"
+#include "core/save-manifest.h"
+#include "core/strx.h"
+#include "world/player.h"
+#include "world/room.h"
+#include "world/time-weather.h"
+#include "world/world.h"
+
+#include <fstream>
+
+
+constexpr char SaveManifest::MANIFEST_FILENAME[] = "userdata/save/manifest.yml";
+
+
+// Builds a manifest entry for the game in progress. The file details are filled in when the entry is written.
+SaveManifest::Entry SaveManifest::describe()
+{
+    const auto world = core()->world();
+    const auto player = world->player();
+    const auto time_weather = world->time_weather();
+    Entry entry;
+    entry.date = time_weather->day_name() + ", the " + time_weather->day_of_month_string() + " day of " + time_weather->month_name();
+    entry.file_modified = 0;
+    entry.file_size = 0;
+    entry.location = world->get_room(player->location())->name();
+    entry.name = player->name();
+    entry.score = player->score();
+    entry.time_passed = time_weather->time_passed();
+    entry.version = CoreConstants::SAVE_VERSION;
+    return entry;
+}
+
+// Checks if a manifest entry still matches its save file.
+bool SaveManifest::is_current(const Entry &entry, const std::string &save_fn)
+{
+    // A save file that has been changed, replaced or restored from a backup since the manifest was written will almost certainly differ in one of these.
+    return (entry.file_modified && entry.file_modified == FileX::file_modified(save_fn) && entry.file_size == FileX::file_size(save_fn));
+}
+
+// Loads the manifest entries for all save slots. Returns an empty map if the manifest is missing or unreadable.
+std::map<int, SaveManifest::Entry> SaveManifest::load()
+{
+    std::map<int, Entry> entries;
+    if (!FileX::file_exists(MANIFEST_FILENAME)) return entries;
+    try
+    {
+        const YAML::Node yaml = YAML::LoadFile(MANIFEST_FILENAME);
+        for (auto slot : yaml)
+        {
+            const YAML::Node node = slot.second;
+            Entry entry;
+            entry.date = node["date"].as<std::string>();
+            entry.file_modified = node["file_modified"].as<int64_t>();
+            entry.file_size = node["file_size"].as<uint64_t>();
+            entry.location = node["location"].as<std::string>();
+            entry.name = node["name"].as<std::string>();
+            entry.score = node["score"].as<uint32_t>();
+            entry.time_passed = node["time_passed"].as<uint32_t>();
+            entry.version = node["version"].as<uint32_t>();
+            entries.insert({slot.first.as<int>(), entry});
+        }
+    }
+    catch (std::exception&)
+    {
+        // The manifest is only a shortcut; if it can't be read, the title screen just checks the save files themselves.
+        entries.clear();
+    }
+    return entries;
+}
+
+// Removes the manifest entry for a save slot, after its save file has been deleted.
+void SaveManifest::remove(int slot)
+{
+    std::map<int, Entry> entries = load();
+    if (!entries.erase(slot)) return;
+    if (entries.size()) write(entries);
+    else FileX::delete_file(MANIFEST_FILENAME);
+}
+
+// Describes a manifest entry for the title screen.
+std::string SaveManifest::summary(const Entry &entry)
+{
+    const uint32_t day = entry.time_passed / 86400 + 1;
+    std::string summary = "{C}" + entry.name + " {U}in {W}" + entry.location + "{U}, day {W}" + std::to_string(day) + " {U}(" + entry.date + ")";
+    if (entry.score) summary += ", score {W}" + StrX::intostr_pretty(entry.score);
+    return summary;
+}
+
+// Updates the manifest entry for a save slot, after its save file has been written. Runs on the save thread, so it can't touch the game state.
+void SaveManifest::update(int slot, Entry entry, const std::string &save_fn)
+{
+    entry.file_modified = FileX::file_modified(save_fn);
+    entry.file_size = FileX::file_size(save_fn);
+    std::map<int, Entry> entries = load();
+
+    // Entries for save files that have since been deleted are dropped along the way.
+    for (auto it = entries.begin(); it != entries.end(); )
+    {
+        if (it->first != slot && !is_current(it->second, core()->save_filename(it->first))) it = entries.erase(it);
+        else ++it;
+    }
+    entries[slot] = entry;
+    write(entries);
+}
+
+// Writes the manifest file.
+void SaveManifest::write(const std::map<int, Entry> &entries)
+{
+    YAML::Emitter yaml;
+    yaml << YAML::BeginMap;
+    for (auto &slot_entry : entries)
+    {
+        const Entry &e = slot_entry.second;
+        yaml << YAML::Key << slot_entry.first << YAML::Value << YAML::BeginMap;
+        yaml << YAML::Key << "date" << YAML::Value << e.date;
+        yaml << YAML::Key << "file_modified" << YAML::Value << e.file_modified;
+        yaml << YAML::Key << "file_size" << YAML::Value << e.file_size;
+        yaml << YAML::Key << "location" << YAML::Value << e.location;
+        yaml << YAML::Key << "name" << YAML::Value << e.name;
+        yaml << YAML::Key << "score" << YAML::Value << e.score;
+        yaml << YAML::Key << "time_passed" << YAML::Value << e.time_passed;
+        yaml << YAML::Key << "version" << YAML::Value << e.version;
+        yaml << YAML::EndMap;
+    }
+    yaml << YAML::EndMap;
+
+    // Write to a temporary file first, so an interrupted write can't leave a half-written manifest behind.
+    const std::string temp_fn = std::string(MANIFEST_FILENAME) + ".tmp";
+    std::ofstream manifest_file(temp_fn);
+    manifest_file << yaml.c_str() << std::endl;
+    manifest_file.close();
+    if (!manifest_file.good()) throw std::runtime_error("Could not write save manifest.");
+    if (FileX::file_exists(MANIFEST_FILENAME)) FileX::delete_file(MANIFEST_FILENAME);
+    FileX::rename_file(temp_fn, MANIFEST_FILENAME);
+}
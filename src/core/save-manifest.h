@@ -0,0 +1,40 @@
+// core/save-manifest.h -- A small summary of each saved game, so the title screen can describe the save slots without opening every save file.
+// Copyright (c) 2021 Raine "Gravecat" Simmons and the Greave contributors. Licensed under the GNU Affero General Public License v3 or any later version.
+
+#ifndef GREAVE_CORE_SAVE_MANIFEST_H_
+#define GREAVE_CORE_SAVE_MANIFEST_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+
+class SaveManifest
+{
+public:
+    struct Entry
+    {
+        std::string date;           // The in-game date when the game was saved.
+        int64_t     file_modified;  // The save file's modification time when this entry was written.
+        uint64_t    file_size;      // The save file's size when this entry was written.
+        std::string location;       // The name of the Room the player was in.
+        std::string name;           // The player character's name.
+        uint32_t    score;          // The player's score.
+        uint32_t    time_passed;    // The total seconds of game time that have passed.
+        uint32_t    version;        // The saved game version.
+    };
+
+    static Entry        describe();         // Builds a manifest entry for the game in progress. The file details are filled in when the entry is written.
+    static bool         is_current(const Entry &entry, const std::string &save_fn);     // Checks if a manifest entry still matches its save file.
+    static std::map<int, Entry> load();     // Loads the manifest entries for all save slots. Returns an empty map if the manifest is missing or unreadable.
+    static void         remove(int slot);   // Removes the manifest entry for a save slot, after its save file has been deleted.
+    static std::string  summary(const Entry &entry);    // Describes a manifest entry for the title screen.
+    static void         update(int slot, Entry entry, const std::string &save_fn);  // Updates the manifest entry for a save slot, after its save file has been written. Runs on the save thread, so it can't touch the game state.
+
+private:
+    static const char   MANIFEST_FILENAME[];    // The filename for the save manifest.
+
+    static void         write(const std::map<int, Entry> &entries); // Writes the manifest file.
+};
+
+#endif  // GREAVE_CORE_SAVE_MANIFEST_H_
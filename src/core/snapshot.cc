@@ -0,0 +1,489 @@
+// core/snapshot.cc -- A compact binary copy of a saved game, used for quicksaves. It can be converted to and from the SQLite save file format, which remains the canonical format.
+// Copyright (c) 2021 Raine "Gravecat" Simmons and the Greave contributors. Licensed under the GNU Affero General Public License v3 or any later version.
+
+#include "3rdparty/LodePNG/lodepng.h"
+#include "3rdparty/SQLiteCpp/Backup.h"
+#include "3rdparty/SQLiteCpp/Statement.h"
+#include "3rdparty/SQLiteCpp/Transaction.h"
+#include "3rdparty/sqlite3/sqlite3.h"
+#include "core/core.h"
+#include "core/filex.h"
+#include "core/snapshot.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+
+// The identifier at the start of every snapshot file. It's followed by the snapshot format version and the saved game version, then the records, then a CRC32 of everything before it.
+// Each record is a type byte, then the length of its contents as a variable-length integer, then the contents.
+const char Snapshot::SNAPSHOT_HEADER[] = "GREAVE SNAPSHOT";
+
+
+// Adds a length-prefixed record to the snapshot data.
+void Snapshot::add_record(std::vector<char> &data, Record type, const std::vector<char> &payload)
+{
+    data.push_back(static_cast<char>(type));
+    put_varint(data, payload.size());
+    data.insert(data.end(), payload.begin(), payload.end());
+}
+
+// Applies a set of changes from encode_changes() to an SQLite save file, in a single transaction.
+void Snapshot::apply_changes(SQLite::Database &save_db, const std::vector<char> &data)
+{
+    const std::string source = "Saved game change set";
+    SQLite::Transaction transaction(save_db);
+    std::string table;
+    std::unique_ptr<sqlite3_stmt, decltype(&sqlite3_finalize)> insert(nullptr, &sqlite3_finalize);
+    uint64_t insert_columns = 0;
+    size_t pos = 0;
+    while (true)
+    {
+        if (pos >= data.size()) throw std::runtime_error(source + " is truncated.");
+        const Record type = static_cast<Record>(data[pos++]);
+        const uint64_t length = get_varint(data, pos, data.size());
+        if (data.size() - pos < length) throw std::runtime_error(source + " is truncated.");
+        const size_t record_end = pos + length;
+        switch (type)
+        {
+            case Record::END:
+                transaction.commit();
+                return;
+            case Record::TABLE:
+            {
+                // The rows are written back with the same rowids, so that later changes to them can find them again.
+                table = std::string(data.begin() + pos, data.begin() + record_end);
+                sqlite3_stmt *stmt = nullptr;
+                if (sqlite3_prepare_v2(save_db.getHandle(), ("SELECT * FROM \"" + table + "\"").c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+                    throw std::runtime_error("Could not update table " + table + ": " + std::string(sqlite3_errmsg(save_db.getHandle())));
+                insert.reset(stmt);
+                insert_columns = sqlite3_column_count(stmt) + 1;
+                std::string sql = "INSERT INTO \"" + table + "\" ( rowid", values = "?";
+                for (uint64_t i = 0; i + 1 < insert_columns; i++)
+                {
+                    sql += ", \"" + std::string(sqlite3_column_name(stmt, i)) + "\"";
+                    values += ", ?";
+                }
+                sql += " ) VALUES ( " + values + " )";
+                insert.reset();
+                if (sqlite3_prepare_v2(save_db.getHandle(), sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+                    throw std::runtime_error("Could not update table " + table + ": " + std::string(sqlite3_errmsg(save_db.getHandle())));
+                insert.reset(stmt);
+                break;
+            }
+            case Record::DELETE:
+            {
+                // Every changed row is deleted first, then the ones which still exist are written again, so unique columns never clash part-way through.
+                if (!table.size()) throw std::runtime_error(source + " is damaged (deletion outside of any table).");
+                sqlite3_stmt *stmt = nullptr;
+                if (sqlite3_prepare_v2(save_db.getHandle(), ("DELETE FROM \"" + table + "\" WHERE rowid = ?").c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+                    throw std::runtime_error("Could not update table " + table + ": " + std::string(sqlite3_errmsg(save_db.getHandle())));
+                const std::unique_ptr<sqlite3_stmt, decltype(&sqlite3_finalize)> delete_query(stmt, &sqlite3_finalize);
+                const uint64_t rows = get_varint(data, pos, record_end);
+                for (uint64_t i = 0; i < rows; i++)
+                {
+                    sqlite3_reset(stmt);
+                    sqlite3_bind_int64(stmt, 1, static_cast<int64_t>(get_varint(data, pos, record_end)));
+                    if (sqlite3_step(stmt) != SQLITE_DONE) throw std::runtime_error("Could not update table " + table + ": " + std::string(sqlite3_errmsg(save_db.getHandle())));
+                }
+                break;
+            }
+            case Record::ROW:
+            {
+                const uint64_t columns = get_varint(data, pos, record_end);
+                if (!insert) throw std::runtime_error(source + " is damaged (row outside of any table).");
+                if (columns != insert_columns) throw std::runtime_error(source + " does not match table " + table + ".");
+                sqlite3_reset(insert.get());
+                bind_row(insert.get(), data, pos, record_end, columns, source);
+                if (sqlite3_step(insert.get()) != SQLITE_DONE) throw std::runtime_error("Could not update table " + table + ": " + std::string(sqlite3_errmsg(save_db.getHandle())));
+                break;
+            }
+            default: throw std::runtime_error(source + " is damaged (unknown record type).");
+        }
+        pos = record_end;
+    }
+}
+
+// Binds the values of a ROW record to a prepared statement, throwing an exception if the record is damaged.
+void Snapshot::bind_row(sqlite3_stmt *stmt, const std::vector<char> &data, size_t &pos, size_t end, uint64_t columns, const std::string &source)
+{
+    for (int i = 1; i <= static_cast<int>(columns); i++)
+    {
+        if (pos >= end) throw std::runtime_error(source + " is damaged (row too short).");
+        const Value value_type = static_cast<Value>(data[pos++]);
+        switch (value_type)
+        {
+            case Value::NONE: sqlite3_bind_null(stmt, i); break;
+            case Value::INTEGER:
+            {
+                const uint64_t zigzag = get_varint(data, pos, end);
+                sqlite3_bind_int64(stmt, i, static_cast<int64_t>((zigzag >> 1) ^ (~(zigzag & 1) + 1)));
+                break;
+            }
+            case Value::REAL:
+            {
+                if (end - pos < 8) throw std::runtime_error(source + " is damaged (row too short).");
+                const uint64_t low = get_u32(data, pos);
+                const uint64_t bits = low | (static_cast<uint64_t>(get_u32(data, pos)) << 32);
+                double real;
+                std::memcpy(&real, &bits, sizeof(real));
+                sqlite3_bind_double(stmt, i, real);
+                break;
+            }
+            case Value::TEXT: case Value::BLOB:
+            {
+                const uint64_t size = get_varint(data, pos, end);
+                if (end - pos < size) throw std::runtime_error(source + " is damaged (value runs past the end of its row).");
+                if (value_type == Value::TEXT) sqlite3_bind_text(stmt, i, data.data() + pos, size, SQLITE_STATIC);
+                else sqlite3_bind_blob(stmt, i, data.data() + pos, size, SQLITE_STATIC);
+                pos += size;
+                break;
+            }
+            default: throw std::runtime_error(source + " is damaged (unknown value type).");
+        }
+    }
+}
+
+// Returns which block of rowids a rowid falls into, as used by encode_rows().
+int64_t Snapshot::block_of(int64_t rowid, int64_t block_size) { return rowid / block_size - (rowid % block_size < 0 ? 1 : 0); }
+
+// Converts a snapshot file into an SQLite save file, or the other way around, writing the result alongside the original.
+void Snapshot::convert(const std::string &filename)
+{
+    const size_t dot = filename.find_last_of('.');
+    const std::string extension = (dot == std::string::npos ? "" : filename.substr(dot));
+    if (extension != ".quick" && extension != ".sqlite") throw std::runtime_error("Cannot convert " + filename + ": expected a .quick or .sqlite file.");
+    const std::string target = filename.substr(0, dot) + (extension == ".quick" ? ".sqlite" : ".quick");
+    if (!FileX::file_exists(filename)) throw std::runtime_error("Cannot convert " + filename + ": file not found.");
+    if (FileX::file_exists(target)) throw std::runtime_error("Cannot convert " + filename + ": " + target + " already exists.");
+
+    if (extension == ".sqlite")
+    {
+        SQLite::Database save_db(filename, SQLite::OPEN_READONLY);
+        from_sqlite(save_db, target);
+    }
+    else
+    {
+        const auto save_db = to_sqlite(filename);
+        SQLite::Database file_db(target, SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
+        core()->sql_profile(file_db);
+        SQLite::Backup backup(file_db, *save_db);
+        backup.executeStep();
+    }
+    core()->guru()->log("Converted " + filename + " to " + target);
+}
+
+// Records the current contents of some rows of an SQLite save file, by table and rowid, so they can be copied to another copy of the file. Rows which no longer exist are recorded as deleted.
+std::vector<char> Snapshot::encode_changes(SQLite::Database &save_db, const std::map<std::string, std::set<int64_t>> &rowids)
+{
+    std::vector<char> data, payload;
+    for (const auto &table : rowids)
+    {
+        if (!table.second.size()) continue;
+        add_record(data, Record::TABLE, std::vector<char>(table.first.begin(), table.first.end()));
+        payload.clear();
+        put_varint(payload, table.second.size());
+        for (int64_t rowid : table.second)
+            put_varint(payload, static_cast<uint64_t>(rowid));
+        add_record(data, Record::DELETE, payload);
+
+        sqlite3_stmt *stmt = nullptr;
+        if (sqlite3_prepare_v2(save_db.getHandle(), ("SELECT rowid, * FROM \"" + table.first + "\" WHERE rowid = ?").c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+            throw std::runtime_error("Could not read table " + table.first + ": " + std::string(sqlite3_errmsg(save_db.getHandle())));
+        const std::unique_ptr<sqlite3_stmt, decltype(&sqlite3_finalize)> row_query(stmt, &sqlite3_finalize);
+        for (int64_t rowid : table.second)
+        {
+            sqlite3_reset(stmt);
+            sqlite3_bind_int64(stmt, 1, rowid);
+            const int result = sqlite3_step(stmt);
+            if (result == SQLITE_DONE) continue;
+            if (result != SQLITE_ROW) throw std::runtime_error("Could not read table " + table.first + ": " + std::string(sqlite3_errmsg(save_db.getHandle())));
+            payload.clear();
+            put_row(payload, stmt);
+            add_record(data, Record::ROW, payload);
+        }
+    }
+    add_record(data, Record::END, std::vector<char>());
+    return data;
+}
+
+// The start of the snapshot data, which identifies the format and the saved game version.
+std::vector<char> Snapshot::encode_header(SQLite::Database &save_db)
+{
+    std::vector<char> data;
+    put_bytes(data, SNAPSHOT_HEADER, sizeof(SNAPSHOT_HEADER));
+    put_u32(data, SNAPSHOT_VERSION);
+    put_u32(data, save_db.execAndGet("PRAGMA user_version").getUInt());
+    return data;
+}
+
+// The end of the snapshot data: the indexes, which are only built once every table's rows are in.
+std::vector<char> Snapshot::encode_indexes(SQLite::Database &save_db)
+{
+    std::vector<char> data;
+    SQLite::Statement index_query(save_db, "SELECT sql FROM sqlite_master WHERE type = 'index' AND sql IS NOT NULL ORDER BY name");
+    while (index_query.executeStep())
+    {
+        const std::string schema = index_query.getColumn("sql").getString();
+        add_record(data, Record::SCHEMA, std::vector<char>(schema.begin(), schema.end()));
+    }
+    add_record(data, Record::END, std::vector<char>());
+    return data;
+}
+
+// Converts the rows of a table with rowids in the given range into snapshot data, in rowid order, split into blocks of rowids of the given size.
+std::map<int64_t, std::vector<char>> Snapshot::encode_rows(SQLite::Database &save_db, const std::string &table, int64_t block_size, int64_t first_rowid, int64_t last_rowid)
+{
+    // The rows are read with the SQLite C API, as every column of every row passes through here, and SQLiteCpp's per-column overhead adds up.
+    sqlite3_stmt *stmt = nullptr;
+    if (sqlite3_prepare_v2(save_db.getHandle(), ("SELECT rowid, * FROM \"" + table + "\" WHERE rowid BETWEEN ? AND ? ORDER BY rowid").c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+        throw std::runtime_error("Could not read table " + table + ": " + std::string(sqlite3_errmsg(save_db.getHandle())));
+    const std::unique_ptr<sqlite3_stmt, decltype(&sqlite3_finalize)> row_query(stmt, &sqlite3_finalize);
+    sqlite3_bind_int64(stmt, 1, first_rowid);
+    sqlite3_bind_int64(stmt, 2, last_rowid);
+
+    std::map<int64_t, std::vector<char>> blocks;
+    std::vector<char> *block = nullptr;
+    int64_t block_number = 0;
+    std::vector<char> payload;
+    int result;
+    while ((result = sqlite3_step(stmt)) == SQLITE_ROW)
+    {
+        const int64_t row_block = block_of(sqlite3_column_int64(stmt, 0), block_size);
+        if (!block || row_block != block_number)
+        {
+            block = &blocks[row_block];
+            block_number = row_block;
+        }
+        payload.clear();
+        put_row(payload, stmt, 1);
+        add_record(*block, Record::ROW, payload);
+    }
+    if (result != SQLITE_DONE) throw std::runtime_error("Could not read table " + table + ": " + std::string(sqlite3_errmsg(save_db.getHandle())));
+    return blocks;
+}
+
+// The schema of a table, which comes before its rows in the snapshot data.
+std::vector<char> Snapshot::encode_table(const std::string &table, const std::string &schema)
+{
+    std::vector<char> data;
+    add_record(data, Record::SCHEMA, std::vector<char>(schema.begin(), schema.end()));
+    add_record(data, Record::TABLE, std::vector<char>(table.begin(), table.end()));
+    return data;
+}
+
+// Returns the quicksave snapshot filename for a save slot.
+std::string Snapshot::filename(int slot) { return "userdata/save/save-" + std::to_string(slot) + ".quick"; }
+
+// Reads snapshot data, without its checksum, into a new in-memory SQLite database.
+std::shared_ptr<SQLite::Database> Snapshot::decode(const std::vector<char> &data, const std::string &source)
+{
+    const size_t header_size = sizeof(SNAPSHOT_HEADER);
+    if (data.size() < header_size + 8 || std::memcmp(data.data(), SNAPSHOT_HEADER, header_size)) throw std::runtime_error(source + " is not a snapshot.");
+    size_t pos = header_size;
+    const uint32_t snapshot_version = get_u32(data, pos);
+    if (snapshot_version != SNAPSHOT_VERSION) throw std::runtime_error(source + " uses an unsupported format version (" + std::to_string(snapshot_version) + ").");
+    const uint32_t save_version = get_u32(data, pos);
+
+    auto save_db = std::make_shared<SQLite::Database>(":memory:", SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
+    core()->sql_profile(*save_db);  // The page size is copied over to the file on disk, if this is converted or saved.
+    save_db->exec("PRAGMA user_version = " + std::to_string(save_version));
+    SQLite::Transaction transaction(*save_db);
+    std::string table;
+    std::unique_ptr<sqlite3_stmt, decltype(&sqlite3_finalize)> insert(nullptr, &sqlite3_finalize);
+    uint64_t insert_columns = 0;
+    while (true)
+    {
+        if (pos >= data.size()) throw std::runtime_error(source + " is truncated.");
+        const Record type = static_cast<Record>(data[pos++]);
+        const uint64_t length = get_varint(data, pos, data.size());
+        if (data.size() - pos < length) throw std::runtime_error(source + " is truncated.");
+        const size_t record_end = pos + length;
+        switch (type)
+        {
+            case Record::END:
+                transaction.commit();
+                return save_db;
+            case Record::SCHEMA:
+                save_db->exec(std::string(data.begin() + pos, data.begin() + record_end));
+                break;
+            case Record::TABLE:
+                table = std::string(data.begin() + pos, data.begin() + record_end);
+                insert.reset();
+                break;
+            case Record::ROW:
+            {
+                const uint64_t columns = get_varint(data, pos, record_end);
+                if (!table.size() || !columns) throw std::runtime_error(source + " is damaged (row outside of any table).");
+                if (!insert || insert_columns != columns)
+                {
+                    std::string sql = "INSERT INTO \"" + table + "\" VALUES (?";
+                    for (uint64_t i = 1; i < columns; i++)
+                        sql += ", ?";
+                    sql += ")";
+                    sqlite3_stmt *stmt = nullptr;
+                    if (sqlite3_prepare_v2(save_db->getHandle(), sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+                        throw std::runtime_error("Could not restore table " + table + ": " + std::string(sqlite3_errmsg(save_db->getHandle())));
+                    insert.reset(stmt);
+                    insert_columns = columns;
+                }
+                else sqlite3_reset(insert.get());
+
+                bind_row(insert.get(), data, pos, record_end, columns, source);
+                if (sqlite3_step(insert.get()) != SQLITE_DONE) throw std::runtime_error("Could not restore table " + table + ": " + std::string(sqlite3_errmsg(save_db->getHandle())));
+                break;
+            }
+            default: throw std::runtime_error(source + " is damaged (unknown record type).");
+        }
+        pos = record_end;
+    }
+}
+
+// Converts the contents of an SQLite save file into snapshot data, without a checksum.
+std::vector<char> Snapshot::encode(SQLite::Database &save_db)
+{
+    // Each table is stored as its schema, followed by its rows in their original order. Indexes come last, so they're only built once the rows are in.
+    std::vector<char> data = encode_header(save_db);
+    SQLite::Statement table_query(save_db, "SELECT name, sql FROM sqlite_master WHERE type = 'table' AND name NOT LIKE 'sqlite_%' ORDER BY name");
+    while (table_query.executeStep())
+    {
+        const std::string table = table_query.getColumn("name").getString();
+        const std::vector<char> schema = encode_table(table, table_query.getColumn("sql").getString());
+        data.insert(data.end(), schema.begin(), schema.end());
+        for (const auto &block : encode_rows(save_db, table, INT64_MAX))
+            data.insert(data.end(), block.second.begin(), block.second.end());
+    }
+    const std::vector<char> indexes = encode_indexes(save_db);
+    data.insert(data.end(), indexes.begin(), indexes.end());
+    return data;
+}
+
+// Writes the contents of an SQLite save file to a snapshot file.
+void Snapshot::from_sqlite(SQLite::Database &save_db, const std::string &filename)
+{
+    std::vector<char> data = encode(save_db);
+    put_u32(data, lodepng_crc32(reinterpret_cast<const unsigned char*>(data.data()), data.size()));
+
+    // The snapshot is written to a temporary file first, so a failed write never replaces a good snapshot.
+    const std::string temp_fn = filename + ".tmp";
+    std::ofstream temp_file(temp_fn, std::ios::binary | std::ios::trunc);
+    temp_file.write(data.data(), data.size());
+    temp_file.close();
+    if (!temp_file.good())
+    {
+        if (FileX::file_exists(temp_fn)) FileX::delete_file(temp_fn);
+        throw std::runtime_error("Could not write snapshot file " + filename);
+    }
+    if (FileX::file_exists(filename)) FileX::delete_file(filename);
+    FileX::rename_file(temp_fn, filename);
+}
+
+// Reads a 32-bit integer from a snapshot buffer, throwing an exception if the buffer is too short.
+uint32_t Snapshot::get_u32(const std::vector<char> &data, size_t &pos)
+{
+    if (data.size() - pos < 4) throw std::runtime_error("Snapshot file is truncated.");
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++)
+        value |= static_cast<uint32_t>(static_cast<unsigned char>(data[pos++])) << (i * 8);
+    return value;
+}
+
+// Reads a variable-length integer from a snapshot buffer, throwing an exception if it runs past the end.
+uint64_t Snapshot::get_varint(const std::vector<char> &data, size_t &pos, size_t end)
+{
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        if (pos >= end) throw std::runtime_error("Snapshot file is damaged (integer runs past the end of its record).");
+        const unsigned char byte = static_cast<unsigned char>(data[pos++]);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return value;
+    }
+    throw std::runtime_error("Snapshot file is damaged (integer too long).");
+}
+
+// Adds raw bytes to a snapshot buffer.
+void Snapshot::put_bytes(std::vector<char> &data, const void *bytes, size_t size)
+{
+    const char *chars = static_cast<const char*>(bytes);
+    data.insert(data.end(), chars, chars + size);
+}
+
+// Adds the values of the row a statement has just stepped onto to a snapshot buffer, starting from the given column.
+void Snapshot::put_row(std::vector<char> &data, sqlite3_stmt *stmt, int first_column)
+{
+    const int columns = sqlite3_column_count(stmt);
+    put_varint(data, columns - first_column);
+    for (int i = first_column; i < columns; i++)
+    {
+        switch (sqlite3_column_type(stmt, i))
+        {
+            case SQLITE_INTEGER:
+            {
+                // Integers are zigzag-encoded, so small negative numbers stay small too.
+                const int64_t value = sqlite3_column_int64(stmt, i);
+                data.push_back(static_cast<char>(Value::INTEGER));
+                put_varint(data, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+                break;
+            }
+            case SQLITE_FLOAT:
+            {
+                const double real = sqlite3_column_double(stmt, i);
+                uint64_t bits;
+                std::memcpy(&bits, &real, sizeof(bits));
+                data.push_back(static_cast<char>(Value::REAL));
+                put_u32(data, bits & 0xFFFFFFFF);
+                put_u32(data, bits >> 32);
+                break;
+            }
+            case SQLITE_TEXT: case SQLITE_BLOB:
+            {
+                const bool text = (sqlite3_column_type(stmt, i) == SQLITE_TEXT);
+                const void *bytes = (text ? static_cast<const void*>(sqlite3_column_text(stmt, i)) : sqlite3_column_blob(stmt, i));
+                const int size = sqlite3_column_bytes(stmt, i);
+                data.push_back(static_cast<char>(text ? Value::TEXT : Value::BLOB));
+                put_varint(data, size);
+                put_bytes(data, bytes, size);
+                break;
+            }
+            default: data.push_back(static_cast<char>(Value::NONE));
+        }
+    }
+}
+
+// Adds a 32-bit integer to a snapshot buffer, in little-endian order.
+void Snapshot::put_u32(std::vector<char> &data, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+        data.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+}
+
+// Adds a variable-length integer to a snapshot buffer, seven bits at a time.
+void Snapshot::put_varint(std::vector<char> &data, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        data.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    data.push_back(static_cast<char>(value));
+}
+
+// Reads a snapshot file into a new in-memory SQLite database.
+std::shared_ptr<SQLite::Database> Snapshot::to_sqlite(const std::string &filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.good()) throw std::runtime_error("Could not open snapshot file " + filename);
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+
+    // The whole file is checked before any of it is used.
+    if (data.size() < 4) throw std::runtime_error(filename + " is not a snapshot file.");
+    size_t pos = data.size() - 4;
+    const uint32_t crc = get_u32(data, pos);
+    data.resize(data.size() - 4);
+    if (crc != lodepng_crc32(reinterpret_cast<const unsigned char*>(data.data()), data.size())) throw std::runtime_error("Snapshot file " + filename + " is damaged (checksum mismatch).");
+    return decode(data, "Snapshot file " + filename);
+}
@@ -0,0 +1,53 @@
+// core/snapshot.h -- A compact binary copy of a saved game, used for quicksaves. It can be converted to and from the SQLite save file format, which remains the canonical format.
+// Copyright (c) 2021 Raine "Gravecat" Simmons and the Greave contributors. Licensed under the GNU Affero General Public License v3 or any later version.
+
+#ifndef GREAVE_CORE_SNAPSHOT_H_
+#define GREAVE_CORE_SNAPSHOT_H_
+
+#include "3rdparty/SQLiteCpp/Database.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+struct sqlite3_stmt;
+
+
+class Snapshot
+{
+public:
+    static void     apply_changes(SQLite::Database &save_db, const std::vector<char> &data);    // Applies a set of changes from encode_changes() to an SQLite save file, in a single transaction.
+    static int64_t  block_of(int64_t rowid, int64_t block_size);    // Returns which block of rowids a rowid falls into, as used by encode_rows().
+    static void     convert(const std::string &filename);   // Converts a snapshot file into an SQLite save file, or the other way around, writing the result alongside the original.
+    static std::shared_ptr<SQLite::Database> decode(const std::vector<char> &data, const std::string &source);  // Reads snapshot data, without its checksum, into a new in-memory SQLite database.
+    static std::vector<char> encode(SQLite::Database &save_db);    // Converts the contents of an SQLite save file into snapshot data, without a checksum.
+    static std::vector<char> encode_changes(SQLite::Database &save_db, const std::map<std::string, std::set<int64_t>> &rowids);    // Records the current contents of some rows of an SQLite save file, by table and rowid, so they can be copied to another copy of the file. Rows which no longer exist are recorded as deleted.
+    static std::vector<char> encode_header(SQLite::Database &save_db);  // The start of the snapshot data, which identifies the format and the saved game version.
+    static std::vector<char> encode_indexes(SQLite::Database &save_db); // The end of the snapshot data: the indexes, which are only built once every table's rows are in.
+    static std::map<int64_t, std::vector<char>> encode_rows(SQLite::Database &save_db, const std::string &table, int64_t block_size, int64_t first_rowid = INT64_MIN, int64_t last_rowid = INT64_MAX);   // Converts the rows of a table with rowids in the given range into snapshot data, in rowid order, split into blocks of rowids of the given size.
+    static std::vector<char> encode_table(const std::string &table, const std::string &schema); // The schema of a table, which comes before its rows in the snapshot data.
+    static std::string  filename(int slot);                 // Returns the quicksave snapshot filename for a save slot.
+    static void     from_sqlite(SQLite::Database &save_db, const std::string &filename);    // Writes the contents of an SQLite save file to a snapshot file.
+    static std::shared_ptr<SQLite::Database> to_sqlite(const std::string &filename);    // Reads a snapshot file into a new in-memory SQLite database.
+
+private:
+    enum class Record : uint8_t { END, SCHEMA, TABLE, ROW, DELETE };    // The types of record in a snapshot file, or in a set of changes.
+    enum class Value : uint8_t { NONE, INTEGER, REAL, TEXT, BLOB }; // The types of value stored in a ROW record.
+
+    static constexpr uint32_t   SNAPSHOT_VERSION =  1;      // The snapshot format version. This is separate from the saved game version, which describes the tables rather than how they're stored.
+    static const char           SNAPSHOT_HEADER[];          // The identifier at the start of every snapshot file.
+
+    static void     add_record(std::vector<char> &data, Record type, const std::vector<char> &payload); // Adds a length-prefixed record to the snapshot data.
+    static void     bind_row(sqlite3_stmt *stmt, const std::vector<char> &data, size_t &pos, size_t end, uint64_t columns, const std::string &source);   // Binds the values of a ROW record to a prepared statement, throwing an exception if the record is damaged.
+    static uint32_t get_u32(const std::vector<char> &data, size_t &pos);    // Reads a 32-bit integer from a snapshot buffer, throwing an exception if the buffer is too short.
+    static uint64_t get_varint(const std::vector<char> &data, size_t &pos, size_t end); // Reads a variable-length integer from a snapshot buffer, throwing an exception if it runs past the end.
+    static void     put_bytes(std::vector<char> &data, const void *bytes, size_t size); // Adds raw bytes to a snapshot buffer.
+    static void     put_row(std::vector<char> &data, sqlite3_stmt *stmt, int first_column = 0); // Adds the values of the row a statement has just stepped onto to a snapshot buffer, starting from the given column.
+    static void     put_u32(std::vector<char> &data, uint32_t value);   // Adds a 32-bit integer to a snapshot buffer, in little-endian order.
+    static void     put_varint(std::vector<char> &data, uint64_t value);    // Adds a variable-length integer to a snapshot buffer, seven bits at a time.
+};
+
+#endif  // GREAVE_CORE_SNAPSHOT_H_
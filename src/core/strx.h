@@ -5,11 +5,11 @@
 #define GREAVE_CORE_STRX_H_
 
 #include "core/core-constants.h"
+#include "core/tag-set.h"
 
 #include <cstddef>
 #include <cstdint>
 #include <map>
-#include <set>
 #include <string>
 #include <vector>
 
@@ -60,7 +60,7 @@ public:
     static std::string  time_string_rough(float seconds);           // Returns a time string as a rough description ("a few seconds", "a moment", "a few minutes").
     static size_t       word_count(const std::string &str, const std::string &word);    // Returns a count of the amount of times a string is found in a parent string.
 
-    template<class T> static void string_to_tags(const std::string &tag_string, std::set<T> &tags)
+    template<class T, size_t D, size_t P> static void string_to_tags(const std::string &tag_string, TagSet<T, D, P> &tags)
     {
         if (!tag_string.size()) return;
         std::vector<std::string> split_tags = string_explode(tag_string, " ");
@@ -68,12 +68,12 @@ public:
             tags.insert(static_cast<T>(htoi(tag)));
     }
 
-    template<class T> static std::string tags_to_string(std::set<T> tags)
+    template<class T, size_t D, size_t P> static std::string tags_to_string(const TagSet<T, D, P> &tags)
     {
         if (!tags.size()) return "";
         std::string tags_str;
-        for (auto tag : tags)
-            if (static_cast<uint32_t>(tag) < CoreConstants::TAGS_PERMANENT) tags_str += itoh(static_cast<long long>(tag), 1) + " ";
+        for (size_t i = 0; i < tags.dynamic_max(); i++)
+            if (tags.dynamic(i)) tags_str += itoh(static_cast<long long>(i), 1) + " ";
         if (tags_str.size()) tags_str.pop_back();   // Strip off the excess space at the end.
         return tags_str;
     }
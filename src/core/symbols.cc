@@ -0,0 +1,109 @@
+// core/symbols.cc -- A process-wide string interner, which gives each distinct ID string (list names, species, skills, etc.) a small dense integer, so lookups can be keyed on that instead of on the string.
+// Copyright (c) 2021 Raine "Gravecat" Simmons and the Greave contributors. Licensed under the GNU Affero General Public License v3 or any later version.
+
+#include "core/core.h"
+#include "core/strx.h"
+#include "core/symbols.h"
+
+#include <stdexcept>
+
+
+constexpr uint32_t Symbols::NONE;
+std::vector<std::pair<uint32_t, uint32_t>>  Symbols::collisions_;
+std::atomic<bool>                           Symbols::frozen_(false);
+std::map<uint32_t, uint32_t>                Symbols::hashes_;
+std::mutex                                  Symbols::mutex_;
+std::unordered_map<std::string, uint32_t>   Symbols::symbols_;
+std::vector<const std::string*>             Symbols::strings_;
+
+
+// Returns every pair of interned strings that share the same StrX::hash(), which would clash if both were used as IDs in the same pool.
+std::vector<std::pair<std::string, std::string>> Symbols::collisions()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::pair<std::string, std::string>> result;
+    for (auto collision : collisions_)
+        result.push_back(std::make_pair(*strings_.at(collision.first), *strings_.at(collision.second)));
+    return result;
+}
+
+// Returns the symbol for a string if it has already been interned, or NONE if it hasn't. Never adds a new symbol.
+uint32_t Symbols::find(const std::string &str)
+{
+    std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+    if (!frozen_) lock.lock();
+    const auto it = symbols_.find(str);
+    if (it == symbols_.end()) return NONE;
+    return it->second;
+}
+
+// Returns the symbol for a string, adding it to the table if it's new.
+uint32_t Symbols::intern(const std::string &str)
+{
+    std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+    if (!frozen_) lock.lock();
+
+    // The blank string is always symbol 0, so that a default-initialized symbol means the same thing as a blank string.
+    if (!strings_.size())
+    {
+        const auto blank = symbols_.insert(std::make_pair(std::string(), NONE)).first;
+        strings_.push_back(&blank->first);
+    }
+
+    const auto it = symbols_.find(str);
+    if (it != symbols_.end()) return it->second;
+    if (strings_.size() >= UINT32_MAX) throw std::runtime_error("Symbol table is full!");
+
+    const uint32_t symbol = strings_.size();
+    const auto inserted = symbols_.insert(std::make_pair(str, symbol)).first;
+    strings_.push_back(&inserted->first);
+
+    // Two different strings with the same hash would be treated as the same ID anywhere the game keys things on StrX::hash(), so these are recorded to be reported once the data has loaded.
+    const auto hash_result = hashes_.insert(std::make_pair(StrX::hash(str), symbol));
+    if (!hash_result.second) collisions_.push_back(std::make_pair(hash_result.first->second, symbol));
+
+    return symbol;
+}
+
+// Interns the keys of a string-keyed map, such as metadata read from a save file.
+std::map<uint32_t, std::string> Symbols::intern_keys(const std::map<std::string, std::string> &map)
+{
+    std::map<uint32_t, std::string> result;
+    for (auto entry : map)
+        result.insert(std::make_pair(intern(entry.first), entry.second));
+    return result;
+}
+
+// Freezes the table once the game data has loaded, or unfreezes it before loading again. See frozen_ in symbols.h.
+void Symbols::set_frozen(bool frozen)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    frozen_ = frozen;
+}
+
+// Returns the number of symbols in the table, including NONE.
+size_t Symbols::size()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return strings_.size() ? strings_.size() : 1;
+}
+
+// Returns the string for a symbol. Symbols are never removed, so the reference remains valid.
+const std::string& Symbols::str(uint32_t symbol)
+{
+    static const std::string blank;
+    std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+    if (!frozen_) lock.lock();
+    if (symbol == NONE) return blank;
+    if (symbol >= strings_.size()) throw std::runtime_error("Invalid symbol requested: " + std::to_string(symbol));
+    return *strings_[symbol];
+}
+
+// Converts a symbol-keyed map back to strings, sorted by string, as it's written to save files.
+std::map<std::string, std::string> Symbols::str_keys(const std::map<uint32_t, std::string> &map)
+{
+    std::map<std::string, std::string> result;
+    for (auto entry : map)
+        result.insert(std::make_pair(str(entry.first), entry.second));
+    return result;
+}
@@ -0,0 +1,41 @@
+// core/symbols.h -- A process-wide string interner, which gives each distinct ID string (list names, species, skills, etc.) a small dense integer, so lookups can be keyed on that instead of on the string.
+// Copyright (c) 2021 Raine "Gravecat" Simmons and the Greave contributors. Licensed under the GNU Affero General Public License v3 or any later version.
+
+#ifndef GREAVE_CORE_SYMBOLS_H_
+#define GREAVE_CORE_SYMBOLS_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+class Symbols
+{
+public:
+    static constexpr uint32_t   NONE =  0;  // The symbol for a blank string. It's never returned by find() for a string that hasn't been interned.
+
+    static std::vector<std::pair<std::string, std::string>> collisions();   // Returns every pair of interned strings that share the same StrX::hash(), which would clash if both were used as IDs in the same pool.
+    static uint32_t     find(const std::string &str);   // Returns the symbol for a string if it has already been interned, or NONE if it hasn't. Never adds a new symbol.
+    static uint32_t     intern(const std::string &str); // Returns the symbol for a string, adding it to the table if it's new.
+    static std::map<uint32_t, std::string>  intern_keys(const std::map<std::string, std::string> &map);    // Interns the keys of a string-keyed map, such as metadata read from a save file.
+    static void         set_frozen(bool frozen);        // Freezes the table once the game data has loaded, or unfreezes it before loading again. See frozen_ below.
+    static size_t       size();                         // Returns the number of symbols in the table, including NONE.
+    static const std::string&   str(uint32_t symbol);   // Returns the string for a symbol. Symbols are never removed, so the reference remains valid.
+    static std::map<std::string, std::string>   str_keys(const std::map<uint32_t, std::string> &map);   // Converts a symbol-keyed map back to strings, sorted by string, as it's written to save files.
+
+private:
+    static std::vector<std::pair<uint32_t, uint32_t>>   collisions_;    // Pairs of symbols whose strings share the same hash.
+    static std::atomic<bool>                frozen_;    // Once the data has loaded, only the main thread uses the table, so lookups skip the mutex. Strings can still be interned while frozen, from the main thread.
+    static std::map<uint32_t, uint32_t>     hashes_;    // The symbol for each StrX::hash() seen so far, used to detect hash collisions.
+    static std::mutex                       mutex_;     // Symbols can be interned from the data-loading threads as well as the main thread.
+    static std::unordered_map<std::string, uint32_t>    symbols_;   // The symbol for each interned string.
+    static std::vector<const std::string*>  strings_;   // The interned strings, indexed by symbol. These point into the keys of symbols_, which never move once inserted.
+};
+
+#endif  // GREAVE_CORE_SYMBOLS_H_
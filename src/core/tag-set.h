@@ -0,0 +1,65 @@
+// core/tag-set.h -- A compact, fixed-size bitset container for the tag enums used by Rooms, Mobiles and Items.
+// Copyright (c) 2021 Raine "Gravecat" Simmons. Licensed under the GNU Affero General Public License v3 or any later version.
+
+#ifndef GREAVE_CORE_TAG_SET_H_
+#define GREAVE_CORE_TAG_SET_H_
+
+#include "core/core-constants.h"
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+
+// Dynamic tags (below TAGS_PERMANENT) are stored from bit 0 upward in one bitset, permanent tags (TAGS_PERMANENT and above) in another.
+template<class T, size_t DYNAMIC = 64, size_t PERMANENT = 64> class TagSet
+{
+public:
+    uint64_t    bits(bool permanent) const                      // Returns the dynamic or permanent tags as raw bits, for the data cache.
+    {
+        static_assert(DYNAMIC <= 64 && PERMANENT <= 64, "TagSet is too large to convert to raw bits.");
+        return (permanent ? permanent_.to_ullong() : dynamic_.to_ullong());
+    }
+    void    clear() { dynamic_.reset(); permanent_.reset(); }   // Removes all tags from this set.
+    bool    dynamic(size_t pos) const { return (pos < DYNAMIC && dynamic_.test(pos)); } // Checks a dynamic tag by its raw value, for iterating during saves.
+    size_t  dynamic_max() const { return DYNAMIC; }             // The number of dynamic tag values this set can hold.
+    bool    dynamic_equals(const TagSet &other) const { return dynamic_ == other.dynamic_; }    // Checks if two sets have the same dynamic tags.
+    void    erase(T tag) { set_bit(tag, false); }               // Removes a tag from this set.
+    void    insert(T tag) { set_bit(tag, true); }               // Adds a tag to this set.
+    void    set_bits(bool permanent, uint64_t bits)             // Replaces the dynamic or permanent tags with raw bits, from the data cache.
+    {
+        static_assert(DYNAMIC <= 64 && PERMANENT <= 64, "TagSet is too large to convert from raw bits.");
+        if (permanent) permanent_ = std::bitset<PERMANENT>(bits);
+        else dynamic_ = std::bitset<DYNAMIC>(bits);
+    }
+    size_t  size() const { return dynamic_.count() + permanent_.count(); }  // The number of tags in this set.
+    bool    test(T tag) const                                   // Checks if a tag is in this set.
+    {
+        const uint32_t value = static_cast<uint32_t>(tag);
+        if (value < CoreConstants::TAGS_PERMANENT) return (value < DYNAMIC && dynamic_.test(value));
+        return (value - CoreConstants::TAGS_PERMANENT < PERMANENT && permanent_.test(value - CoreConstants::TAGS_PERMANENT));
+    }
+
+private:
+    void    set_bit(T tag, bool state)                          // Sets or clears the bit for a given tag.
+    {
+        const uint32_t value = static_cast<uint32_t>(tag);
+        if (value < CoreConstants::TAGS_PERMANENT)
+        {
+            if (value >= DYNAMIC) throw std::runtime_error("Dynamic tag value out of range: " + std::to_string(value));
+            dynamic_.set(value, state);
+        }
+        else
+        {
+            if (value - CoreConstants::TAGS_PERMANENT >= PERMANENT) throw std::runtime_error("Permanent tag value out of range: " + std::to_string(value));
+            permanent_.set(value - CoreConstants::TAGS_PERMANENT, state);
+        }
+    }
+
+    std::bitset<DYNAMIC>    dynamic_;   // The dynamic tags, which are saved to save files.
+    std::bitset<PERMANENT>  permanent_; // The permanent tags, which are never saved.
+};
+
+#endif  // GREAVE_CORE_TAG_SET_H_
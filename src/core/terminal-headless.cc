@@ -0,0 +1,54 @@
+// core/terminal-headless.cc -- A terminal that renders nothing, for running the game without a display (e.g. the -bench mode). See core/terminal.h for a full description of the Terminal class.
+// Copyright (c) 2021 Raine "Gravecat" Simmons. Licensed under the GNU Affero General Public License v3 or any later version.
+
+#include "core/terminal-headless.h"
+
+
+// Returns the height of a single cell, in pixels. Always 1 when headless.
+int TerminalHeadless::cell_height() const { return 1; }
+
+// Clears the screen. Does nothing when headless.
+void TerminalHeadless::cls() { }
+
+// Makes the cursor visible or invisible. Does nothing when headless.
+void TerminalHeadless::cursor(bool) { }
+
+// Fills a given area in with the specified colour. Does nothing when headless.
+void TerminalHeadless::fill(int, int, int, int, Colour) { }
+
+// Gets keyboard input from the terminal. Always returns CLOSE when headless.
+int TerminalHeadless::get_key() { return Key::CLOSE; }
+
+// Not supported when headless.
+int TerminalHeadless::get_mouse_x() const { return 0; }
+
+// Not supported when headless.
+int TerminalHeadless::get_mouse_x_pixel() const { return 0; }
+
+// Not supported when headless.
+int TerminalHeadless::get_mouse_y() const { return 0; }
+
+// Not supported when headless.
+int TerminalHeadless::get_mouse_y_pixel() const { return 0; }
+
+// Retrieves the size of the terminal (in cells, not pixels).
+void TerminalHeadless::get_size(int *w, int *h) const
+{
+    *w = HEADLESS_WIDTH;
+    *h = HEADLESS_HEIGHT;
+}
+
+// Moves the cursor to the specified position. Does nothing when headless.
+void TerminalHeadless::move_cursor(int, int) { }
+
+// Internal rendering code, after print() has parsed the colour tags. Does nothing when headless.
+void TerminalHeadless::print_internal(std::string, int, int, Colour) { }
+
+// Prints a character at a given coordinate on the screen. Does nothing when headless.
+void TerminalHeadless::put(uint16_t, int, int, Colour) { }
+
+// Refreshes the screen with changes made. Does nothing when headless.
+void TerminalHeadless::refresh() { }
+
+// Returns true if the player has tried to close the terminal window. Always false when headless.
+bool TerminalHeadless::wants_to_close() const { return false; }
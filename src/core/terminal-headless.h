@@ -0,0 +1,38 @@
+// core/terminal-headless.h -- A terminal that renders nothing, for running the game without a display (e.g. the -bench mode). See core/terminal.h for a full description of the Terminal class.
+// Copyright (c) 2021 Raine "Gravecat" Simmons. Licensed under the GNU Affero General Public License v3 or any later version.
+
+#ifndef GREAVE_CORE_TERMINAL_HEADLESS_H_
+#define GREAVE_CORE_TERMINAL_HEADLESS_H_
+
+#include "core/terminal.h"
+
+#include <cstdint>
+#include <string>
+
+
+class TerminalHeadless : public Terminal
+{
+public:
+    int         cell_height() const override;               // Returns the height of a single cell, in pixels. Always 1 when headless.
+    void        cls() override;                             // Clears the screen. Does nothing when headless.
+    void        cursor(bool visible) override;              // Makes the cursor visible or invisible. Does nothing when headless.
+    void        fill(int x, int y, int w, int h, Colour col = Colour::BLACK) override;  // Fills a given area in with the specified colour. Does nothing when headless.
+    int         get_key() override;                         // Gets keyboard input from the terminal. Always returns CLOSE when headless.
+    int         get_mouse_x() const override;               // Not supported when headless.
+    int         get_mouse_x_pixel() const override;         // Not supported when headless.
+    int         get_mouse_y() const override;               // Not supported when headless.
+    int         get_mouse_y_pixel() const override;         // Not supported when headless.
+    void        get_size(int *w, int *h) const override;    // Retrieves the size of the terminal (in cells, not pixels).
+    void        move_cursor(int x, int y) override;         // Moves the cursor to the specified position. Does nothing when headless.
+    void        put(uint16_t letter, int x, int y, Colour col = Colour::WHITE) override;    // Prints a character at a given coordinate on the screen. Does nothing when headless.
+    void        refresh() override;                         // Refreshes the screen with changes made. Does nothing when headless.
+    bool        wants_to_close() const override;            // Returns true if the player has tried to close the terminal window. Always false when headless.
+
+private:
+    static constexpr int    HEADLESS_HEIGHT =   25; // The pretend height of the headless terminal, in cells.
+    static constexpr int    HEADLESS_WIDTH =    80; // The pretend width of the headless terminal, in cells.
+
+    void        print_internal(std::string str, int x, int y, Colour col = Colour::WHITE) override; // Internal rendering code, after print() has parsed the colour tags. Does nothing when headless.
+};
+
+#endif  // GREAVE_CORE_TERMINAL_HEADLESS_H_
@@ -12,12 +12,13 @@
 #include "core/strx.h"
 #include "core/terminal-sdl2.h"
 
+#include <algorithm>
 #include <ctime>
 #include <thread>
 
 
 // Constructor, sets up SDL2.
-TerminalSDL2::TerminalSDL2() : cursor_visible_(false), cursor_x_(0), cursor_y_(0), font_(nullptr), init_sdl_(false), init_sdl_ttf_(false), mouse_x_(0), mouse_y_(0), renderer_(nullptr), screenshot_msg_time_(0), screenshot_taken_(0), window_(nullptr)
+TerminalSDL2::TerminalSDL2() : cursor_visible_(false), cursor_x_(0), cursor_y_(0), font_(nullptr), glyph_atlas_(nullptr), init_sdl_(false), init_sdl_ttf_(false), mouse_x_(0), mouse_y_(0), renderer_(nullptr), screenshot_msg_time_(0), screenshot_taken_(0), window_(nullptr)
 {
     const std::shared_ptr<Prefs> prefs = core()->prefs();
     if (SDL_Init(SDL_INIT_VIDEO) < 0) throw std::runtime_error("Could not initialize SDL: " + std::string(SDL_GetError()));
@@ -53,11 +54,19 @@ TerminalSDL2::TerminalSDL2() : cursor_visible_(false), cursor_x_(0), cursor_y_(0
 
     // Set the colours up.
     init_colours();
+
+    // Build the glyph atlas, so we don't have to render text with SDL_ttf every frame.
+    init_glyph_atlas();
 }
 
 // Destructor, cleans up SDL2.
 TerminalSDL2::~TerminalSDL2()
 {
+    if (glyph_atlas_)
+    {
+        SDL_DestroyTexture(glyph_atlas_);
+        glyph_atlas_ = nullptr;
+    }
     if (font_)
     {
         TTF_CloseFont(font_);
@@ -226,6 +235,39 @@ void TerminalSDL2::init_colours()
     populate_colour_map(prefs->colour_white, Colour::WHITE_BG);
 }
 
+// Renders all the printable characters in the font into a single texture.
+void TerminalSDL2::init_glyph_atlas()
+{
+    const int glyph_count = GLYPH_ATLAS_LAST - GLYPH_ATLAS_FIRST + 1;
+    SDL_Surface* atlas_surf = SDL_CreateRGBSurfaceWithFormat(0, glyph_count * font_width_, font_height_, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (!atlas_surf) throw std::runtime_error("Could not create glyph atlas surface: " + std::string(SDL_GetError()));
+    SDL_FillRect(atlas_surf, nullptr, SDL_MapRGBA(atlas_surf->format, 255, 255, 255, 0));
+
+    // Each glyph is rendered on its own and copied into its own cell, so kerning or a glyph's advance can't shift the glyphs after it out of their cells.
+    // They're rendered in white, so they can be tinted to any colour with SDL_SetTextureColorMod().
+    for (int i = 0; i < glyph_count; i++)
+    {
+        SDL_Surface* glyph_surf = TTF_RenderGlyph_Blended(font_, static_cast<uint16_t>(GLYPH_ATLAS_FIRST + i), {255, 255, 255, 255});
+        if (!glyph_surf)
+        {
+            SDL_FreeSurface(atlas_surf);
+            throw std::runtime_error("Could not render glyph atlas: " + std::string(TTF_GetError()));
+        }
+
+        // The glyph's pixels are copied as they are, alpha included, rather than blended onto the transparent atlas.
+        SDL_SetSurfaceBlendMode(glyph_surf, SDL_BLENDMODE_NONE);
+        SDL_Rect src = { 0, 0, std::min(glyph_surf->w, font_width_), std::min(glyph_surf->h, font_height_) };
+        SDL_Rect dest = { i * font_width_, 0, src.w, src.h };
+        SDL_BlitSurface(glyph_surf, &src, atlas_surf, &dest);
+        SDL_FreeSurface(glyph_surf);
+    }
+
+    glyph_atlas_ = SDL_CreateTextureFromSurface(renderer_, atlas_surf);
+    SDL_FreeSurface(atlas_surf);
+    if (!glyph_atlas_) throw std::runtime_error("Could not create glyph atlas texture: " + std::string(SDL_GetError()));
+    SDL_SetTextureBlendMode(glyph_atlas_, SDL_BLENDMODE_BLEND);
+}
+
 // Moves the cursor to the specified position.
 void TerminalSDL2::move_cursor(int x, int y)
 {
@@ -244,12 +286,20 @@ void TerminalSDL2::print_internal(std::string str, int x, int y, Colour col)
 
     uint8_t r, g, b;
     colour_to_rgb(col, &r, &g, &b);
-    SDL_Surface* font_surf = TTF_RenderText_Blended(font_, str.c_str(), {r, g, b, 255});
-    SDL_Texture* font_tex = SDL_CreateTextureFromSurface(renderer_, font_surf);
-    SDL_Rect rect = { x * font_width_, y * font_height_, static_cast<int>(str.size() * font_width_), font_height_ };
-    SDL_RenderCopy(renderer_, font_tex, nullptr, &rect);
-    SDL_DestroyTexture(font_tex);
-    SDL_FreeSurface(font_surf);
+    SDL_SetTextureColorMod(glyph_atlas_, r, g, b);
+
+    // Each character is copied from the glyph atlas. As these all share one texture, SDL's render batching can submit them together.
+    SDL_Rect src = { 0, 0, font_width_, font_height_ };
+    SDL_Rect dest = { x * font_width_, y * font_height_, font_width_, font_height_ };
+    for (auto ch : str)
+    {
+        if (ch > GLYPH_ATLAS_FIRST && ch <= GLYPH_ATLAS_LAST)
+        {
+            src.x = (ch - GLYPH_ATLAS_FIRST) * font_width_;
+            SDL_RenderCopy(renderer_, glyph_atlas_, &src, &dest);
+        }
+        dest.x += font_width_;
+    }
 }
 
 // Prints a character at a given coordinate on the screen.
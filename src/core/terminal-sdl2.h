@@ -37,9 +37,13 @@ public:
 private:
     struct RGB { uint8_t r, g, b; };
 
+    static constexpr char   GLYPH_ATLAS_FIRST = ' ';    // The first character rendered into the glyph atlas.
+    static constexpr char   GLYPH_ATLAS_LAST =  '~';    // The last character rendered into the glyph atlas.
+
     void    colour_to_rgb(Colour col, uint8_t *r, uint8_t *g, uint8_t *b) const;    // Converts a colour code into a more useful form.
 
     void    init_colours();     // Loads the colours from prefs.yml into RGB values.
+    void    init_glyph_atlas(); // Renders all the printable characters in the font into a single texture.
     void    print_internal(std::string str, int x, int y, Colour col) override;     // Internal rendering code, after print() has parsed the colour tags.
     void    screenshot();       // Takes a screenshot!
 
@@ -50,6 +54,7 @@ private:
     TTF_Font*               font_;                  // The font chosen by the user.
     int                     font_height_;           // The height of the loaded font, in pixels.
     int                     font_width_;            // The width of the loaded font, in pixels.
+    SDL_Texture*            glyph_atlas_;           // White glyphs for every printable character, tinted with colour modulation when drawn.
     bool                    init_sdl_;              // SDL system successfully initialized.
     bool                    init_sdl_ttf_;          // SDL_ttf system successfully initialized.
     int                     mouse_x_;               // The X pixel coordinate of the mouse cursor's last location.
@@ -24,16 +24,16 @@ void Inventory::add_item(std::shared_ptr<Item> item, bool force_stack)
                 items_.at(i)->set_stack(item->stack() + items_.at(i)->stack());
 
                 // Compare appraised values, and pick the most accurate of the two.
-                const int appraised_value_a = items_.at(i)->meta_int("appraised_value");
-                const int appraised_value_b = item->meta_int("appraised_value");
+                const int appraised_value_a = items_.at(i)->appraisal();
+                const int appraised_value_b = item->appraisal();
                 if (appraised_value_a != appraised_value_b)
                 {
-                    if (!appraised_value_a) items_.at(i)->set_meta("appraised_value", appraised_value_b);
+                    if (!appraised_value_a) items_.at(i)->set_appraisal(appraised_value_b);
                     else
                     {
                         const int diff_a = std::abs(appraised_value_a - static_cast<int>(items_.at(i)->value(true)));
                         const int diff_b = std::abs(appraised_value_b - static_cast<int>(items_.at(i)->value(true)));
-                        if (diff_a > diff_b) items_.at(i)->set_meta("appraised_value", appraised_value_b);
+                        if (diff_a > diff_b) items_.at(i)->set_appraisal(appraised_value_b);
                     }
                 }
                 return;
@@ -102,20 +102,39 @@ std::shared_ptr<Item> Inventory::get(EquipSlot es) const
     return nullptr;
 }
 
-// Loads an Inventory from the save file.
-void Inventory::load(std::shared_ptr<SQLite::Database> save_db, uint32_t sql_id)
+// Fills this Inventory with its Items, taken from the Items loaded by load_all().
+void Inventory::load(const std::map<uint32_t, std::vector<std::shared_ptr<Item>>> &items, uint32_t sql_id)
 {
-    items_.clear();
-    SQLite::Statement query(*save_db, "SELECT sql_id FROM items WHERE owner_id = :owner_id ORDER BY sql_id ASC");
-    query.bind(":owner_id", sql_id);
-    bool loaded_items = false;
+    const auto it = items.find(sql_id);
+    if (it == items.end()) throw std::runtime_error("Could not load inventory data " + std::to_string(sql_id));
+    items_ = it->second;
+}
+
+// Loads every Item in the save file in a single pass, grouped by the SQL ID of the Inventory that holds them.
+std::map<uint32_t, std::vector<std::shared_ptr<Item>>> Inventory::load_all(std::shared_ptr<SQLite::Database> save_db)
+{
+    std::map<uint32_t, std::vector<std::shared_ptr<Item>>> items;
+    std::vector<std::pair<std::shared_ptr<Item>, uint32_t>> containers;
+    std::map<std::string, std::shared_ptr<ItemData>> loaded_data;
+
+    // Items are saved in the order they appear in each Inventory, so ordering by SQL ID keeps them in the right order.
+    SQLite::Statement query(*save_db, "SELECT * FROM items ORDER BY sql_id ASC");
     while (query.executeStep())
     {
-        auto new_item = Item::load(save_db, query.getColumn("sql_id").getUInt());
-        items_.push_back(new_item);
-        loaded_items = true;
+        uint32_t inventory_id = 0;
+        auto new_item = Item::load(query, inventory_id, loaded_data);
+        items[query.getColumn("owner_id").getUInt()].push_back(new_item);
+        if (inventory_id) containers.push_back(std::make_pair(new_item, inventory_id));
     }
-    if (!loaded_items) throw std::runtime_error("Could not load inventory data " + std::to_string(sql_id));
+
+    // Now that every Item exists, fill in the inventories of any containers.
+    for (auto container : containers)
+    {
+        container.first->new_inventory();
+        container.first->inv()->load(items, container.second);
+    }
+
+    return items;
 }
 
 // Checks if a given parser ID already exists on an Item in this Inventory.
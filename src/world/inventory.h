@@ -9,6 +9,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -33,7 +34,8 @@ public:
     void        erase(size_t pos);                      // Deletes an Item from this Inventory.
     std::shared_ptr<Item> get(size_t pos) const;        // Retrieves an Item from this Inventory.
     std::shared_ptr<Item> get(EquipSlot es) const;      // As above, but retrieves an item based on a given equipment slot.
-    void        load(std::shared_ptr<SQLite::Database> save_db, uint32_t sql_id);   // Loads an Inventory from the save file.
+    void        load(const std::map<uint32_t, std::vector<std::shared_ptr<Item>>> &items, uint32_t sql_id); // Fills this Inventory with its Items, taken from the Items loaded by load_all().
+    static std::map<uint32_t, std::vector<std::shared_ptr<Item>>> load_all(std::shared_ptr<SQLite::Database> save_db);  // Loads every Item in the save file in a single pass, grouped by the SQL ID of the Inventory that holds them.
     void        remove_item(size_t pos);                // Removes an Item from this Inventory.
     void        remove_item(EquipSlot es);              // As above, but with a specified equipment slot.
     uint32_t    save(std::shared_ptr<SQLite::Database> save_db);    // Saves this Inventory, returns its SQL ID.
@@ -4,6 +4,7 @@
 #include "core/core.h"
 #include "core/mathx.h"
 #include "core/strx.h"
+#include "core/symbols.h"
 #include "world/item.h"
 
 #include <cmath>
@@ -12,27 +13,34 @@
 // The SQL table construction string for saving items.
 constexpr char Item::SQL_ITEMS[] = "CREATE TABLE items ( description TEXT, inventory INTEGER, metadata TEXT, name TEXT NOT NULL, owner_id INTEGER NOT NULL, parser_id INTEGER NOT NULL, rare INTEGER NOT NULL, sql_id INTEGER PRIMARY KEY UNIQUE NOT NULL, stack INTEGER, subtype INTEGER, tags TEXT, type INTEGER, value INTEGER, weight INTEGER NOT NULL )";
 
+// The SQL index construction string for the items table's owner IDs.
+constexpr char Item::SQL_ITEMS_INDEX[] = "CREATE INDEX items_owner_id ON items ( owner_id )";
+
 
 // Constructor, sets default values.
-Item::Item() : inventory_(nullptr), parser_id_(0), rarity_(1), stack_(1), type_(ItemType::NONE), type_sub_(ItemSub::NONE), value_(0) { }
+Item::Item() : appraised_value_(0), charge_(0), data_(std::make_shared<ItemData>()), inventory_(nullptr), parser_id_(0), stack_(1) { }
 
 // The damage multiplier for ammunition.
-float Item::ammo_power() const { return meta_float("ammo_power"); }
+float Item::ammo_power() const { return data_->ammo_power; }
+
+// Returns the value this Item has been appraised at, or 0 if it hasn't been appraised yet.
+int Item::appraisal() const { return appraised_value_; }
 
 // Attempts to guess the value of an item.
 int Item::appraised_value()
 {
-    if (!value_) return 0;
-    else if (meta_int("appraised_value")) return meta_int("appraised_value");
+    if (!data_->value) return 0;
+    else if (appraised_value_) return appraised_value_;
 
-    int required_skill = (rarity_ * APPRAISAL_RARITY_MULTIPLIER) + APPRAISAL_BASE_SKILL_REQUIRED;
+    int required_skill = (data_->rarity * APPRAISAL_RARITY_MULTIPLIER) + APPRAISAL_BASE_SKILL_REQUIRED;
     if (required_skill < 0) required_skill = 0;
-    const int appraisal_skill = core()->world()->player()->skill_level("APPRAISAL");
+    static const uint32_t SKILL_APPRAISAL = Symbols::intern("APPRAISAL");
+    const int appraisal_skill = core()->world()->player()->skill_level(SKILL_APPRAISAL);
     if (appraisal_skill >= required_skill)
     {
-        int value_fuzzed = MathX::fuzz(value_);
-        set_meta("appraised_value", value_fuzzed);
-        core()->world()->player()->gain_skill_xp("APPRAISAL", APPRAISAL_XP_EASY);
+        int value_fuzzed = MathX::fuzz(data_->value);
+        appraised_value_ = value_fuzzed;
+        core()->world()->player()->gain_skill_xp(SKILL_APPRAISAL, APPRAISAL_XP_EASY);
         if (tag(ItemTag::Stackable)) value_fuzzed *= stack_;
         return value_fuzzed;
     }
@@ -46,10 +54,10 @@ int Item::appraised_value()
     else penalty = 1;
     const int rolled_penalty = core()->rng()->rnd(penalty);
     int value_appraised;
-    if (core()->rng()->rnd(3) == 1) value_appraised = MathX::fuzz(MathX::mixup(value_ / rolled_penalty, true));
-    else value_appraised = MathX::fuzz(MathX::mixup(value_ * rolled_penalty, true));
-    set_meta("appraised_value", value_appraised);
-    core()->world()->player()->gain_skill_xp("APPRAISAL", APPRAISAL_XP_HARD);
+    if (core()->rng()->rnd(3) == 1) value_appraised = MathX::fuzz(MathX::mixup(data_->value / rolled_penalty, true));
+    else value_appraised = MathX::fuzz(MathX::mixup(data_->value * rolled_penalty, true));
+    appraised_value_ = value_appraised;
+    core()->world()->player()->gain_skill_xp(SKILL_APPRAISAL, APPRAISAL_XP_HARD);
     if (tag(ItemTag::Stackable)) value_appraised *= stack_;
     return value_appraised;
 }
@@ -57,7 +65,7 @@ int Item::appraised_value()
 // Returns the armour damage reduction value of this Item, if any.
 float Item::armour(int bonus_power) const
 {
-    if ((type_ != ItemType::ARMOUR && type_ != ItemType::SHIELD) || !power()) return 0;
+    if ((data_->type != ItemType::ARMOUR && data_->type != ItemType::SHIELD) || !power()) return 0;
     return std::pow(power() + bonus_power + 4, 1.2) / 100.0f;
 }
 
@@ -69,32 +77,96 @@ void Item::assign_inventory(std::shared_ptr<Inventory> inventory)
 }
 
 // Returns thie bleed chance of this Item, if any.
-int Item::bleed() const { return meta_int("bleed"); }
+int Item::bleed() const { return data_->bleed; }
 
 // Returns the block modifier% for this Item, if any.
-int Item::block_mod() const { return meta_int("block_mod"); }
+int Item::block_mod() const { return data_->block_mod; }
+
+// Reads this Item's template data from the data cache.
+void Item::cache_read(DataCache &cache)
+{
+    ItemData &data = mutable_data();
+    data.name = cache.read_string();
+    data.description = cache.read_string();
+    data.type = static_cast<ItemType>(cache.read_uint());
+    data.type_sub = static_cast<ItemSub>(cache.read_uint());
+    data.tags.set_bits(false, cache.read_uint());
+    data.metadata = Symbols::intern_keys(cache.read_map());
+    data.ammo_power = cache.read_float();
+    data.bleed = cache.read_int();
+    data.block_mod = cache.read_int();
+    data.capacity = cache.read_int();
+    charge_ = cache.read_int();
+    data.crit = cache.read_int();
+    data.damage_type = static_cast<DamageType>(cache.read_int());
+    data.dodge_mod = cache.read_int();
+    data.equip_slot = static_cast<EquipSlot>(cache.read_uint());
+    data.parry_mod = cache.read_int();
+    data.poison = cache.read_int();
+    data.power = cache.read_int();
+    data.rarity = cache.read_uint();
+    data.speed = cache.read_float();
+    stack_ = cache.read_uint();
+    data.value = cache.read_uint();
+    data.warmth = cache.read_int();
+    data.weight = cache.read_uint();
+}
+
+// Writes this Item's template data to the data cache.
+void Item::cache_write(DataCache &cache) const
+{
+    cache.write_string(data_->name);
+    cache.write_string(data_->description);
+    cache.write_uint(static_cast<uint64_t>(data_->type));
+    cache.write_uint(static_cast<uint64_t>(data_->type_sub));
+    cache.write_uint(data_->tags.bits(false));
+    cache.write_map(Symbols::str_keys(data_->metadata));
+    cache.write_float(data_->ammo_power);
+    cache.write_int(data_->bleed);
+    cache.write_int(data_->block_mod);
+    cache.write_int(data_->capacity);
+    cache.write_int(charge_);
+    cache.write_int(data_->crit);
+    cache.write_int(static_cast<int>(data_->damage_type));
+    cache.write_int(data_->dodge_mod);
+    cache.write_uint(static_cast<uint64_t>(data_->equip_slot));
+    cache.write_int(data_->parry_mod);
+    cache.write_int(data_->poison);
+    cache.write_int(data_->power);
+    cache.write_uint(data_->rarity);
+    cache.write_float(data_->speed);
+    cache.write_uint(stack_);
+    cache.write_uint(data_->value);
+    cache.write_int(data_->warmth);
+    cache.write_uint(data_->weight);
+}
 
 // Returns this Item's capacity, if any.
-int Item::capacity() const { return meta_int("capacity"); }
+int Item::capacity() const { return data_->capacity; }
 
 // Returns this Item's charge, if any.
-int Item::charge() const { return meta_int("charge"); }
+int Item::charge() const { return charge_; }
 
 // Clears a metatag from an Item. Use with caution!
-void Item::clear_meta(const std::string &key) { metadata_.erase(key); }
+void Item::clear_meta(const std::string &key)
+{
+    if (set_stat(key, "")) return;
+    const uint32_t key_sym = Symbols::find(key);
+    if (data_->metadata.count(key_sym)) mutable_data().metadata.erase(key_sym);
+}
 
 // Clears a tag on this Item.
 void Item::clear_tag(ItemTag the_tag)
 {
-    if (!(tags_.count(the_tag) > 0)) return;
-    tags_.erase(the_tag);
+    if (!data_->tags.test(the_tag)) return;
+    mutable_data().tags.erase(the_tag);
 }
 
 // Retrieves this Item's critical power, if any.
-int Item::crit() const { return meta_int("crit"); }
+int Item::crit() const { return data_->crit; }
 
 // Retrieves this Item's damage type, if any.
-DamageType Item::damage_type() const { return static_cast<DamageType>(meta_int("damage_type")); }
+DamageType Item::damage_type() const { return data_->damage_type; }
 
 // Returns a string indicator of this Item's damage type (e.g. edged = E)
 std::string Item::damage_type_string() const
@@ -119,13 +191,13 @@ std::string Item::damage_type_string() const
 }
 
 // Retrieves this Item's description.
-std::string Item::desc() const { return description_; }
+std::string Item::desc() const { return data_->description; }
 
 // Returns the dodge modifier% for this Item, if any.
-int Item::dodge_mod() const { return meta_int("dodge_mod"); }
+int Item::dodge_mod() const { return data_->dodge_mod; }
 
 // Checks what slot this Item equips in, if any.
-EquipSlot Item::equip_slot() const { return static_cast<EquipSlot>(meta_int("slot")); }
+EquipSlot Item::equip_slot() const { return data_->equip_slot; }
 
 // The inventory of this item, or nullptr if none exists.
 const std::shared_ptr<Inventory> Item::inv() { return inventory_; }
@@ -138,28 +210,32 @@ bool Item::is_identical(std::shared_ptr<Item> item) const
     // If an item has an inventory, it should be unstackable.
     if (inventory_ || item->inventory_) return false;
 
+    // Items which still share their data can only differ in their charge and appraised value, and appraised values might differ between identical Items.
+    if (charge_ != item->charge_) return false;
+    if (data_ == item->data_) return true;
+
     // Integer comparison.
-    if (rarity_ != item->rarity_) return false;
-    if (type_ != item->type_) return false;
-    if (type_sub_ != item->type_sub_) return false;
-    if (value_ != item->value_) return false;
-    if (weight_ != item->weight_) return false;
+    if (data_->rarity != item->data_->rarity) return false;
+    if (data_->type != item->data_->type) return false;
+    if (data_->type_sub != item->data_->type_sub) return false;
+    if (data_->value != item->data_->value) return false;
+    if (data_->weight != item->data_->weight) return false;
 
     // String comparison.
-    if (name_ != item->name_) return false;
-    if (description_ != item->description_) return false;
+    if (data_->name != item->data_->name) return false;
+    if (data_->description != item->data_->description) return false;
 
     // Way more complicated comparison stuff below here.
 
-    // For metadata comparison, appraised values might differ. So we'll take that out of the equation.
-    auto copy_a = std::make_shared<Item>(*this);
-    auto copy_b = std::make_shared<Item>(*item);
-    copy_a->clear_meta("appraised_value");
-    copy_b->clear_meta("appraised_value");
-    if (StrX::metadata_to_string(copy_a->metadata_) != StrX::metadata_to_string(copy_b->metadata_)) return false;
+    // Stat comparison.
+    if (data_->ammo_power != item->data_->ammo_power || data_->bleed != item->data_->bleed || data_->block_mod != item->data_->block_mod || data_->capacity != item->data_->capacity || data_->crit != item->data_->crit || data_->damage_type != item->data_->damage_type ||
+        data_->dodge_mod != item->data_->dodge_mod || data_->equip_slot != item->data_->equip_slot || data_->parry_mod != item->data_->parry_mod || data_->poison != item->data_->poison || data_->power != item->data_->power || data_->speed != item->data_->speed || data_->warmth != item->data_->warmth) return false;
+
+    // Metadata comparison. Appraised values are kept by each Item rather than in the metadata, so they don't get in the way here.
+    if (data_->metadata != item->data_->metadata) return false;
 
     // Tag matches are easier.
-    if (StrX::tags_to_string(tags_) != StrX::tags_to_string(item->tags_)) return false;
+    if (!data_->tags.dynamic_equals(item->data_->tags)) return false;
 
     return true;
 }
@@ -167,49 +243,53 @@ bool Item::is_identical(std::shared_ptr<Item> item) const
 // Returns the liquid type contained in this Item, if any.
 std::string Item::liquid_type() const { return meta("liquid"); }
 
-// Loads a new Item from the save file.
-std::shared_ptr<Item> Item::load(std::shared_ptr<SQLite::Database> save_db, uint32_t sql_id)
+// Loads a new Item from a row of the save file's items table. Items saved with the same data share it once loaded, as they did when first copied from their template.
+std::shared_ptr<Item> Item::load(SQLite::Statement &query, uint32_t &inventory_id, std::map<std::string, std::shared_ptr<ItemData>> &loaded_data)
 {
     auto new_item = std::make_shared<Item>();
-    uint32_t inventory_id = 0;
+    ItemData &data = new_item->mutable_data();
+    ItemType new_type = ItemType::NONE;
+    ItemSub new_subtype = ItemSub::NONE;
 
-    SQLite::Statement query(*save_db, "SELECT * FROM items WHERE sql_id = :id");
-    query.bind(":id", sql_id);
-    if (query.executeStep())
+    if (!query.getColumn("description").isNull()) new_item->set_description(query.getColumn("description").getString());
+    if (!query.getColumn("inventory").isNull()) inventory_id = query.getColumn("inventory").getUInt();
+    if (!query.getColumn("metadata").isNull())
     {
-        ItemType new_type = ItemType::NONE;
-        ItemSub new_subtype = ItemSub::NONE;
-
-        if (!query.getColumn("description").isNull()) new_item->set_description(query.getColumn("description").getString());
-        if (!query.getColumn("inventory").isNull()) inventory_id = query.getColumn("inventory").getUInt();
-        if (!query.getColumn("metadata").isNull()) StrX::string_to_metadata(query.getColumn("metadata").getString(), new_item->metadata_);
-        new_item->set_name(query.getColumn("name").getString());
-        new_item->parser_id_ = query.getColumn("parser_id").getUInt();
-        new_item->rarity_ = query.getColumn("rare").getInt();
-        if (!query.isColumnNull("stack")) new_item->stack_ = query.getColumn("stack").getUInt(); else new_item->stack_ = 1;
-        if (!query.isColumnNull("subtype")) new_subtype = static_cast<ItemSub>(query.getColumn("subtype").getInt());
-        if (!query.getColumn("tags").isNull()) StrX::string_to_tags(query.getColumn("tags").getString(), new_item->tags_);
-        if (!query.isColumnNull("type")) new_type = static_cast<ItemType>(query.getColumn("type").getInt());
-        if (!query.isColumnNull("value")) new_item->value_ = query.getColumn("value").getUInt();
-        new_item->weight_ = query.getColumn("weight").getUInt();
-        new_item->set_type(new_type, new_subtype);
+        std::map<std::string, std::string> metadata;
+        StrX::string_to_metadata(query.getColumn("metadata").getString(), metadata);
+        data.metadata = Symbols::intern_keys(metadata);
+        new_item->metadata_to_stats();
     }
-    else throw std::runtime_error("Could not retrieve data for item ID " + std::to_string(sql_id));
-
-    if (inventory_id)
-    {
-        new_item->new_inventory();
-        new_item->inv()->load(save_db, inventory_id);
-    }
-
+    new_item->set_name(query.getColumn("name").getString());
+    new_item->parser_id_ = query.getColumn("parser_id").getUInt();
+    data.rarity = query.getColumn("rare").getInt();
+    if (!query.isColumnNull("stack")) new_item->stack_ = query.getColumn("stack").getUInt(); else new_item->stack_ = 1;
+    if (!query.isColumnNull("subtype")) new_subtype = static_cast<ItemSub>(query.getColumn("subtype").getInt());
+    if (!query.getColumn("tags").isNull()) StrX::string_to_tags(query.getColumn("tags").getString(), data.tags);
+    if (!query.isColumnNull("type")) new_type = static_cast<ItemType>(query.getColumn("type").getInt());
+    if (!query.isColumnNull("value")) data.value = query.getColumn("value").getUInt();
+    data.weight = query.getColumn("weight").getUInt();
+    new_item->set_type(new_type, new_subtype);
+
+    // The saved columns that the shared data is built from make up the key for finding other Items with the same data. The charge and appraised value are saved in the metadata column, but each Item keeps its own, so they're left out of the key.
+    std::map<std::string, std::string> shared_metadata = new_item->metadata_with_stats();
+    shared_metadata.erase("appraised_value");
+    shared_metadata.erase("charge");
+    std::string data_key = StrX::metadata_to_string(shared_metadata) + '\0';
+    for (auto column : { "description", "name", "rare", "subtype", "tags", "type", "value", "weight" })
+        data_key += query.getColumn(column).getString() + '\0';
+    const auto it = loaded_data.find(data_key);
+    if (it == loaded_data.end()) loaded_data.insert(std::make_pair(data_key, new_item->data_));
+    else new_item->data_ = it->second;
     return new_item;
 }
 
 // Retrieves Item metadata.
 std::string Item::meta(const std::string &key) const
 {
-    if (metadata_.find(key) == metadata_.end()) return "";
-    std::string result = metadata_.at(key);
+    const auto it = data_->metadata.find(Symbols::find(key));
+    if (it == data_->metadata.end()) return "";
+    std::string result = it->second;
     StrX::find_and_replace(result, "_", " ");
     return result;
 }
@@ -231,7 +311,49 @@ int Item::meta_int(const std::string &key) const
 }
 
 // Accesses the metadata map directly. Use with caution!
-std::map<std::string, std::string>* Item::meta_raw() { return &metadata_; }
+std::map<uint32_t, std::string>* Item::meta_raw() { return &mutable_data().metadata; }
+
+// Moves any typed stats out of the metadata map and into their own fields.
+void Item::metadata_to_stats()
+{
+    ItemData &data = mutable_data();
+    for (auto it = data.metadata.begin(); it != data.metadata.end(); )
+    {
+        if (set_stat(Symbols::str(it->first), it->second)) it = data.metadata.erase(it);
+        else ++it;
+    }
+}
+
+// Returns the metadata map with the typed stats written back in, as it's stored in save files.
+std::map<std::string, std::string> Item::metadata_with_stats() const
+{
+    std::map<std::string, std::string> metadata = Symbols::str_keys(data_->metadata);
+    auto add_int = [&metadata](const std::string &key, int value) { if (value) metadata[key] = std::to_string(value); };
+    auto add_float = [&metadata](const std::string &key, float value) { if (value) metadata[key] = StrX::ftos(value, 1); };
+    add_float("ammo_power", data_->ammo_power);
+    add_int("bleed", data_->bleed);
+    add_int("block_mod", data_->block_mod);
+    add_int("capacity", data_->capacity);
+    add_int("appraised_value", appraised_value_);
+    add_int("charge", charge_);
+    add_int("crit", data_->crit);
+    add_int("damage_type", static_cast<int>(data_->damage_type));
+    add_int("dodge_mod", data_->dodge_mod);
+    add_int("parry_mod", data_->parry_mod);
+    add_int("poison", data_->poison);
+    add_int("power", data_->power);
+    add_int("slot", static_cast<int>(data_->equip_slot));
+    add_float("speed", data_->speed);
+    add_int("warmth", data_->warmth);
+    return metadata;
+}
+
+// Returns this Item's data for changing, first giving this Item its own copy if the data is still shared with other Items.
+ItemData& Item::mutable_data()
+{
+    if (data_.use_count() > 1) data_ = std::make_shared<ItemData>(*data_);
+    return *data_;
+}
 
 // Retrieves the name of thie Item.
 std::string Item::name(int flags) const
@@ -248,7 +370,7 @@ std::string Item::name(int flags) const
     const bool rarity = ((flags & Item::NAME_FLAG_RARE) == Item::NAME_FLAG_RARE);
 
     bool using_plural_name = false;
-    std::string ret = name_, plural_name = meta("plural_name");
+    std::string ret = data_->name, plural_name = meta("plural_name");
     if (plural && plural_name.size())
     {
         ret = plural_name;
@@ -269,7 +391,7 @@ std::string Item::name(int flags) const
     if (core_stats || full_stats)
     {
         std::string core_stats_str, full_stats_str;
-        switch (type_)
+        switch (data_->type)
         {
             case ItemType::ARMOUR: case ItemType::SHIELD: full_stats_str += " {c}[{U}" + std::to_string(power()) + "{c}]"; break;
             case ItemType::DRINK:
@@ -287,7 +409,7 @@ std::string Item::name(int flags) const
     if (rarity)
     {
         std::string colour_a = "{w}", colour_b = "{w}";
-        switch (rarity_)
+        switch (data_->rarity)
         {
             case 4: case 5: case 6: colour_a = "{U}"; colour_b = "{C}"; break;
             case 7: case 8: colour_a = "{g}"; colour_b = "{G}"; break;
@@ -295,8 +417,8 @@ std::string Item::name(int flags) const
             case 10: colour_a = "{y}"; colour_b = "{Y}"; break;
             case 11: colour_a = "{r}"; colour_b = "{R}"; break;
         }
-        if (rarity_ == 12) ret += " {M}[" + StrX::rainbow_text("RARE-12", "mB") + "{M}]";
-        else ret += " " + colour_a + "[" + colour_b + "RARE-" + std::to_string(rarity_) + colour_a + "]";
+        if (data_->rarity == 12) ret += " {M}[" + StrX::rainbow_text("RARE-12", "mB") + "{M}]";
+        else ret += " " + colour_a + "[" + colour_b + "RARE-" + std::to_string(data_->rarity) + colour_a + "]";
     }
     if (id) ret += " {B}{" + StrX::itos(parser_id_, 4) + "}";
     if (no_colour) ret = StrX::strip_ansi(ret);
@@ -310,19 +432,19 @@ void Item::new_inventory() { inventory_ = std::make_shared<Inventory>(Inventory:
 void Item::new_parser_id(uint8_t prefix) { parser_id_ = core()->rng()->rnd(0, 999) + (prefix * 1000); }
 
 // Returns the parry% modifier of this Item, if any.
-int Item::parry_mod() const { return meta_int("parry_mod"); }
+int Item::parry_mod() const { return data_->parry_mod; }
 
 // Retrieves the current ID of this Item, for parser differentiation.
 uint16_t Item::parser_id() const { return parser_id_; }
 
 // Returns thie poison chance of this Item, if any.
-int Item::poison() const { return meta_int("poison"); }
+int Item::poison() const { return data_->poison; }
 
 // Retrieves this Item's power.
-int Item::power() const { return meta_int("power"); }
+int Item::power() const { return data_->power; }
 
 // Retrieves this Item's rarity.
-int Item::rare() const { return rarity_; }
+int Item::rare() const { return data_->rarity; }
 
 // Saves the Item.
 void Item::save(std::shared_ptr<SQLite::Database> save_db, uint32_t owner_id)
@@ -330,32 +452,36 @@ void Item::save(std::shared_ptr<SQLite::Database> save_db, uint32_t owner_id)
     uint32_t inventory_id = 0;
     if (inventory_) inventory_id = inventory_->save(save_db);
 
-    SQLite::Statement query(*save_db, "INSERT INTO items ( description, inventory, metadata, name, owner_id, parser_id, rare, sql_id, stack, subtype, tags, type, value, weight ) VALUES ( :desc, :inventory, :meta, :name, :owner_id, :parser_id, :rare, :sql_id, :stack, :subtype, :tags, :type, :value, :weight )");
-    if (description_.size()) query.bind(":desc", description_);
+    SQLite::Statement &query = core()->sql_statement(save_db, "INSERT INTO items ( description, inventory, metadata, name, owner_id, parser_id, rare, sql_id, stack, subtype, tags, type, value, weight ) VALUES ( :desc, :inventory, :meta, :name, :owner_id, :parser_id, :rare, :sql_id, :stack, :subtype, :tags, :type, :value, :weight )");
+    if (data_->description.size()) query.bind(":desc", data_->description);
     if (inventory_id) query.bind(":inventory", inventory_id);
-    if (metadata_.size()) query.bind(":meta", StrX::metadata_to_string(metadata_));
-    query.bind(":name", name_);
+    const auto metadata = metadata_with_stats();
+    if (metadata.size()) query.bind(":meta", StrX::metadata_to_string(metadata));
+    query.bind(":name", data_->name);
     query.bind(":owner_id", owner_id);
     query.bind(":parser_id", parser_id_);
-    query.bind(":rare", rarity_);
+    query.bind(":rare", data_->rarity);
     query.bind(":sql_id", core()->sql_unique_id());
     if (stack_ != 1) query.bind(":stack", stack_);
-    if (type_sub_ != ItemSub::NONE) query.bind(":subtype", static_cast<int>(type_sub_));
-    if (tags_.size()) query.bind(":tags", StrX::tags_to_string(tags_));
-    if (type_ != ItemType::NONE) query.bind(":type", static_cast<int>(type_));
-    if (value_) query.bind(":value", value_);
-    query.bind(":weight", weight_);
+    if (data_->type_sub != ItemSub::NONE) query.bind(":subtype", static_cast<int>(data_->type_sub));
+    if (data_->tags.size()) query.bind(":tags", StrX::tags_to_string(data_->tags));
+    if (data_->type != ItemType::NONE) query.bind(":type", static_cast<int>(data_->type));
+    if (data_->value) query.bind(":value", data_->value);
+    query.bind(":weight", data_->weight);
     query.exec();
 }
 
+// Sets the value this Item has been appraised at.
+void Item::set_appraisal(int value) { appraised_value_ = value; }
+
 // Sets the charge level of this Item.
-void Item::set_charge(int new_charge) { set_meta("charge", new_charge); }
+void Item::set_charge(int new_charge) { charge_ = new_charge; }
 
 // Sets this Item's description.
-void Item::set_description(const std::string &desc) { description_ = desc; }
+void Item::set_description(const std::string &desc) { mutable_data().description = desc; }
 
 // Sets this Item's equipment slot.
-void Item::set_equip_slot(EquipSlot es) { set_meta("slot", static_cast<int>(es)); }
+void Item::set_equip_slot(EquipSlot es) { if (data_->equip_slot != es) mutable_data().equip_slot = es; }
 
 // Sets the liquid contents of this Item.
 void Item::set_liquid(const std::string &new_liquid) { set_meta("liquid", new_liquid); }
@@ -369,8 +495,11 @@ void Item::set_meta(const std::string &key, std::string value)
         return;
     }
     StrX::find_and_replace(value, " ", "_");
-    if (metadata_.find(key) == metadata_.end()) metadata_.insert(std::pair<std::string, std::string>(key, value));
-    else metadata_.at(key) = value;
+    if (set_stat(key, value)) return;
+    const uint32_t key_sym = Symbols::intern(key);
+    const auto it = data_->metadata.find(key_sym);
+    if (it == data_->metadata.end()) mutable_data().metadata.insert(std::make_pair(key_sym, value));
+    else if (it->second != value) mutable_data().metadata.at(key_sym) = value;
 }
 
 // As above, but with an integer value.
@@ -395,7 +524,7 @@ void Item::set_meta(const std::string &key, float value)
 }
 
 // Sets the name of this Item.
-void Item::set_name(const std::string &name) { name_ = name; }
+void Item::set_name(const std::string &name) { mutable_data().name = name; }
 
 // Sets this item's parser ID prefix.
 void Item::set_parser_id_prefix(uint8_t prefix)
@@ -411,42 +540,66 @@ void Item::set_parser_id_prefix(uint8_t prefix)
 }
 
 // Sets this Item's rarity.
-void Item::set_rare(int rarity) { rarity_ = rarity; }
+void Item::set_rare(int rarity) { mutable_data().rarity = rarity; }
 
 // Sets the stack size for this Item.
 void Item::set_stack(uint32_t size) { stack_ = size; }
 
+// Sets a typed stat from its metadata key and value. Returns false if the key isn't a typed stat.
+bool Item::set_stat(const std::string &key, const std::string &value)
+{
+    auto int_value = [&value]() -> int { return (value.size() ? std::stoi(value) : 0); };
+    if (key == "appraised_value") appraised_value_ = int_value();
+    else if (key == "bleed") mutable_data().bleed = int_value();
+    else if (key == "block_mod") mutable_data().block_mod = int_value();
+    else if (key == "capacity") mutable_data().capacity = int_value();
+    else if (key == "charge") charge_ = int_value();
+    else if (key == "crit") mutable_data().crit = int_value();
+    else if (key == "damage_type") mutable_data().damage_type = static_cast<DamageType>(int_value());
+    else if (key == "dodge_mod") mutable_data().dodge_mod = int_value();
+    else if (key == "parry_mod") mutable_data().parry_mod = int_value();
+    else if (key == "poison") mutable_data().poison = int_value();
+    else if (key == "power") mutable_data().power = int_value();
+    else if (key == "slot") mutable_data().equip_slot = static_cast<EquipSlot>(int_value());
+    else if (key == "warmth") mutable_data().warmth = int_value();
+    else if (key == "ammo_power") mutable_data().ammo_power = (value.size() ? std::stof(value) : 0);
+    else if (key == "speed") mutable_data().speed = (value.size() ? std::stof(value) : 0);
+    else return false;
+    return true;
+}
+
 // Sets a tag on this Item.
 void Item::set_tag(ItemTag the_tag)
 {
-    if (tags_.count(the_tag) > 0) return;
-    tags_.insert(the_tag);
+    if (data_->tags.test(the_tag)) return;
+    mutable_data().tags.insert(the_tag);
 }
 
 // Sets the type of this Item.
 void Item::set_type(ItemType type, ItemSub sub)
 {
-    type_ = type;
-    type_sub_ = sub;
+    ItemData &data = mutable_data();
+    data.type = type;
+    data.type_sub = sub;
 }
 
 // Sets this Item's value.
-void Item::set_value(uint32_t val) { value_ = val; }
+void Item::set_value(uint32_t val) { mutable_data().value = val; }
 
 // Sets this Item's weight.
-void Item::set_weight(uint32_t pacs) { weight_ = pacs; }
+void Item::set_weight(uint32_t pacs) { mutable_data().weight = pacs; }
 
 // Retrieves the speed of this Item.
-float Item::speed() const { return meta_float("speed"); }
+float Item::speed() const { return data_->speed; }
 
 // Splits an Item into a stack.
 std::shared_ptr<Item> Item::split(int split_count)
 {
     const bool stackable = tag(ItemTag::Stackable);
-    if (split_count < 0) throw std::runtime_error("Invalid item stack split: " + name_);
+    if (split_count < 0) throw std::runtime_error("Invalid item stack split: " + data_->name);
     if (!split_count || (split_count == 1 && !stackable) || static_cast<int64_t>(split_count) == stack_) return nullptr;
-    if (!stackable) throw std::runtime_error("Attempt to split unstackable item: " + name_);
-    if (static_cast<unsigned int>(split_count) > stack_) throw std::runtime_error("Invalid stack split size: " + name_);
+    if (!stackable) throw std::runtime_error("Attempt to split unstackable item: " + data_->name);
+    if (static_cast<unsigned int>(split_count) > stack_) throw std::runtime_error("Invalid stack split size: " + data_->name);
     auto new_item = std::make_shared<Item>(*this);
     new_item->stack_ = split_count;
     stack_ -= split_count;
@@ -481,30 +634,30 @@ std::string Item::stack_name(int stack_size, int flags)
 }
 
 // Returns the ItemSub (sub-type) of this Item.
-ItemSub Item::subtype() const { return type_sub_; }
+ItemSub Item::subtype() const { return data_->type_sub; }
 
 // Checks if a tag is set on this Item.
-bool Item::tag(ItemTag the_tag) const { return (tags_.count(the_tag) > 0); }
+bool Item::tag(ItemTag the_tag) const { return (data_->tags.test(the_tag)); }
 
 // Returns the ItemType of this Item.
-ItemType Item::type() const { return type_; }
+ItemType Item::type() const { return data_->type; }
 
 // The Item's value in money.
 uint32_t Item::value(bool individual) const
 {
-    if (individual || !tag(ItemTag::Stackable)) return value_;
-    else return value_ * stack_;
+    if (individual || !tag(ItemTag::Stackable)) return data_->value;
+    else return data_->value * stack_;
 }
 
 // The Item's warmth rating, if any.
-int Item::warmth() const { return meta_int("warmth"); }
+int Item::warmth() const { return data_->warmth; }
 
 // The Item's weight, in pacs.
 uint32_t Item::weight(bool individual) const
 {
     uint32_t water_weight = 0, container_weight = 0;
-    if (type_ == ItemType::DRINK) water_weight = std::round(charge() * WATER_WEIGHT);
+    if (data_->type == ItemType::DRINK) water_weight = std::round(charge() * WATER_WEIGHT);
     if (inventory_) container_weight = inventory_->weight();
-    if (individual || !tag(ItemTag::Stackable)) return weight_ + water_weight + container_weight;
-    else return (weight_ + water_weight + container_weight) * stack_;
+    if (individual || !tag(ItemTag::Stackable)) return data_->weight + water_weight + container_weight;
+    else return (data_->weight + water_weight + container_weight) * stack_;
 }
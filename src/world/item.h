@@ -5,11 +5,13 @@
 #define GREAVE_WORLD_ITEM_H_
 
 #include "3rdparty/SQLiteCpp/Database.h"
+#include "3rdparty/SQLiteCpp/Statement.h"
+#include "core/data-cache.h"
+#include "core/tag-set.h"
 
 #include <cstdint>
 #include <map>
 #include <memory>
-#include <set>
 #include <string>
 
 class Inventory;    // Forward declarations are bad, I know, but this is the only way to avoid item.h and inventory.h trying to include each other.
@@ -59,6 +61,33 @@ enum class ItemTag : uint16_t { _None = 0,  // Do not use this tag, it's just a
     TavernOnly,         // This item will have to be left behind if you leave a tavern.
 };
 
+// The parts of an Item that rarely change once it's been created. Items copied from the same template share the same ItemData, until one of them changes any of it.
+struct ItemData
+{
+    float                               ammo_power = 0;     // The damage multiplier for ammunition.
+    int                                 bleed = 0;          // The bleed chance of this Item.
+    int                                 block_mod = 0;      // The block% modifier for this Item.
+    int                                 capacity = 0;       // The capacity of this Item.
+    int                                 crit = 0;           // The critical power of this Item.
+    DamageType                          damage_type = static_cast<DamageType>(0);   // The damage type of this Item.
+    std::string                         description;        // The description of this Item.
+    int                                 dodge_mod = 0;      // The dodge% modifier for this Item.
+    EquipSlot                           equip_slot = EquipSlot::NONE;   // The slot this Item equips in, if any.
+    std::map<uint32_t, std::string>     metadata;           // The Item's metadata, if any, keyed by symbol. Stats with their own fields (power, speed, etc.) are not kept here.
+    std::string                         name;               // The name of this Item!
+    int                                 parry_mod = 0;      // The parry% modifier for this Item.
+    int                                 poison = 0;         // The poison chance of this Item.
+    int                                 power = 0;          // The power of this Item.
+    uint8_t                             rarity = 1;         // The rarity of this Item.
+    float                               speed = 0;          // The speed of this Item.
+    TagSet<ItemTag, 64, 0>              tags;               // Any and all ItemTags on this Item.
+    ItemType                            type = ItemType::NONE;      // The primary type of this Item.
+    ItemSub                             type_sub = ItemSub::NONE;   // The subtype of this Item, if any.
+    uint32_t                            value = 0;          // The value of this Item, if any.
+    int                                 warmth = 0;         // The warmth rating of this Item.
+    uint32_t                            weight = 0;         // The weight of this Item.
+};
+
 class Item
 {
 public:
@@ -76,14 +105,18 @@ public:
 
     static constexpr float  WATER_WEIGHT =                  58.68f;     // The weight of 1 unit of water.
     static const char       SQL_ITEMS[];                                // The SQL table construction string for saving items.
+    static const char       SQL_ITEMS_INDEX[];                          // The SQL index construction string for the items table's owner IDs.
 
                 Item();                                     // Constructor, sets default values.
     float       ammo_power() const;                         // The damage multiplier for ammunition.
+    int         appraisal() const;                          // Returns the value this Item has been appraised at, or 0 if it hasn't been appraised yet.
     int         appraised_value();                          // Attempts to guess the value of an item.
     float       armour(int bonus_power = 0) const;          // Returns the armour damage reduction value of this Item, if any.
     void        assign_inventory(std::shared_ptr<Inventory> inventory); // Assigns another inventory to this item. Use with caution.
     int         bleed() const;                              // Returns thie bleed chance of this Item, if any.
     int         block_mod() const;                          // Returns the block modifier% for this Item, if any.
+    void        cache_read(DataCache &cache);               // Reads this Item's template data from the data cache.
+    void        cache_write(DataCache &cache) const;        // Writes this Item's template data to the data cache.
     int         capacity() const;                           // Returns this Item's capacity, if any.
     int         charge() const;                             // Returns this Item's charge, if any.
     void        clear_meta(const std::string &key);         // Clears a metatag from an Item. Use with caution!
@@ -97,11 +130,11 @@ public:
     const std::shared_ptr<Inventory> inv();                 // The inventory of this item, or nullptr if none exists.
     bool        is_identical(std::shared_ptr<Item> item) const; // Checks if this Item is identical to another (except stack size).
     std::string liquid_type() const;                        // Returns the liquid type contained in this Item, if any.
-    static std::shared_ptr<Item> load(std::shared_ptr<SQLite::Database> save_db, uint32_t sql_id);  // Loads a new Item from the save file.
+    static std::shared_ptr<Item> load(SQLite::Statement &query, uint32_t &inventory_id, std::map<std::string, std::shared_ptr<ItemData>> &loaded_data);  // Loads a new Item from a row of the save file's items table. Items saved with the same data share it once loaded, as they did when first copied from their template.
     std::string meta(const std::string &key) const;         // Retrieves Item metadata.
     float       meta_float(const std::string &key) const;   // Retrieves metadata, in float format.
     int         meta_int(const std::string &key) const;     // Retrieves metadata, in int format.
-    std::map<std::string, std::string>* meta_raw();         // Accesses the metadata map directly. Use with caution!
+    std::map<uint32_t, std::string>*    meta_raw();         // Accesses the metadata map directly, keyed by symbol. Use with caution!
     std::string name(int flags = 0) const;                  // Retrieves the name of thie Item.
     void        new_inventory();                            // Creates an inventory for this item.
     void        new_parser_id(uint8_t prefix);              // Generates a new parser ID for this Item.
@@ -111,6 +144,7 @@ public:
     int         power() const;                              // Retrieves this Item's power.
     int         rare() const;                               // Retrieves this Item's rarity.
     void        save(std::shared_ptr<SQLite::Database> save_db, uint32_t owner_id); // Saves the Item to the save file.
+    void        set_appraisal(int value);                   // Sets the value this Item has been appraised at.
     void        set_charge(int new_charge);                 // Sets the charge level of this Item.
     void        set_description(const std::string &desc);   // Sets this Item's description.
     void        set_equip_slot(EquipSlot es);               // Sets this Item's equipment slot.
@@ -144,18 +178,17 @@ private:
     static constexpr int    APPRAISAL_XP_EASY =             1;      // The amount of appraisal XP gained for an easy item appraisal.
     static constexpr int    APPRAISAL_XP_HARD =             5;      // The amount of appraisal XP gained for a difficult item appraisal.
 
-    std::string                         description_;   // The description of this Item.
+    std::map<std::string, std::string>  metadata_with_stats() const;    // Returns the metadata map with the typed stats written back in, as it's stored in save files.
+    void        metadata_to_stats();                        // Moves any typed stats out of the metadata map and into their own fields.
+    ItemData&   mutable_data();                             // Returns this Item's data for changing, first giving this Item its own copy if the data is still shared with other Items.
+    bool        set_stat(const std::string &key, const std::string &value); // Sets a typed stat from its metadata key and value. Returns false if the key isn't a typed stat.
+
+    int                                 appraised_value_; // The value this Item has been appraised at, if any. Like the charge, each Item has its own, and it's only written into the metadata column when saving.
+    int                                 charge_;        // The charge of this Item. This changes often enough that each Item has its own, rather than it being part of the shared data.
+    std::shared_ptr<ItemData>           data_;          // This Item's data, which may be shared with other Items. Use mutable_data() to change it.
     std::shared_ptr<Inventory>          inventory_;     // The contents of this item, if any.
-    std::map<std::string, std::string>  metadata_;      // The Item's metadata, if any.
-    std::string                         name_;          // The name of this Item!
     uint16_t                            parser_id_;     // The semi-unique ID of this Item, for parser differentiation.
-    uint8_t                             rarity_;        // The rarity of this Item.
     uint32_t                            stack_;         // If this Item can be stacked, this is how many is in the stack.
-    std::set<ItemTag>                   tags_;          // Any and all ItemTags on this Item.
-    ItemType                            type_;          // The primary type of this Item.
-    ItemSub                             type_sub_;      // The subtype of this Item, if any.
-    uint32_t                            value_;         // The value of this Item, if any.
-    uint32_t                            weight_;        // The weight of this Item.
 };
 
 #endif  // GREAVE_WORLD_ITEM_H_
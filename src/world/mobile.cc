@@ -5,12 +5,18 @@
 #include "actions/combat.h"
 #include "core/core.h"
 #include "core/strx.h"
+#include "core/symbols.h"
 #include "world/mobile.h"
 
+#include <algorithm>
+
 
 // The SQL table construction string for the buffs table.
 constexpr char Buff::SQL_BUFFS[] = "CREATE TABLE buffs ( owner INTEGER, power INTEGER, sql_id INTEGER PRIMARY KEY UNIQUE NOT NULL, time INTEGER, type INTEGER NOT NULL )";
 
+// The SQL index construction string for the buffs table's owner IDs.
+constexpr char Buff::SQL_BUFFS_INDEX[] = "CREATE INDEX buffs_owner ON buffs ( owner )";
+
 // The SQL table construction string for the mobiles table.
 constexpr char Mobile::SQL_MOBILES[] = "CREATE TABLE mobiles ( action_timer REAL, equipment INTEGER UNIQUE, gender INTEGER, hostility TEXT, hp INTEGER NOT NULL, hp_max INTEGER NOT NULL, id INTEGER UNIQUE NOT NULL, inventory INTEGER UNIQUE, location INTEGER NOT NULL, metadata TEXT, name TEXT, parser_id INTEGER, score INTEGER, spawn_room INTEGER, species TEXT NOT NULL, sql_id INTEGER PRIMARY KEY UNIQUE NOT NULL, stance INTEGER, tags TEXT )";
 
@@ -25,10 +31,20 @@ std::shared_ptr<Buff> Buff::load(SQLite::Statement &query)
     return new_buff;
 }
 
+// Loads every Buff in the save file in a single pass, grouped by the SQL ID of their owners.
+std::map<uint32_t, std::vector<std::shared_ptr<Buff>>> Buff::load_all(std::shared_ptr<SQLite::Database> save_db)
+{
+    std::map<uint32_t, std::vector<std::shared_ptr<Buff>>> buffs;
+    SQLite::Statement query(*save_db, "SELECT * FROM buffs ORDER BY sql_id ASC");
+    while (query.executeStep())
+        buffs[query.getColumn("owner").getUInt()].push_back(load(query));
+    return buffs;
+}
+
 // Saves this Buff to a save file.
 void Buff::save(std::shared_ptr<SQLite::Database> save_db, uint32_t owner_id)
 {
-    SQLite::Statement query(*save_db, "INSERT INTO BUFFS ( owner, power, sql_id, time, type ) VALUES ( :owner, :power, :sql_id, :time, :type )");
+    SQLite::Statement &query = core()->sql_statement(save_db, "INSERT INTO BUFFS ( owner, power, sql_id, time, type ) VALUES ( :owner, :power, :sql_id, :time, :type )");
     query.bind(":owner", owner_id);
     if (power) query.bind(":power", power);
     query.bind(":sql_id", core()->sql_unique_id());
@@ -39,7 +55,7 @@ void Buff::save(std::shared_ptr<SQLite::Database> save_db, uint32_t owner_id)
 
 
 // Constructor, sets default values.
-Mobile::Mobile() : action_timer_(0), equipment_(std::make_shared<Inventory>(Inventory::PID_PREFIX_EQUIPMENT)), gender_(Gender::IT), id_(0), inventory_(std::make_shared<Inventory>(Inventory::PID_PREFIX_INVENTORY)), location_(0), parser_id_(0), score_(0), spawn_room_(0), stance_(CombatStance::BALANCED)
+Mobile::Mobile() : action_timer_(0), dirty_(true), equipment_(std::make_shared<Inventory>(Inventory::PID_PREFIX_EQUIPMENT)), gender_(Gender::IT), id_(0), inventory_(std::make_shared<Inventory>(Inventory::PID_PREFIX_INVENTORY)), location_(0), parser_id_(0), score_(0), spawn_room_(0), species_(0), stance_(CombatStance::BALANCED)
 {
     hp_[0] = hp_[1] = HP_DEFAULT;
 }
@@ -56,7 +72,14 @@ void Mobile::add_hostility(uint32_t mob_id)
 }
 
 // Adds a second to this Mobile's action timer.
-void Mobile::add_second() { if (++action_timer_ > ACTION_TIMER_CAP_MAX) action_timer_ = ACTION_TIMER_CAP_MAX; }
+void Mobile::add_second() { add_seconds(1); }
+
+// Adds a number of seconds to this Mobile's action timer, as if add_second() had been called that many times.
+void Mobile::add_seconds(uint32_t seconds)
+{
+    action_timer_ += seconds;
+    if (action_timer_ > ACTION_TIMER_CAP_MAX) action_timer_ = ACTION_TIMER_CAP_MAX;
+}
 
 // Adds to this Mobile's score.
 void Mobile::add_score(int score) { score_ += score; }
@@ -117,6 +140,32 @@ uint16_t Mobile::buff_time(Buff::Type type) const
     else return 0;
 }
 
+// Reads this Mobile's template data from the data cache.
+void Mobile::cache_read(DataCache &cache)
+{
+    name_ = cache.read_string();
+    species_ = Symbols::intern(cache.read_string());
+    hp_[0] = cache.read_int();
+    hp_[1] = cache.read_int();
+    score_ = cache.read_uint();
+    gender_ = static_cast<Gender>(cache.read_uint());
+    tags_.set_bits(false, cache.read_uint());
+    metadata_ = Symbols::intern_keys(cache.read_map());
+}
+
+// Writes this Mobile's template data to the data cache.
+void Mobile::cache_write(DataCache &cache) const
+{
+    cache.write_string(name_);
+    cache.write_string(Symbols::str(species_));
+    cache.write_int(hp_[0]);
+    cache.write_int(hp_[1]);
+    cache.write_uint(score_);
+    cache.write_uint(static_cast<uint8_t>(gender_));
+    cache.write_uint(tags_.bits(false));
+    cache.write_map(Symbols::str_keys(metadata_));
+}
+
 // Checks if this Mobile has enough action timer built up to perform an action.
 bool Mobile::can_perform_action(float time) const { return action_timer_ >= time; }
 
@@ -137,12 +186,12 @@ void Mobile::clear_buff(Buff::Type type)
 }
 
 // Clears a metatag from an Mobile. Use with caution!
-void Mobile::clear_meta(const std::string &key) { metadata_.erase(key); }
+void Mobile::clear_meta(const std::string &key) { metadata_.erase(Symbols::find(key)); }
 
 // Clears a MobileTag from this Mobile.
 void Mobile::clear_tag(MobileTag the_tag)
 {
-    if (!(tags_.count(the_tag) > 0)) return;
+    if (!tags_.test(the_tag)) return;
     tags_.erase(the_tag);
 }
 
@@ -191,6 +240,9 @@ void Mobile::die(bool death_message)
     world->remove_mobile(id_);
 }
 
+// Checks if this Mobile has gone dormant since it was last saved or loaded.
+bool Mobile::dirty() const { return dirty_; }
+
 // Returns the modified chance to dodge for this Mobile, based on equipped gear.
 float Mobile::dodge_mod() const
 {
@@ -255,6 +307,13 @@ const std::shared_ptr<Inventory> Mobile::inv() const { return inventory_; }
 // Checks if this Mobile is dead.
 bool Mobile::is_dead() const { return hp_[0] <= 0; }
 
+// Checks if this Mobile is dormant, in a Room away from the player.
+bool Mobile::is_dormant() const
+{
+    static const uint32_t META_DORMANT_SINCE = Symbols::intern("dormant_since");
+    return metadata_.count(META_DORMANT_SINCE);
+}
+
 // Is this Mobile hostile to the player?
 bool Mobile::is_hostile() const
 {
@@ -267,42 +326,40 @@ bool Mobile::is_hostile() const
 // Returns true if this Mobile is a Player, false if not.
 bool Mobile::is_player() const { return false; }
 
-// Loads a Mobile.
-uint32_t Mobile::load(std::shared_ptr<SQLite::Database> save_db, uint32_t sql_id)
+// Loads a Mobile from a row of the save file's mobiles table, returns its SQL ID.
+uint32_t Mobile::load(SQLite::Statement &query, const std::map<uint32_t, std::vector<std::shared_ptr<Item>>> &items, const std::map<uint32_t, std::vector<std::shared_ptr<Buff>>> &buffs)
 {
     uint32_t inventory_id = 0, equipment_id = 0;
-    SQLite::Statement query(*save_db, "SELECT * FROM mobiles WHERE sql_id = :sql_id");
-    query.bind(":sql_id", sql_id);
-    if (query.executeStep())
+    const uint32_t sql_id = query.getColumn("sql_id").getUInt();
+    if (!query.isColumnNull("action_timer")) action_timer_ = query.getColumn("action_timer").getDouble();
+    if (!query.isColumnNull("equipment")) equipment_id = query.getColumn("equipment").getUInt();
+    if (!query.isColumnNull("gender")) gender_ = static_cast<Gender>(query.getColumn("gender").getInt());
+    if (!query.isColumnNull("hostility")) hostility_ = StrX::stoi_vec(StrX::string_explode(query.getColumn("hostility").getString(), " "));
+    hp_[0] = query.getColumn("hp").getInt();
+    hp_[1] = query.getColumn("hp_max").getInt();
+    id_ = query.getColumn("id").getUInt();
+    if (!query.isColumnNull("inventory")) inventory_id = query.getColumn("inventory").getUInt();
+    location_ = query.getColumn("location").getUInt();
+    if (!query.getColumn("metadata").isNull())
     {
-        if (!query.isColumnNull("action_timer")) action_timer_ = query.getColumn("action_timer").getDouble();
-        if (!query.isColumnNull("equipment")) equipment_id = query.getColumn("equipment").getUInt();
-        if (!query.isColumnNull("gender")) gender_ = static_cast<Gender>(query.getColumn("gender").getInt());
-        if (!query.isColumnNull("hostility")) hostility_ = StrX::stoi_vec(StrX::string_explode(query.getColumn("hostility").getString(), " "));
-        hp_[0] = query.getColumn("hp").getInt();
-        hp_[1] = query.getColumn("hp_max").getInt();
-        id_ = query.getColumn("id").getUInt();
-        if (!query.isColumnNull("inventory")) inventory_id = query.getColumn("inventory").getUInt();
-        location_ = query.getColumn("location").getUInt();
-        if (!query.getColumn("metadata").isNull()) StrX::string_to_metadata(query.getColumn("metadata").getString(), metadata_);
-        if (!query.isColumnNull("name")) name_ = query.getColumn("name").getString();
-        if (!query.isColumnNull("parser_id")) parser_id_ = query.getColumn("parser_id").getInt();
-        if (!query.isColumnNull("score")) score_ = query.getColumn("score").getUInt();
-        if (!query.isColumnNull("spawn_room")) spawn_room_ = query.getColumn("spawn_room").getUInt();
-        species_ = query.getColumn("species").getString();
-        if (!query.isColumnNull("stance")) stance_ = static_cast<CombatStance>(query.getColumn("stance").getInt());
-        if (!query.isColumnNull("tags")) StrX::string_to_tags(query.getColumn("tags").getString(), tags_);
+        std::map<std::string, std::string> metadata;
+        StrX::string_to_metadata(query.getColumn("metadata").getString(), metadata);
+        metadata_ = Symbols::intern_keys(metadata);
     }
-    else throw std::runtime_error("Could not load mobile data!");
+    if (!query.isColumnNull("name")) name_ = query.getColumn("name").getString();
+    if (!query.isColumnNull("parser_id")) parser_id_ = query.getColumn("parser_id").getInt();
+    if (!query.isColumnNull("score")) score_ = query.getColumn("score").getUInt();
+    if (!query.isColumnNull("spawn_room")) spawn_room_ = query.getColumn("spawn_room").getUInt();
+    species_ = Symbols::intern(query.getColumn("species").getString());
+    if (!query.isColumnNull("stance")) stance_ = static_cast<CombatStance>(query.getColumn("stance").getInt());
+    if (!query.isColumnNull("tags")) StrX::string_to_tags(query.getColumn("tags").getString(), tags_);
 
-    if (inventory_id) inventory_->load(save_db, inventory_id);
-    if (equipment_id) equipment_->load(save_db, equipment_id);
+    if (inventory_id) inventory_->load(items, inventory_id);
+    if (equipment_id) equipment_->load(items, equipment_id);
 
     // Load any and all buffs/debuffs.
-    SQLite::Statement buff_query(*save_db, "SELECT * FROM buffs WHERE owner = :sql_id");
-    buff_query.bind(":sql_id", sql_id);
-    while (buff_query.executeStep())
-        buffs_.push_back(Buff::load(buff_query));
+    const auto it = buffs.find(sql_id);
+    if (it != buffs.end()) buffs_ = it->second;
 
     return sql_id;
 }
@@ -310,14 +367,23 @@ uint32_t Mobile::load(std::shared_ptr<SQLite::Database> save_db, uint32_t sql_id
 // Retrieves the location of this Mobile, in the form of a Room ID.
 uint32_t Mobile::location() const { return location_; }
 
+// Marks this Mobile as dormant, so it stops being processed until its Room becomes active again.
+void Mobile::make_dormant()
+{
+    if (is_player() || is_dormant()) return;
+    set_meta_uint("dormant_since", core()->world()->time_weather()->time_passed());
+    dirty_ = true;
+}
+
 // The maximum weight this Mobile can carry.
 uint32_t Mobile::max_carry() const { return BASE_CARRY_WEIGHT; }
 
 // Retrieves Mobile metadata.
 std::string Mobile::meta(const std::string &key) const
 {
-    if (metadata_.find(key) == metadata_.end()) return "";
-    std::string result = metadata_.at(key);
+    const auto it = metadata_.find(Symbols::find(key));
+    if (it == metadata_.end()) return "";
+    std::string result = it->second;
     StrX::find_and_replace(result, "_", " ");
     return result;
 }
@@ -347,7 +413,7 @@ uint32_t Mobile::meta_uint(const std::string &key) const
 }
 
 // Accesses the metadata map directly. Use with caution!
-std::map<std::string, std::string>* Mobile::meta_raw() { return &metadata_; }
+std::map<uint32_t, std::string>* Mobile::meta_raw() { return &metadata_; }
 
 // Retrieves the name of this Mobile.
 std::string Mobile::name(int flags) const
@@ -416,6 +482,13 @@ std::string Mobile::name(int flags) const
     return ret;
 }
 
+// Gives this Mobile its own empty inventory and equipment, rather than sharing those of the Mobile it was copied from.
+void Mobile::new_inventories()
+{
+    equipment_ = std::make_shared<Inventory>(Inventory::PID_PREFIX_EQUIPMENT);
+    inventory_ = std::make_shared<Inventory>(Inventory::PID_PREFIX_INVENTORY);
+}
+
 // Generates a new parser ID for this Item.
 void Mobile::new_parser_id() { parser_id_ = core()->rng()->rnd(0, 999) + (1000 * Inventory::PID_PREFIX_MOBILE); }
 
@@ -469,11 +542,12 @@ int Mobile::restore_hp(int amount)
 // Saves this Mobile.
 uint32_t Mobile::save(std::shared_ptr<SQLite::Database> save_db)
 {
+    dirty_ = false;
     const uint32_t inventory_id = inventory_->save(save_db);
     const uint32_t equipment_id = equipment_->save(save_db);
 
     const uint32_t sql_id = core()->sql_unique_id();
-    SQLite::Statement query(*save_db, "INSERT INTO mobiles ( action_timer, equipment, gender, hostility, hp, hp_max, id, inventory, location, metadata, name, parser_id, score, spawn_room, species, sql_id, stance, tags ) VALUES ( :action_timer, :equipment, :gender, :hostility, :hp, :hp_max, :id, :inventory, :location, :metadata, :name, :parser_id, :score, :spawn_room, :species, :sql_id, :stance, :tags )");
+    SQLite::Statement &query = core()->sql_statement(save_db, "INSERT INTO mobiles ( action_timer, equipment, gender, hostility, hp, hp_max, id, inventory, location, metadata, name, parser_id, score, spawn_room, species, sql_id, stance, tags ) VALUES ( :action_timer, :equipment, :gender, :hostility, :hp, :hp_max, :id, :inventory, :location, :metadata, :name, :parser_id, :score, :spawn_room, :species, :sql_id, :stance, :tags )");
     if (action_timer_) query.bind(":action_timer", action_timer_);
     if (equipment_id) query.bind(":equipment", equipment_id);
     if (gender_ != Gender::IT) query.bind(":gender", static_cast<int>(gender_));
@@ -483,12 +557,12 @@ uint32_t Mobile::save(std::shared_ptr<SQLite::Database> save_db)
     query.bind(":id", id_);
     if (inventory_id) query.bind(":inventory", inventory_id);
     query.bind(":location", location_);
-    if (metadata_.size()) query.bind(":metadata", StrX::metadata_to_string(metadata_));
+    if (metadata_.size()) query.bind(":metadata", StrX::metadata_to_string(Symbols::str_keys(metadata_)));
     if (name_.size()) query.bind(":name", name_);
     if (parser_id_) query.bind(":parser_id", parser_id_);
     if (score_) query.bind(":score", score_);
     if (spawn_room_) query.bind(":spawn_room", spawn_room_);
-    query.bind(":species", species_);
+    query.bind(":species", Symbols::str(species_));
     query.bind(":sql_id", sql_id);
     if (stance_ != CombatStance::BALANCED) query.bind(":stance", static_cast<int>(stance_));
     const std::string tags = StrX::tags_to_string(tags_);
@@ -529,6 +603,9 @@ void Mobile::set_buff(Buff::Type type, uint16_t time, uint32_t power, bool addit
     buffs_.push_back(new_buff);
 }
 
+// Marks this Mobile as needing (or not needing) to be saved while dormant.
+void Mobile::set_dirty(bool is_dirty) { dirty_ = is_dirty; }
+
 // Sets the gender of this Mobile.
 void Mobile::set_gender(Gender gender) { gender_ = gender; }
 
@@ -545,8 +622,10 @@ void Mobile::set_id(uint32_t new_id) { id_ = new_id; }
 // Sets the location of this Mobile with a Room ID.
 void Mobile::set_location(uint32_t rooid_)
 {
+    const uint32_t old_location = location_;
     location_ = rooid_;
     if (is_player()) core()->world()->recalc_active_rooms();
+    else core()->world()->update_mob_location(this, old_location);
 }
 
 // As above, but with a string Room ID.
@@ -560,8 +639,7 @@ void Mobile::set_location(const std::string &rooid_)
 void Mobile::set_meta(const std::string &key, std::string value)
 {
     StrX::find_and_replace(value, " ", "_");
-    if (metadata_.find(key) == metadata_.end()) metadata_.insert(std::pair<std::string, std::string>(key, value));
-    else metadata_.at(key) = value;
+    metadata_[Symbols::intern(key)] = value;
 }
 
 // As above, but with an integer value.
@@ -580,7 +658,7 @@ void Mobile::set_name(const std::string &name) { name_ = name; }
 void Mobile::set_spawn_room(uint32_t id) { spawn_room_ = id; }
 
 // Sets the species of this Mobile.
-void Mobile::set_species(const std::string &species) { species_ = species; }
+void Mobile::set_species(const std::string &species) { species_ = Symbols::intern(species); }
 
 // Sets this Mobile's combat stance.
 void Mobile::set_stance(CombatStance stance) { stance_ = stance; }
@@ -588,18 +666,18 @@ void Mobile::set_stance(CombatStance stance) { stance_ = stance; }
 // Sets a MobileTag on this Mobile.
 void Mobile::set_tag(MobileTag the_tag)
 {
-    if (tags_.count(the_tag) > 0) return;
+    if (tags_.test(the_tag)) return;
     tags_.insert(the_tag);
 }
 
 // Checks the species of this Mobile.
-std::string Mobile::species() const { return species_; }
+std::string Mobile::species() const { return Symbols::str(species_); }
 
 // Checks this Mobile's combat stance.
 CombatStance Mobile::stance() const { return stance_; }
 
 // Checks if a MobileTag is set on this Mobile.
-bool Mobile::tag(MobileTag the_tag) const { return (tags_.count(the_tag) > 0); }
+bool Mobile::tag(MobileTag the_tag) const { return (tags_.test(the_tag)); }
 
 // Triggers a single bleed tick.
 bool Mobile::tick_bleed(uint32_t power, uint16_t time)
@@ -732,3 +810,30 @@ bool Mobile::using_shield() const
     if (off_hand && off_hand->type() == ItemType::SHIELD) return true;
     return false;
 }
+
+// Wakes up a dormant Mobile, catching up on the time that passed while it was dormant.
+void Mobile::wake_up()
+{
+    if (!is_dormant()) return;
+    const uint32_t time_dormant = core()->world()->time_weather()->time_passed_since(meta_uint("dormant_since"));
+    clear_meta("dormant_since");
+
+    // Charge up the action timer, as if add_second() had been called the whole time.
+    add_seconds(time_dormant);
+
+    // Run any buff ticks that were missed. There's no need to go any further than the longest-lasting timed buff.
+    uint32_t buff_ticks = time_dormant / TimeWeather::HEARTBEAT_TIMERS[TimeWeather::Heartbeat::BUFFS];
+    uint16_t longest_buff = 0;
+    for (auto b : buffs_)
+        if (b->time != UINT16_MAX && b->time > longest_buff) longest_buff = b->time;
+    if (buff_ticks > longest_buff) buff_ticks = longest_buff;
+    while (buff_ticks--)
+    {
+        tick_buffs();
+        if (is_dead()) return;
+    }
+
+    // Regenerate hit points, unless the Mobile is still recovering from recent damage.
+    const uint32_t regen_ticks = time_dormant / TimeWeather::HEARTBEAT_TIMERS[TimeWeather::Heartbeat::HP_REGEN];
+    if (regen_ticks && !has_buff(Buff::Type::RECENT_DAMAGE) && hp_[0] > 0 && hp_[0] < hp_[1]) hp_[0] += std::min<int>(regen_ticks, hp_[1] - hp_[0]);
+}
@@ -4,12 +4,13 @@
 #ifndef GREAVE_WORLD_MOBILE_H_
 #define GREAVE_WORLD_MOBILE_H_
 
+#include "core/data-cache.h"
+#include "core/tag-set.h"
 #include "world/inventory.h"
 
 #include <cstdint>
 #include <map>
 #include <memory>
-#include <set>
 #include <string>
 #include <vector>
 
@@ -77,8 +78,10 @@ struct Buff
     enum class Type : uint8_t { NONE, BLEED, CAREFUL_AIM, CD_CAREFUL_AIM, CD_EYE_FOR_AN_EYE, CD_GRIT, CD_HEADLONG_STRIKE, CD_LADY_LUCK, CD_QUICK_ROLL, CD_RAPID_STRIKE, CD_SHIELD_WALL, CD_SNAP_SHOT, EYE_FOR_AN_EYE, GRIT, POISON, QUICK_ROLL, RECENT_DAMAGE, RECENTLY_FLED, SHIELD_WALL };
 
     static const char SQL_BUFFS[];  // The SQL table construction string for the buffs table.
+    static const char SQL_BUFFS_INDEX[];    // The SQL index construction string for the buffs table's owner IDs.
 
     static std::shared_ptr<Buff>    load(SQLite::Statement &query); // Loads this Buff from a save file.
+    static std::map<uint32_t, std::vector<std::shared_ptr<Buff>>> load_all(std::shared_ptr<SQLite::Database> save_db);  // Loads every Buff in the save file in a single pass, grouped by the SQL ID of their owners.
     void    save(std::shared_ptr<SQLite::Database> save_db, uint32_t owner_id); // Saves this Buff to a save file.
 
     uint32_t    power = 0;              // The power level of this buff/debuff.
@@ -103,17 +106,21 @@ public:
                         Mobile();                                   // Constructor, sets default values.
     void                add_hostility(uint32_t mob_id);             // Adds a Mobile (or the player, with ID 0) to this Mobile's hostility list.
     void                add_second();                               // Adds a second to this Mobile's action timer.
+    void                add_seconds(uint32_t seconds);              // Adds a number of seconds to this Mobile's action timer, as if add_second() had been called that many times.
     void                add_score(int score);                       // Adds to this Mobile's score.
     float               attack_speed() const;                       // Returns the number of seconds needed for this Mobile to make an attack.
     float               block_mod() const;                          // Returns the modified chance to block for this Mobile, based on equipped gear.
     uint32_t            buff_power(Buff::Type type) const;          // Returns the power level of the specified buff/debuff.
     uint16_t            buff_time(Buff::Type type) const;           // Returns the time remaining for the specifieid buff/debuff.
+    void                cache_read(DataCache &cache);               // Reads this Mobile's template data from the data cache.
+    void                cache_write(DataCache &cache) const;        // Writes this Mobile's template data to the data cache.
     bool                can_perform_action(float time) const;       // Checks if this Mobile has enough action timer built up to perform an action.
     uint32_t            carry_weight() const;                       // Checks how much weight this Mobile is carrying.
     void                clear_buff(Buff::Type type);                // Clears a specified buff/debuff from the Actor, if it exists.
     void                clear_meta(const std::string &key);         // Clears a metatag from a Mobile. Use with caution!
     void                clear_tag(MobileTag the_tag);               // Clears an MobileTag from this Mobile.
     void                die(bool death_message = true);             // Causes this mobile to die and leave a corpse behind.
+    bool                dirty() const;                              // Checks if this Mobile has gone dormant since it was last saved or loaded.
     float               dodge_mod() const;                          // Returns the modified chance to dodge for this Mobile, based on equipped gear.
     const std::shared_ptr<Inventory>    equ() const;                // Returns a pointer to the Movile's equipment.
     const std::vector<std::shared_ptr<BodyPart>>& get_anatomy() const;  // Retrieves the anatomy vector for this Mobile.
@@ -125,17 +132,20 @@ public:
     uint32_t            id() const;                                 // Retrieves the unique ID of this Mobile.
     const std::shared_ptr<Inventory>    inv() const;                // Returns a pointer to the Mobile's Inventory.
     virtual bool        is_dead() const;                            // Checks if this Mobile is dead.
+    bool                is_dormant() const;                         // Checks if this Mobile is dormant, in a Room away from the player.
     bool                is_hostile() const;                         // Is this Mobile hostile to the player?
     virtual bool        is_player() const;                          // Returns true if this Mobile is a Player, false if not.
-    virtual uint32_t    load(std::shared_ptr<SQLite::Database> save_db, uint32_t sql_id);   // Loads a Mobile.
+    uint32_t            load(SQLite::Statement &query, const std::map<uint32_t, std::vector<std::shared_ptr<Item>>> &items, const std::map<uint32_t, std::vector<std::shared_ptr<Buff>>> &buffs);   // Loads a Mobile from a row of the save file's mobiles table, returns its SQL ID.
     uint32_t            location() const;                           // Retrieves the location of this Mobile, in the form of a Room ID.
+    void                make_dormant();                             // Marks this Mobile as dormant, so it stops being processed until its Room becomes active again.
     virtual uint32_t    max_carry() const;                          // The maximum weight this mobile can carry.
     std::string         meta(const std::string &key) const;         // Retrieves Mobile metadata.
     float               meta_float(const std::string &key) const;   // Retrieves metadata, in float format.
     int                 meta_int(const std::string &key) const;     // Retrieves metadata, in int format.
     uint32_t            meta_uint(const std::string &key) const;    // Retrieves metadata, in unsigned 32-bit integer format.
-    std::map<std::string, std::string>* meta_raw();                 // Accesses the metadata map directly. Use with caution!
+    std::map<uint32_t, std::string>*    meta_raw();                 // Accesses the metadata map directly, keyed by symbol. Use with caution!
     std::string         name(int flags = 0) const;                  // Retrieves the name of this Mobile.
+    void                new_inventories();                          // Gives this Mobile its own empty inventory and equipment, rather than sharing those of the Mobile it was copied from.
     void                new_parser_id();                            // Generates a new parser ID for this Mobile.
     float               parry_mod() const;                          // Returns the modified chance to parry for this Mobile, based on equipped gear.
     uint16_t            parser_id() const;                          // Retrieves the current ID of this Mobile, for parser differentiation.
@@ -146,6 +156,7 @@ public:
                         // Sets a specified buff/debuff on the Actor, or extends an existing buff/debuff.
     uint32_t            score() const;                              // Checks this Mobile's score.
     void                set_buff(Buff::Type type, uint16_t time = UINT16_MAX, uint32_t power = 0, bool additive_power = false, bool additive_time = true);  // Sets a specified buff/debuff on the Actor, or extends an existing buff/debuff.
+    void                set_dirty(bool is_dirty = true);            // Marks this Mobile as needing (or not needing) to be saved while dormant.
     void                set_gender(Gender gender);                  // Sets the gender of this Mobile.
     void                set_hp(int hp, int hp_max = 0);             // Sets the current (and, optionally, maximum) HP of this Mobile.
     void                set_id(uint32_t new_id);                    // Sets this Mobile's unique ID.
@@ -170,6 +181,7 @@ public:
     bool                using_melee() const;                        // Checks if a mobile is using at least one melee weapon.
     bool                using_ranged() const;                       // Checks if a mobile is using at least one ranged weapon.
     bool                using_shield() const;                       // Checks if a mobile is using a shield.
+    void                wake_up();                                  // Wakes up a dormant Mobile, catching up on the time that passed while it was dormant.
 
 protected:
     static constexpr float  ACTION_TIMER_CAP_MAX =                  3600;   // The maximum value the action timer can ever reach.
@@ -182,6 +194,7 @@ protected:
 
     float                               action_timer_;  // 'Charges up' with time, to allow NPCs to perform timed actions.
     std::vector<std::shared_ptr<Buff>>  buffs_;         // Any and all buffs or debuffs on this Mobile.
+    bool                                dirty_;         // Has this Mobile gone dormant since it was last saved? Dormant Mobiles don't change, so they only need saving once.
     std::shared_ptr<Inventory>          equipment_;     // The Items currently worn or wielded by this Mobile.
     Gender                              gender_;        // The gender of this Mobile.
     std::vector<uint32_t>               hostility_;     // The hostility vector keeps track of who this Mobile is angry with.
@@ -189,14 +202,14 @@ protected:
     uint32_t                            id_;            // The Mobile's unique ID.
     std::shared_ptr<Inventory>          inventory_;     // The Items being carried by this Mobile.
     uint32_t                            location_;      // The Room that this Mobile is currently located in.
-    std::map<std::string, std::string>  metadata_;      // The Mobile's metadata, if any.
+    std::map<uint32_t, std::string>     metadata_;      // The Mobile's metadata, if any, keyed by symbol.
     std::string                         name_;          // The name of this Mobile.
     uint16_t                            parser_id_;     // The semi-unique ID of this Mobile, for parser differentiation.
     uint32_t                            score_;         // Either the score value for killing this Mobile; or, for the Player, their current total score.
     uint32_t                            spawn_room_;    // The Room that spawned this Mobile.
-    std::string                         species_;       // Ths species type of this Mobile.
+    uint32_t                            species_;       // Ths species type of this Mobile, as an interned symbol.
     CombatStance                        stance_;        // The Mobile's current combat stance.
-    std::set<MobileTag>                 tags_;          // Any and all tags on this Mobile.
+    TagSet<MobileTag, 64, 0>            tags_;          // Any and all tags on this Mobile.
 };
 
 #endif  // GREAVE_WORLD_MOBILE_H_
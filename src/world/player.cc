@@ -5,6 +5,7 @@
 
 #include "actions/eat-drink.h"
 #include "core/core.h"
+#include "core/symbols.h"
 #include "world/player.h"
 
 
@@ -62,26 +63,23 @@ int Player::clothes_warmth() const
 // Retrieves the player's death reason.
 std::string Player::death_reason() const { return death_reason_; }
 
-// Gains experience in a skill.
-void Player::gain_skill_xp(const std::string& skill_id, float xp)
+// Gains experience in a skill, given its interned ID.
+void Player::gain_skill_xp(uint32_t skill_sym, float xp)
 {
     if (is_dead()) return;
-    xp *= core()->world()->get_skill_multiplier(skill_id);
+    xp *= core()->world()->get_skill_multiplier(skill_sym);
     if (xp <= 0)
     {
-        if (xp < 0) core()->guru()->nonfatal("Attempt to give negative XP in " + skill_id, Guru::GURU_WARN);
+        if (xp < 0) core()->guru()->nonfatal("Attempt to give negative XP in " + Symbols::str(skill_sym), Guru::GURU_WARN);
         return;
     }
-    auto it = skill_xp_.find(skill_id);
-    if (it == skill_xp_.end())
-    {
-        skill_xp_.insert(std::pair<std::string, float>(skill_id, xp));
-        it = skill_xp_.find(skill_id); // We'll need to refer to this in the level-up code below.
-    }
+    auto it = skill_xp_.find(skill_sym);
+    if (it == skill_xp_.end()) it = skill_xp_.insert(std::make_pair(skill_sym, xp)).first;  // We'll need to refer to this in the level-up code below.
     else it->second += xp;
 
-    int current_level = skill_level(skill_id);
-    if (!current_level) skill_levels_.insert(std::pair<std::string, int>(skill_id, 0));
+    auto level_it = skill_levels_.find(skill_sym);
+    if (level_it == skill_levels_.end()) level_it = skill_levels_.insert(std::make_pair(skill_sym, 0)).first;
+    int current_level = level_it->second;
     bool level_increased = false;
     while (it->second > 0)
     {
@@ -91,18 +89,19 @@ void Player::gain_skill_xp(const std::string& skill_id, float xp)
             it->second -= xp_to_next_level;
             current_level++;
             level_increased = true;
-            skill_levels_.find(skill_id)->second = current_level;
+            level_it->second = current_level;
         }
         else break;
     }
     if (level_increased)
     {
-        if (skill_id == "TOUGHNESS")
+        static const uint32_t SKILL_TOUGHNESS = Symbols::intern("TOUGHNESS");
+        if (skill_sym == SKILL_TOUGHNESS)
         {
             recalc_max_hp();
             core()->message("{G}You feel more resilient! Your {C}toughness {G}has increased to {C}" + std::to_string(current_level) + "{G}!");
         }
-        else core()->message("{G}Your skill in {C}" + core()->world()->get_skill_name(skill_id) + " {G}has increased to {C}" + std::to_string(current_level) + "{G}!");
+        else core()->message("{G}Your skill in {C}" + core()->world()->get_skill_name(skill_sym) + " {G}has increased to {C}" + std::to_string(current_level) + "{G}!");
     }
 }
 
@@ -158,9 +157,10 @@ bool Player::is_dead() const
 // Returns true if this Mobile is a Player, false if not.
 bool Player::is_player() const { return true; }
 
-// Loads the Player data.
-uint32_t Player::load(std::shared_ptr<SQLite::Database> save_db, uint32_t sql_id)
+// Loads the Player-specific data, returns the Player's SQL ID in the mobiles table.
+uint32_t Player::load_player(std::shared_ptr<SQLite::Database> save_db)
 {
+    uint32_t sql_id = 0;
     SQLite::Statement query(*save_db, "SELECT * FROM player");
     if (query.executeStep())
     {
@@ -181,19 +181,20 @@ uint32_t Player::load(std::shared_ptr<SQLite::Database> save_db, uint32_t sql_id
     SQLite::Statement skill_query(*save_db, "SELECT * FROM skills");
     while (skill_query.executeStep())
     {
-        const std::string skill_id = skill_query.getColumn("id").getString();
+        const uint32_t skill_id = Symbols::intern(skill_query.getColumn("id").getString());
         skill_levels_.insert(std::make_pair(skill_id, skill_query.getColumn("level").getInt()));
         if (!skill_query.isColumnNull("xp")) skill_xp_.insert(std::make_pair(skill_id, skill_query.getColumn("xp").getDouble()));
     }
 
-    return Mobile::load(save_db, sql_id);
+    return sql_id;
 }
 
 // The maximum weight the player can carry.
 uint32_t Player::max_carry() const
 {
+    static const uint32_t SKILL_HAULING = Symbols::intern("HAULING");
     const uint32_t base_carry = Mobile::max_carry();
-    return base_carry + std::round(base_carry * (static_cast<float>(skill_level("HAULING")) / SKILL_HAULING_DIVISOR));
+    return base_carry + std::round(base_carry * (static_cast<float>(skill_level(SKILL_HAULING)) / SKILL_HAULING_DIVISOR));
 }
 
 // Retrieves the Mobile target if it's still valid, or sets it to 0 if not.
@@ -201,15 +202,8 @@ uint32_t Player::mob_target()
 {
     if (mob_target_)
     {
-        for (size_t i = 0; i < core()->world()->mob_count(); i++)
-        {
-            const auto mob = core()->world()->mob_vec(i);
-            if (mob->id() == mob_target_)
-            {
-                if (mob->location() == location_) return mob_target_;
-                else break;
-            }
-        }
+        for (auto i : core()->world()->mobs_in_room(location_))
+            if (core()->world()->mob_vec(i)->id() == mob_target_) return mob_target_;
         mob_target_ = 0;   // If we couldn't make a match, or the matched Mobile is no longer here, just clear the target.
     }
     return mob_target_;
@@ -224,10 +218,11 @@ int Player::mp(bool max) const { return mp_[max ? 1 : 0]; }
 // Recalculates maximum HP, after toughness skill gains.
 void Player::recalc_max_hp()
 {
+    static const uint32_t SKILL_TOUGHNESS = Symbols::intern("TOUGHNESS");
     const float old_hpm = hp_[1];
 
     // Recalculate the new maximum HP value.
-    hp_[1] = (HP_PER_TOUGHNESS * skill_level("TOUGHNESS")) + HP_DEFAULT;
+    hp_[1] = (HP_PER_TOUGHNESS * skill_level(SKILL_TOUGHNESS)) + HP_DEFAULT;
 
     // If max HP has been gained, increase current HP by the difference.
     const float diff = hp_[1] - old_hpm;
@@ -241,8 +236,9 @@ void Player::reduce_hp(int amount, bool death_message)
     Mobile::reduce_hp(amount, death_message);
     if (hp_[0] > 0)
     {
+        static const uint32_t SKILL_TOUGHNESS = Symbols::intern("TOUGHNESS");
         const float damage_perc = static_cast<float>(amount) / static_cast<float>(hp_[1]);
-        gain_skill_xp("TOUGHNESS", damage_perc * TOUGHNESS_GAIN_MODIFIER);
+        gain_skill_xp(SKILL_TOUGHNESS, damage_perc * TOUGHNESS_GAIN_MODIFIER);
     }
 }
 
@@ -293,7 +289,7 @@ void Player::restore_sp(int amount)
 uint32_t Player::save(std::shared_ptr<SQLite::Database> save_db)
 {
     const uint32_t sql_id = Mobile::save(save_db);
-    SQLite::Statement query(*save_db, "INSERT INTO player ( blood_tox, hunger, mob_target, money, mp, mp_max, sp, sp_delay, sp_max, sql_id, thirst ) VALUES ( :blood_tox, :hunger, :mob_target, :money, :mp, :mp_max, :sp, :sp_delay, :sp_max, :sql_id, :thirst )");
+    SQLite::Statement &query = core()->sql_statement(save_db, "INSERT INTO player ( blood_tox, hunger, mob_target, money, mp, mp_max, sp, sp_delay, sp_max, sql_id, thirst ) VALUES ( :blood_tox, :hunger, :mob_target, :money, :mp, :mp_max, :sp, :sp_delay, :sp_max, :sql_id, :thirst )");
     if (blood_tox_) query.bind(":blood_tox", blood_tox_);
     query.bind(":hunger", hunger_);
     if (mob_target_) query.bind(":mob_target", mob_target_);
@@ -309,8 +305,8 @@ uint32_t Player::save(std::shared_ptr<SQLite::Database> save_db)
 
     for (const auto &kv : skill_levels_)
     {
-        SQLite::Statement skill_query(*save_db, "INSERT INTO skills ( id, level, xp ) VALUES ( :id, :level, :xp )");
-        skill_query.bind(":id", kv.first);
+        SQLite::Statement &skill_query = core()->sql_statement(save_db, "INSERT INTO skills ( id, level, xp ) VALUES ( :id, :level, :xp )");
+        skill_query.bind(":id", Symbols::str(kv.first));
         skill_query.bind(":level", kv.second);
         const auto it = skill_xp_.find(kv.first);
         if (it != skill_xp_.end()) skill_query.bind(":xp", it->second);
@@ -326,16 +322,16 @@ void Player::set_death_reason(const std::string &reason) { death_reason_ = reaso
 // Sets a new Mobile target.
 void Player::set_mob_target(uint32_t target) { mob_target_ = target; }
 
-// Returns the skill level of a specified skill of this Player.
-int Player::skill_level(const std::string &skill_id) const
+// Returns the skill level of a specified skill of this Player, given its interned ID.
+int Player::skill_level(uint32_t skill_sym) const
 {
-    const auto it = skill_levels_.find(skill_id);
+    const auto it = skill_levels_.find(skill_sym);
     if (it == skill_levels_.end()) return 0;
     else return it->second;
 }
 
 // Returns read-only access to the player's skill levels.
-const std::map<std::string, int>& Player::skill_map() const { return skill_levels_; }
+const std::map<uint32_t, int>& Player::skill_map() const { return skill_levels_; }
 
 // Retrieves the SP (or maximum SP) of the player.
 int Player::sp(bool max) const { return sp_[max ? 1 : 0]; }
@@ -26,13 +26,13 @@ public:
     int         blood_tox() const;                  // Retrieves the player's blood toxicity level.
     int         clothes_warmth() const;             // Gets the clothing warmth level from the Player.
     std::string death_reason() const;               // Retrieves the player's death reason.
-    void        gain_skill_xp(const std::string& skill_id, float xp = 1.0f);    // Gains experience in a skill.
+    void        gain_skill_xp(uint32_t skill_sym, float xp = 1.0f);   // Gains experience in a skill, given its interned ID.
     int         hunger() const;                     // Checks the current hunger level.
     void        hunger_tick();                      // The player gets a little more hungry.
     void        increase_tox(int power);            // Increases the player's blood toxicity.
     bool        is_dead() const override;           // Checks if this Player is dead.
     bool        is_player() const override;         // Returns true if this Mobile is a Player, false if not.
-    uint32_t    load(std::shared_ptr<SQLite::Database> save_db, uint32_t sql_id) override;  // Loads the Player data.
+    uint32_t    load_player(std::shared_ptr<SQLite::Database> save_db);    // Loads the Player-specific data, returns the Player's SQL ID in the mobiles table.
     uint32_t    max_carry() const override;         // The maximum weight the player can carry.
     uint32_t    mob_target();                       // Retrieves the Mobile target if it's still valid, or sets it to 0 if not.
     uint32_t    money() const;                      // Check how much money we're carrying.
@@ -46,8 +46,8 @@ public:
     uint32_t    save(std::shared_ptr<SQLite::Database> save_db) override;   // Saves this Player.
     void        set_death_reason(const std::string &reason);    // Sets the reason for this Player dying.
     void        set_mob_target(uint32_t target);    // Sets a new Mobile target.
-    int         skill_level(const std::string &skill_id) const; // Returns the skill level of a specified skill of this Player.
-    const std::map<std::string, int>&   skill_map() const;      // Returns read-only access to the player's skill levels.
+    int         skill_level(uint32_t skill_sym) const;  // Returns the skill level of a specified skill of this Player, given its interned ID.
+    const std::map<uint32_t, int>&      skill_map() const;      // Returns read-only access to the player's skill levels, indexed by skill ID symbol.
     int         sp(bool max = false) const;         // Retrieves the SP (or maximum SP) of the player.
     int         thirst() const;                     // Checks the current thirst level.
     void        thirst_tick();                      // The player gets a little more thirsty.
@@ -89,8 +89,8 @@ private:
     uint32_t                        mob_target_;    // The last Mobile to have been attacked.
     uint32_t                        money_;         // The amount of coin the player is carrying.
     int                             mp_[2];         // The current and maximum mana points.
-    std::map<std::string, int>      skill_levels_;  // The skill levels learned by this Player, if any.
-    std::map<std::string, float>    skill_xp_;      // The experience levels of skills on this Player, if any.
+    std::map<uint32_t, int>         skill_levels_;  // The skill levels learned by this Player, if any, indexed by skill ID symbol.
+    std::map<uint32_t, float>       skill_xp_;      // The experience levels of skills on this Player, if any, indexed by skill ID symbol.
     int                             sp_[3];         // The current,maximum and delayed stamina points.
     uint8_t                         thirst_;        // The thirst counter. 20 = compmpletely hydrated, 0 = died of dehydration.
 };
@@ -3,6 +3,7 @@
 
 #include "core/core.h"
 #include "core/strx.h"
+#include "core/symbols.h"
 #include "world/room.h"
 
 #include <cmath>
@@ -57,7 +58,7 @@ const char* Room::ROOM_SCAR_DESCS[][4] = {
 const char Room::SQL_ROOMS[] = "CREATE TABLE rooms ( sql_id INTEGER PRIMARY KEY UNIQUE NOT NULL, id INTEGER UNIQUE NOT NULL, last_spawned_mobs INTEGER, metadata TEXT, scars TEXT, spawn_mobs TEXT, tags TEXT, link_tags TEXT, inventory INTEGER UNIQUE )";
 
 
-Room::Room(std::string new_id) : inventory_(std::make_shared<Inventory>(Inventory::PID_PREFIX_ROOM)), last_spawned_mobs_(0), light_(0), security_(Security::ANARCHY)
+Room::Room(std::string new_id) : dirty_(false), generic_desc_(Symbols::NONE), inventory_(std::make_shared<Inventory>(Inventory::PID_PREFIX_ROOM)), last_spawned_mobs_(0), light_(0), security_(Security::ANARCHY)
 {
     if (new_id.size()) id_ = StrX::hash(new_id);
     else id_ = 0;
@@ -67,7 +68,17 @@ Room::Room(std::string new_id) : inventory_(std::make_shared<Inventory>(Inventor
 }
 
 // This Room was previously inactive, and has now become active.
-void Room::activate() { respawn_mobs(true); }
+void Room::activate()
+{
+    // Wake up any dormant Mobiles here. We'll take a copy first, as Mobiles that die while catching up will be removed from the world.
+    std::vector<std::shared_ptr<Mobile>> dormant_mobs;
+    for (auto m : core()->world()->mobs_in_room(id_))
+        dormant_mobs.push_back(core()->world()->mob_vec(m));
+    for (auto mob : dormant_mobs)
+        mob->wake_up();
+
+    respawn_mobs(true);
+}
 
 // Adds a scar to this room.
 void Room::add_scar(ScarType type, int intensity)
@@ -93,17 +104,72 @@ void Room::add_scar(ScarType type, int intensity)
         scar_type_.push_back(type);
         scar_intensity_.push_back(total_intensity);
     }
+    dirty_ = true;
 }
 
 // Adds a Mobile or List to the mobile spawn list.
-void Room::add_mob_spawn(const std::string &id) { spawn_mobs_.push_back(id); }
+void Room::add_mob_spawn(const std::string &id)
+{
+    spawn_mobs_.push_back(id);
+    spawn_lists_.push_back(id.size() && id[0] == '#' ? Symbols::intern(id.substr(1)) : Symbols::NONE);
+}
+
+// Reads this Room's static data from the data cache.
+void Room::cache_read(DataCache &cache)
+{
+    id_ = cache.read_uint();
+    name_ = cache.read_string();
+    name_short_ = cache.read_string();
+    set_desc(cache.read_string());
+    light_ = cache.read_uint();
+    security_ = static_cast<Security>(cache.read_uint());
+    for (unsigned int e = 0; e < ROOM_LINKS_MAX; e++)
+    {
+        links_[e] = cache.read_uint();
+        tags_link_[e].set_bits(false, cache.read_uint());
+        tags_link_[e].set_bits(true, cache.read_uint());
+    }
+    tags_.set_bits(false, cache.read_uint());
+    tags_.set_bits(true, cache.read_uint());
+    metadata_ = Symbols::intern_keys(cache.read_map());
+    spawn_mobs_.resize(cache.read_uint());
+    for (auto &spawn : spawn_mobs_)
+        spawn = cache.read_string();
+    intern_spawn_lists();
+    dirty_ = cache.read_bool();
+}
+
+// Writes this Room's static data to the data cache.
+void Room::cache_write(DataCache &cache) const
+{
+    cache.write_uint(id_);
+    cache.write_string(name_);
+    cache.write_string(name_short_);
+    cache.write_string(desc_);
+    cache.write_uint(light_);
+    cache.write_uint(static_cast<uint8_t>(security_));
+    for (unsigned int e = 0; e < ROOM_LINKS_MAX; e++)
+    {
+        cache.write_uint(links_[e]);
+        cache.write_uint(tags_link_[e].bits(false));
+        cache.write_uint(tags_link_[e].bits(true));
+    }
+    cache.write_uint(tags_.bits(false));
+    cache.write_uint(tags_.bits(true));
+    cache.write_map(Symbols::str_keys(metadata_));
+    cache.write_uint(spawn_mobs_.size());
+    for (auto spawn : spawn_mobs_)
+        cache.write_string(spawn);
+    cache.write_bool(dirty_);
+}
 
 // Clears a tag on this Room.
 void Room::clear_link_tag(uint8_t id, LinkTag the_tag)
 {
     if (id >= ROOM_LINKS_MAX) throw std::runtime_error("Invalid direction specified when clearing room link tag.");
-    if (!(tags_link_[id].count(the_tag) > 0)) return;
+    if (!tags_link_[id].test(the_tag)) return;
     tags_link_[id].erase(the_tag);
+    dirty_ = true;
 }
 
 // As above, but with a Direction enum.
@@ -112,15 +178,17 @@ void Room::clear_link_tag(Direction dir, LinkTag the_tag) { clear_link_tag(stati
 // Clears a metatag from an Room. Use with caution!
 void Room::clear_meta(const std::string &key)
 {
-    metadata_.erase(key);
+    metadata_.erase(Symbols::find(key));
     set_tag(RoomTag::MetaChanged);
+    dirty_ = true;
 }
 
 // Clears a tag on this Room.
 void Room::clear_tag(RoomTag the_tag)
 {
-    if (!(tags_.count(the_tag) > 0)) return;
+    if (!tags_.test(the_tag)) return;
     tags_.erase(the_tag);
+    if (the_tag != RoomTag::SaveActive) dirty_ = true;  // SaveActive only exists while saving or loading, so it doesn't count as a change.
 }
 
 // Checks if a room link is dangerous (e.g. a sky link).
@@ -141,6 +209,13 @@ void Room::deactivate()
     // Remove any and all scars on this room.
     scar_intensity_.clear();
     scar_type_.clear();
+
+    // Any Mobiles here will stop being processed until the Room becomes active again.
+    for (auto m : core()->world()->mobs_in_room(id_))
+        core()->world()->mob_vec(m)->make_dormant();
+
+    // Active Rooms are saved every time, so anything that changed while this Room was active still needs saving once more.
+    dirty_ = true;
 }
 
 // Reduces the intensity of any room scars present.
@@ -153,10 +228,14 @@ void Room::decay_scars()
             scar_intensity_.erase(scar_intensity_.begin() + i);
             scar_type_.erase(scar_type_.begin() + i);
             i--;
+            dirty_ = true;
         }
     }
 }
 
+// Checks if this Room has changed since it was last saved or loaded.
+bool Room::dirty() const { return dirty_; }
+
 // Returns the Room's description.
 std::string Room::desc() const
 {
@@ -175,7 +254,7 @@ std::string Room::desc() const
     };
 
     std::string desc = desc_;
-    if (desc_.size() > 2 && desc_[0] == '$') desc = core()->world()->generic_desc(desc_.substr(1));
+    if (generic_desc_ != Symbols::NONE) desc = core()->world()->generic_desc(generic_desc_);
     const TimeWeather::Season current_season = time_weather->current_season();
     const TimeWeather::TimeOfDay current_tod = time_weather->time_of_day(false);
     while (desc.find("[springsummer:") != std::string::npos)
@@ -228,6 +307,14 @@ uint32_t Room::id() const { return id_; }
 // Returns a pointer to the Room's Inventory.
 const std::shared_ptr<Inventory> Room::inv() const { return inventory_; }
 
+// Interns the IDs of any Lists on the mobile spawn list.
+void Room::intern_spawn_lists()
+{
+    spawn_lists_.clear();
+    for (auto spawn : spawn_mobs_)
+        spawn_lists_.push_back(spawn.size() && spawn[0] == '#' ? Symbols::intern(spawn.substr(1)) : Symbols::NONE);
+}
+
 // Checks if a key can unlock a door in the specified direction.
 bool Room::key_can_unlock(std::shared_ptr<Item> key, Direction dir)
 {
@@ -293,85 +380,86 @@ bool Room::link_tag(uint8_t id, LinkTag the_tag) const
     if (id >= ROOM_LINKS_MAX) throw std::runtime_error("Invalid direction specified when checking room link tag.");
     if (the_tag == LinkTag::Lockable || the_tag == LinkTag::Openable || the_tag == LinkTag::Locked)
     {
-        if (tags_link_[id].count(LinkTag::Permalock) > 0 || tags_link_[id].count(LinkTag::TempPermalock) > 0) return true;    // If checking for Lockable, Openable or Locked, also check for Permalock.
+        if (tags_link_[id].test(LinkTag::Permalock) || tags_link_[id].test(LinkTag::TempPermalock)) return true;    // If checking for Lockable, Openable or Locked, also check for Permalock.
         if (links_[id] == FALSE_ROOM) return true; // Links to FALSE_ROOM are always considered to be permalocked.
 
         // Special rules check here. Because exits are usually unlocked by default, but may have the LockedByDefault tag, they then require Unlocked to mark them as currently unlocked. To simplify things, we'll just check for the Locked tag externally, and handle this special case here.
         if (the_tag == LinkTag::Locked)
         {
-            if (tags_link_[id].count(LinkTag::Locked) > 0) return true;    // If it's marked as Locked then it's locked, no question.
-            if (tags_link_[id].count(LinkTag::LockedByDefault) > 0)        // And here's the tricky bit.
+            if (tags_link_[id].test(LinkTag::Locked)) return true;    // If it's marked as Locked then it's locked, no question.
+            if (tags_link_[id].test(LinkTag::LockedByDefault))        // And here's the tricky bit.
             {
-                if (tags_link_[id].count(LinkTag::Unlocked) > 0) return false; // If it's marked Unlocked, then we're good.
+                if (tags_link_[id].test(LinkTag::Unlocked)) return false; // If it's marked Unlocked, then we're good.
                 else return true;   // If not, then yes, it's locked.
             }
         }
     }
-    return (tags_link_[id].count(the_tag) > 0);
+    return (tags_link_[id].test(the_tag));
 }
 
 // As above, but with a Direction enum.
 bool Room::link_tag(Direction dir, LinkTag the_tag) const { return link_tag(static_cast<uint8_t>(dir), the_tag); }
 
-// Loads the Room and anything it contains.
-void Room::load(std::shared_ptr<SQLite::Database> save_db)
+// Loads the Room and anything it contains, from a row of the save file's rooms table.
+void Room::load(SQLite::Statement &query, const std::map<uint32_t, std::vector<std::shared_ptr<Item>>> &items)
 {
-    uint32_t inventory_id = 0;
-    SQLite::Statement query(*save_db, "SELECT * FROM rooms WHERE id = :id");
-    query.bind(":id", id_);
-    if (query.executeStep())
+    const uint32_t inventory_id = query.getColumn("inventory").getUInt();
+    if (!query.isColumnNull("last_spawned_mobs")) last_spawned_mobs_ = query.getColumn("last_spawned_mobs").getUInt();
+    if (!query.isColumnNull("link_tags"))
     {
-        inventory_id = query.getColumn("inventory").getUInt();
-        if (!query.isColumnNull("last_spawned_mobs")) last_spawned_mobs_ = query.getColumn("last_spawned_mobs").getUInt();
-        if (!query.isColumnNull("link_tags"))
+        const std::string link_tags_str = query.getColumn("link_tags").getString();
+        std::vector<std::string> split_links = StrX::string_explode(link_tags_str, ",");
+        if (split_links.size() != ROOM_LINKS_MAX) throw std::runtime_error("Malformed room link tags data.");
+        for (int e = 0; e < ROOM_LINKS_MAX; e++)
         {
-            const std::string link_tags_str = query.getColumn("link_tags").getString();
-            std::vector<std::string> split_links = StrX::string_explode(link_tags_str, ",");
-            if (split_links.size() != ROOM_LINKS_MAX) throw std::runtime_error("Malformed room link tags data.");
-            for (int e = 0; e < ROOM_LINKS_MAX; e++)
-            {
-                if (!split_links.at(e).size()) continue;
-                std::vector<std::string> split_tags = StrX::string_explode(split_links.at(e), " ");
-                for (auto tag : split_tags)
-                    tags_link_[e].insert(static_cast<LinkTag>(StrX::htoi(tag)));
-            }
+            if (!split_links.at(e).size()) continue;
+            std::vector<std::string> split_tags = StrX::string_explode(split_links.at(e), " ");
+            for (auto tag : split_tags)
+                tags_link_[e].insert(static_cast<LinkTag>(StrX::htoi(tag)));
         }
-        if (!query.getColumn("metadata").isNull()) StrX::string_to_metadata(query.getColumn("metadata").getString(), metadata_);
-        if (!query.isColumnNull("scars"))
+    }
+    if (!query.getColumn("metadata").isNull())
+    {
+        std::map<std::string, std::string> metadata;
+        StrX::string_to_metadata(query.getColumn("metadata").getString(), metadata);
+        metadata_ = Symbols::intern_keys(metadata);
+    }
+    if (!query.isColumnNull("scars"))
+    {
+        std::string scar_str = query.getColumn("scars").getString();
+        std::vector<std::string> scar_pairs = StrX::string_explode(scar_str, ",");
+        for (size_t i = 0; i < scar_pairs.size(); i++)
         {
-            std::string scar_str = query.getColumn("scars").getString();
-            std::vector<std::string> scar_pairs = StrX::string_explode(scar_str, ",");
-            for (size_t i = 0; i < scar_pairs.size(); i++)
-            {
-                std::vector<std::string> pair_explode = StrX::string_explode(scar_pairs.at(i), ";");
-                if (pair_explode.size() != 2) throw std::runtime_error("Malformed room scars data.");
-                scar_type_.push_back(static_cast<ScarType>(StrX::htoi(pair_explode.at(0))));
-                scar_intensity_.push_back(StrX::htoi(pair_explode.at(1)));
-            }
+            std::vector<std::string> pair_explode = StrX::string_explode(scar_pairs.at(i), ";");
+            if (pair_explode.size() != 2) throw std::runtime_error("Malformed room scars data.");
+            scar_type_.push_back(static_cast<ScarType>(StrX::htoi(pair_explode.at(0))));
+            scar_intensity_.push_back(StrX::htoi(pair_explode.at(1)));
         }
-        if (!query.isColumnNull("tags")) StrX::string_to_tags(query.getColumn("tags").getString(), tags_);
+    }
+    if (!query.isColumnNull("tags")) StrX::string_to_tags(query.getColumn("tags").getString(), tags_);
 
-        // Make sure this goes *after* loading tags.
-        if (tag(RoomTag::MobSpawnListChanged))
-        {
-            spawn_mobs_.clear();
-            if (!query.isColumnNull("spawn_mobs")) spawn_mobs_ = StrX::string_explode(query.getColumn("spawn_mobs").getString(), " ");
-        }
+    // Make sure this goes *after* loading tags.
+    if (tag(RoomTag::MobSpawnListChanged))
+    {
+        spawn_mobs_.clear();
+        if (!query.isColumnNull("spawn_mobs")) spawn_mobs_ = StrX::string_explode(query.getColumn("spawn_mobs").getString(), " ");
+        intern_spawn_lists();
     }
-    if (inventory_id) inventory_->load(save_db, inventory_id);
+    if (inventory_id) inventory_->load(items, inventory_id);
 }
 
 // Retrieves Room metadata.
 std::string Room::meta(const std::string &key, bool spaces) const
 {
-    if (metadata_.find(key) == metadata_.end()) return "";
-    std::string result = metadata_.at(key);
+    const auto it = metadata_.find(Symbols::find(key));
+    if (it == metadata_.end()) return "";
+    std::string result = it->second;
     if (spaces) StrX::find_and_replace(result, "_", " ");
     return result;
 }
 
 // Accesses the metadata map directly. Use with caution!
-std::map<std::string, std::string>* Room::meta_raw() { return &metadata_; }
+std::map<uint32_t, std::string>* Room::meta_raw() { return &metadata_; }
 
 // Returns the Room's full or short name.
 std::string Room::name(bool short_name) const { return (short_name ? name_short_ : name_); }
@@ -386,10 +474,12 @@ void Room::respawn_mobs(bool ignore_timer)
 
     // Set the respawn timer!
     last_spawned_mobs_ = core()->world()->time_weather()->time_passed();
+    dirty_ = true;
 
     // Pick a Mobile to spawn here.
-    std::string spawn_str = spawn_mobs_.at(core()->rng()->rnd(spawn_mobs_.size()) - 1);
-    if (spawn_str.size() && spawn_str[0] == '#') spawn_str = core()->world()->get_list(spawn_str.substr(1))->rnd().str; // If it's a list, pick an entry.
+    const size_t choice = core()->rng()->rnd(spawn_mobs_.size()) - 1;
+    std::string spawn_str = spawn_mobs_.at(choice);
+    if (spawn_lists_.at(choice) != Symbols::NONE) spawn_str = core()->world()->get_list(spawn_lists_.at(choice))->rnd().str;   // If it's a list, pick an entry.
     if (!spawn_str.size() || spawn_str == "-") return;   // If for some reason we pick a blank entry, just do nothing. Yes, we updated the spawn timer, that's fine.
 
     // Spawn the Mobile!
@@ -403,6 +493,7 @@ void Room::respawn_mobs(bool ignore_timer)
 // Saves the Room and anything it contains.
 void Room::save(std::shared_ptr<SQLite::Database> save_db)
 {
+    dirty_ = false;
     const uint32_t inventory_id = inventory_->save(save_db);
 
     const std::string tags = StrX::tags_to_string(tags_);
@@ -415,12 +506,12 @@ void Room::save(std::shared_ptr<SQLite::Database> save_db)
 
     if (!tags.size() && link_tags == ",,,,,,,,," && !scar_type_.size()) return;
 
-    SQLite::Statement room_query(*save_db, "INSERT INTO rooms (id, inventory, last_spawned_mobs, link_tags, metadata, scars, spawn_mobs, sql_id, tags) VALUES ( :id, :inventory, :last_spawned_mobs, :link_tags, :metadata, :scars, :spawn_mobs, :sql_id, :tags )");
+    SQLite::Statement &room_query = core()->sql_statement(save_db, "INSERT INTO rooms (id, inventory, last_spawned_mobs, link_tags, metadata, scars, spawn_mobs, sql_id, tags) VALUES ( :id, :inventory, :last_spawned_mobs, :link_tags, :metadata, :scars, :spawn_mobs, :sql_id, :tags )");
     room_query.bind(":id", id_);
     if (inventory_id) room_query.bind(":inventory", inventory_id);
     if (last_spawned_mobs_) room_query.bind(":last_spawned_mobs", last_spawned_mobs_);
     if (link_tags != ",,,,,,,,,") room_query.bind(":link_tags", link_tags);
-    if (tag(RoomTag::MetaChanged)) room_query.bind(":metadata", StrX::metadata_to_string(metadata_));
+    if (tag(RoomTag::MetaChanged)) room_query.bind(":metadata", StrX::metadata_to_string(Symbols::str_keys(metadata_)));
     if (scar_type_.size())
     {
         std::string scar_str;
@@ -459,7 +550,14 @@ std::string Room::scar_desc() const
 void Room::set_base_light(int new_light) { light_ = new_light; }
 
 // Sets this Room's description.
-void Room::set_desc(const std::string &new_desc) { desc_ = new_desc; }
+void Room::set_desc(const std::string &new_desc)
+{
+    desc_ = new_desc;
+    generic_desc_ = (desc_.size() > 2 && desc_[0] == '$' ? Symbols::intern(desc_.substr(1)) : Symbols::NONE);
+}
+
+// Marks this Room as changed (or unchanged) since it was last saved.
+void Room::set_dirty(bool is_dirty) { dirty_ = is_dirty; }
 
 // Sets a link to another Room.
 void Room::set_link(Direction dir, const std::string &rooid_) { set_link(dir, rooid_.size() ? StrX::hash(rooid_) : 0); }
@@ -476,8 +574,9 @@ void Room::set_link(Direction dir, uint32_t rooid_)
 void Room::set_link_tag(uint8_t id, LinkTag the_tag)
 {
     if (id >= ROOM_LINKS_MAX) throw std::runtime_error("Invalid direction specified when setting room link tag.");
-    if (tags_link_[id].count(the_tag) > 0) return;
+    if (tags_link_[id].test(the_tag)) return;
     tags_link_[id].insert(the_tag);
+    dirty_ = true;
 }
 
 // As above, but with a Direction enum.
@@ -487,9 +586,9 @@ void Room::set_link_tag(Direction dir, LinkTag the_tag) { set_link_tag(static_ca
 void Room::set_meta(const std::string &key, std::string value)
 {
     StrX::find_and_replace(value, " ", "_");
-    if (metadata_.find(key) == metadata_.end()) metadata_.insert(std::pair<std::string, std::string>(key, value));
-    else metadata_.at(key) = value;
+    metadata_[Symbols::intern(key)] = value;
     set_tag(RoomTag::MetaChanged);
+    dirty_ = true;
 }
 
 // Sets the long and short name of this room.
@@ -505,12 +604,13 @@ void Room::set_security(Security sec) { security_ = sec; }
 // Sets a tag on this Room.
 void Room::set_tag(RoomTag the_tag)
 {
-    if (tags_.count(the_tag) > 0) return;
+    if (tags_.test(the_tag)) return;
     tags_.insert(the_tag);
+    if (the_tag != RoomTag::SaveActive) dirty_ = true;  // SaveActive only exists while saving or loading, so it doesn't count as a change.
 }
 
 // Checks if a tag is set on this Room.
-bool Room::tag(RoomTag the_tag) const { return (tags_.count(the_tag) > 0); }
+bool Room::tag(RoomTag the_tag) const { return (tags_.test(the_tag)); }
 
 // Returns the room's current temperature level.
 int Room::temperature(uint32_t flags) const
@@ -5,13 +5,14 @@
 #define GREAVE_WORLD_ROOM_H_
 
 #include "core/core-constants.h"
+#include "core/data-cache.h"
+#include "core/tag-set.h"
 #include "world/inventory.h"
 
 #include <cstddef>
 #include <cstdint>
 #include <map>
 #include <memory>
-#include <set>
 #include <string>
 #include <vector>
 
@@ -157,6 +158,8 @@ public:
     void        activate();                                             // This Room was previously inactive, and has now become active.
     void        add_scar(ScarType type, int intensity);                 // Adds a scar to this room.
     void        add_mob_spawn(const std::string &id);                   // Adds a Mobile or List to the mobile spawn list.
+    void        cache_read(DataCache &cache);                           // Reads this Room's static data from the data cache.
+    void        cache_write(DataCache &cache) const;                    // Writes this Room's static data to the data cache.
     void        clear_link_tag(uint8_t id, LinkTag the_tag);            // Clears a tag on this Room's link.
     void        clear_link_tag(Direction dir, LinkTag the_tag);         // As above, but with a Direction enum.
     void        clear_meta(const std::string &key);                     // Clears a metatag from a Room. Use with caution!
@@ -165,6 +168,7 @@ public:
     bool        dangerous_link(uint8_t dir);                            // As above, but using an integer instead of an enum.
     void        deactivate();                                           // This Room was previously active, and has now become inactive.
     void        decay_scars();                                          // Reduces the intensity of any room scars present.
+    bool        dirty() const;                                          // Checks if this Room has changed since it was last saved or loaded.
     std::string desc() const;                                           // Returns the Room's description.
     std::string door_name(Direction dir) const;                         // Returns the name of a door in the specified direction.
     std::string door_name(uint8_t dir) const;                           // As above, but for non-enum integer directions.
@@ -179,15 +183,16 @@ public:
     uint32_t    link(uint8_t dir) const;                                // As above, but using an integer.
     bool        link_tag(uint8_t id, LinkTag the_tag) const;            // Checks if a tag is set on this Room's link.
     bool        link_tag(Direction dir, LinkTag the_tag) const;         // As above, but with a Direction enum.
-    void        load(std::shared_ptr<SQLite::Database> save_db);        // Loads the Room and anything it contains.
+    void        load(SQLite::Statement &query, const std::map<uint32_t, std::vector<std::shared_ptr<Item>>> &items);    // Loads the Room and anything it contains, from a row of the save file's rooms table.
     std::string meta(const std::string &key, bool spaces = true) const; // Retrieves Room metadata.
-    std::map<std::string, std::string>* meta_raw();                     // Accesses the metadata map directly. Use with caution!
+    std::map<uint32_t, std::string>*    meta_raw();                     // Accesses the metadata map directly, keyed by symbol. Use with caution!
     std::string name(bool short_name = false) const;                    // Returns the Room's full or short name.
     void        respawn_mobs(bool ignore_timer = false);                // Respawn Mobiles in this Room, if possible.
     void        save(std::shared_ptr<SQLite::Database> save_db);        // Saves the Room and anything it contains.
     std::string scar_desc() const;                                      // Returns the description of any room scars present.
     void        set_base_light(int new_light);                          // Sets this Room's base light level.
     void        set_desc(const std::string &new_desc);                  // Sets this Room's description.
+    void        set_dirty(bool is_dirty = true);                        // Marks this Room as changed (or unchanged) since it was last saved.
     void        set_link(Direction dir, const std::string &room_id);    // Sets a link to another Room.
     void        set_link(Direction dir, uint32_t room_id);              // As above, but with an already-hashed Room ID.
     void        set_link_tag(uint8_t id, LinkTag the_tag);              // Sets a tag on this Room's link.
@@ -224,21 +229,26 @@ private:
     static constexpr int    WEATHER_TIME_MOD_SUNSET =           0;      // The temperature modification for sunset.
     static const char*      ROOM_SCAR_DESCS[][4];                       // The descriptions for different types of room scars.
 
+    void        intern_spawn_lists();                                   // Interns the IDs of any Lists on the mobile spawn list.
+
     std::string                         desc_;                          // The Room's description.
+    bool                                dirty_;                         // Has this Room changed since it was last saved or loaded?
+    uint32_t                            generic_desc_;                  // The symbol of the generic description this Room uses, if desc_ links to one with a $ prefix.
     uint32_t                            id_;                            // The Room's unique ID, hashed from its YAML name.
     std::shared_ptr<Inventory>          inventory_;                     // The Room's inventory, for storing dropped items.
     uint32_t                            last_spawned_mobs_;             // The timer for when this Room last spawned Mobiles.
     uint8_t                             light_;                         // The default light level of this Room.
     uint32_t                            links_[ROOM_LINKS_MAX];         // Links to other Rooms.
-    std::map<std::string, std::string>  metadata_;                      // The Room's metadata, if any.
+    std::map<uint32_t, std::string>     metadata_;                      // The Room's metadata, if any, keyed by symbol.
     std::string                         name_;                          // The Room's title.
     std::string                         name_short_;                    // The Room's short name, for exit listings.
     std::vector<uint8_t>                scar_intensity_;                // The intensity of the room scars, if any.
     std::vector<ScarType>               scar_type_;                     // The type of room scars, if any.
     Security                            security_;                      // The security rating for this Room.
+    std::vector<uint32_t>               spawn_lists_;                   // The List symbol for each # entry on spawn_mobs_, or Symbols::NONE for a Mobile ID.
     std::vector<std::string>            spawn_mobs_;                    // The list of Mobiles to spawn here.
-    std::set<RoomTag>                   tags_;                          // Any and all RoomTags on this Room.
-    std::set<LinkTag>                   tags_link_[ROOM_LINKS_MAX];     // Any and all LinkTags on this Room's links.
+    TagSet<RoomTag>                     tags_;                          // Any and all RoomTags on this Room.
+    TagSet<LinkTag>                     tags_link_[ROOM_LINKS_MAX];     // Any and all LinkTags on this Room's links.
 };
 
 #endif  // GREAVE_WORLD_ROOM_H_
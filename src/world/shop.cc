@@ -4,6 +4,7 @@
 #include "core/core.h"
 #include "core/mathx.h"
 #include "core/strx.h"
+#include "core/symbols.h"
 #include "world/shop.h"
 
 
@@ -12,14 +13,15 @@ constexpr char Shop::SQL_SHOPS[] = "CREATE TABLE shops ( id INTEGER PRIMARY KEY
 
 
 // Constructor, sets up a blank shop by default.
-Shop::Shop(uint32_t room_id) : inventory_(std::make_shared<Inventory>(Inventory::PID_PREFIX_SHOP)), room_id_(room_id) { }
+Shop::Shop(uint32_t room_id) : dirty_(true), inventory_(std::make_shared<Inventory>(Inventory::PID_PREFIX_SHOP)), room_id_(room_id) { }
 
 // Adds an item to this shop's inventory.
 void Shop::add_item(std::shared_ptr<Item> item, bool sort)
 {
-    item->set_meta("appraised_value", item->value(true));
+    item->set_appraisal(item->value(true));
     inventory_->add_item(item, true);
     if (sort) inventory_->sort();
+    dirty_ = true;
 }
 
 // Browses the wares on sale.
@@ -100,35 +102,31 @@ void Shop::buy(uint32_t id, int quantity)
         }
         if (!item->stack()) inventory_->erase(id);
     }
+    dirty_ = true;
 
     core()->message("{g}You buy " + StrX::number_to_word(quantity) + " {G}" + item->name(Item::NAME_FLAG_NO_COLOUR | Item::NAME_FLAG_NO_COUNT | (quantity > 1 ? Item::NAME_FLAG_PLURAL : 0)) + " {g}for {G}" + StrX::strip_ansi(StrX::mgsc_string(cost, StrX::MGSC::LONG_COINS)) + "{g}.");
     player->remove_money(cost);
 }
 
+// Checks if this shop's stock has changed since it was last saved or loaded.
+bool Shop::dirty() const { return dirty_; }
+
 // Returns a pointer to the shop's inventory.
 const std::shared_ptr<Inventory> Shop::inv() const { return inventory_; }
 
-// Loads a shop from the save file.
-void Shop::load(std::shared_ptr<SQLite::Database> save_db)
-{
-    SQLite::Statement query(*save_db, "SELECT * FROM shops WHERE id = :id");
-    query.bind(":id", room_id_);
-    if (query.executeStep())
-    {
-        inventory_->load(save_db, query.getColumn("inventory_id").getUInt());
-    }
-    else throw std::runtime_error("Could not load shop data (ID: " + std::to_string(room_id_) + ")");
-}
+// Loads a shop from a row of the save file's shops table.
+void Shop::load(SQLite::Statement &query, const std::map<uint32_t, std::vector<std::shared_ptr<Item>>> &items) { inventory_->load(items, query.getColumn("inventory_id").getUInt()); }
 
 // Restocks the contents of this shop.
 void Shop::restock()
 {
     const auto world = core()->world();
     inventory_->clear();
+    dirty_ = true;
     const std::string shop_list = "SHOP_" + StrX::str_toupper(world->get_room(room_id_)->meta("shop_type"));
-    auto list = world->get_list(shop_list);
-    auto always_stock_list = world->get_list(shop_list + "_ALWAYS_STOCK");
-    auto size_list = world->get_list(shop_list + "_SIZE");
+    auto list = world->get_list(Symbols::intern(shop_list));
+    auto always_stock_list = world->get_list(Symbols::intern(shop_list + "_ALWAYS_STOCK"));
+    auto size_list = world->get_list(Symbols::intern(shop_list + "_SIZE"));
     const int shop_size = MathX::mixup(size_list->at(0).count, 2);
 
     for (size_t i = 0; i < always_stock_list->size(); i++)
@@ -146,10 +144,11 @@ void Shop::restock()
 }
 
 // Saves this Shop to the save file.
-void Shop::save(std::shared_ptr<SQLite::Database> save_db) const
+void Shop::save(std::shared_ptr<SQLite::Database> save_db)
 {
+    dirty_ = false;
     const uint32_t inv_id = inventory_->save(save_db);
-    SQLite::Statement query(*save_db, "INSERT INTO shops ( id, inventory_id ) VALUES ( :id, :inventory_id )");
+    SQLite::Statement &query = core()->sql_statement(save_db, "INSERT INTO shops ( id, inventory_id ) VALUES ( :id, :inventory_id )");
     query.bind(":id", room_id_);
     query.bind(":inventory_id", inv_id);
     query.exec();
@@ -206,3 +205,6 @@ void Shop::sell(uint32_t id, int quantity, bool confirm)
         add_item(item_split);
     }
 }
+
+// Marks this shop's stock as changed (or unchanged) since it was last saved.
+void Shop::set_dirty(bool is_dirty) { dirty_ = is_dirty; }
@@ -20,13 +20,16 @@ public:
     void    add_item(std::shared_ptr<Item> item, bool sort = true); // Adds an item to this shop's inventory.
     void    browse() const;                                         // Browses the wares on sale.
     void    buy(uint32_t id, int quantity);                         // Attempts to purchase something.
+    bool    dirty() const;                                          // Checks if this shop's stock has changed since it was last saved or loaded.
     const std::shared_ptr<Inventory>    inv() const;                // Returns a pointer to the shop's inventory.
-    void    load(std::shared_ptr<SQLite::Database> save_db);        // Loads a shop from the save file.
+    void    load(SQLite::Statement &query, const std::map<uint32_t, std::vector<std::shared_ptr<Item>>> &items);    // Loads a shop from a row of the save file's shops table.
     void    restock();                                              // Restocks the contents of this shop.
-    void    save(std::shared_ptr<SQLite::Database> save_db) const;  // Saves this shop to the save file.
+    void    save(std::shared_ptr<SQLite::Database> save_db);        // Saves this shop to the save file.
     void    sell(uint32_t id, int quantity, bool confirm);          // Offers an item to the shop to sell.
+    void    set_dirty(bool is_dirty = true);                        // Marks this shop's stock as changed (or unchanged) since it was last saved.
 
 private:
+    bool                        dirty_;     // Has this shop's stock changed since it was last saved or loaded?
     std::shared_ptr<Inventory>  inventory_; // The contents of this shop.
     uint32_t                    room_id_;   // The room ID where this shop is located.
 };
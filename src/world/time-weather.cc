@@ -5,9 +5,13 @@
 #include "3rdparty/yaml-cpp/yaml.h"
 #include "actions/ai.h"
 #include "core/core.h"
+#include "core/data-cache.h"
 #include "core/strx.h"
+#include "core/symbols.h"
 #include "world/time-weather.h"
 
+#include <algorithm>
+
 
 // SQL table construction string for the heartbeat timers.
 constexpr char TimeWeather::SQL_HEARTBEATS[] = "CREATE TABLE heartbeats ( id INTEGER PRIMARY KEY UNIQUE NOT NULL, count INTEGER NOT NULL )";
@@ -34,25 +38,49 @@ const uint32_t TimeWeather::HEARTBEAT_TIMERS[TimeWeather::Heartbeat::_TOTAL] = {
 TimeWeather::TimeWeather() : day_(80), moon_(1), time_(39660), time_passed_(0), subsecond_(0), weather_(Weather::FAIR)
 {
     weather_change_map_.resize(9);
-    try
+    DataCache cache("weather", { "data/misc/weather.yml" });
+    if (cache.loaded())
     {
-        const YAML::Node yaml_weather = YAML::LoadFile("data/misc/weather.yml");
-        for (auto w : yaml_weather)
+        try
         {
-            const std::string id = w.first.as<std::string>();
-            const std::string text = w.second.as<std::string>();
-            if (id.size() == 5 && id.substr(0, 4) == "WMAP")
-            {
-                const int map_id = id[4] - '0';
-                if (map_id < 0 || map_id > 8) throw std::runtime_error("Invalid weather map strings.");
-                weather_change_map_.at(map_id) = StrX::decode_compressed_string(text);
-            }
-            else tw_string_map_.insert(std::pair<std::string, std::string>(id, text));
+            tw_string_map_ = cache.read_map();
+            for (auto &weather_map : weather_change_map_)
+                weather_map = cache.read_string();
+            cache.finish_read();
+        }
+        catch (std::exception &e)
+        {
+            core()->guru()->log("Could not read the data cache, so it will be rebuilt: " + std::string(e.what()), Guru::GURU_WARN);
+            tw_string_map_.clear();
+            cache.reset();
         }
     }
-    catch (std::exception& e)
+    if (!cache.loaded())
     {
-        throw std::runtime_error("Error while loading data/misc/weather.yml: " + std::string(e.what()));
+        try
+        {
+            const YAML::Node yaml_weather = YAML::LoadFile("data/misc/weather.yml");
+            for (auto w : yaml_weather)
+            {
+                const std::string id = w.first.as<std::string>();
+                const std::string text = w.second.as<std::string>();
+                if (id.size() == 5 && id.substr(0, 4) == "WMAP")
+                {
+                    const int map_id = id[4] - '0';
+                    if (map_id < 0 || map_id > 8) throw std::runtime_error("Invalid weather map strings.");
+                    weather_change_map_.at(map_id) = StrX::decode_compressed_string(text);
+                }
+                else tw_string_map_.insert(std::pair<std::string, std::string>(id, text));
+            }
+            cache.write_map(tw_string_map_);
+            for (auto weather_map : weather_change_map_)
+                cache.write_string(weather_map);
+            cache.save();
+        }
+        catch (std::exception& e)
+        {
+            throw std::runtime_error("Error while loading data/misc/weather.yml: " + std::string(e.what()));
+        }
     }
 
     // Reset all the heartbeats.
@@ -235,7 +263,7 @@ bool TimeWeather::pass_time(float seconds, bool interruptable)
     int old_hp = player->hp();
     int old_hunger = player->hunger();
     int old_thirst = player->thirst();
-    while (seconds_to_add--)
+    while (seconds_to_add-- > 0)
     {
         if (player->is_dead()) return false;    // Don't pass time if the player is dead.
 
@@ -251,6 +279,19 @@ bool TimeWeather::pass_time(float seconds, bool interruptable)
             old_thirst = thirst;
         }
 
+        // Between heartbeats and time-of-day changes, only the active Mobiles can make anything happen. Seconds in which none of them act can be skipped, up to the second before the next event.
+        // The player's HP, hunger and thirst only change on heartbeats or when a Mobile acts, so none of the interrupt checks above can be skipped over either.
+        const std::vector<std::shared_ptr<Mobile>> active_mobs = world->active_mobs();
+        const int skip = AI::skip_seconds(active_mobs, std::min<int>(seconds_to_add, seconds_until_event() - 1));
+        if (skip > 0)
+        {
+            time_passed_ += skip;
+            time_ += skip;
+            for (unsigned int h = 0; h < Heartbeat::_TOTAL; h++)
+                heartbeats_[h] += skip;
+            seconds_to_add -= skip;
+        }
+
         time_passed_++;    // The total time passed in the game. This will loop every 136 years, but that's not a problem; see time_passed().
 
         // Increase all heartbeat timers.
@@ -281,7 +322,7 @@ bool TimeWeather::pass_time(float seconds, bool interruptable)
         if (change_happened && !player_is_resting) core()->message(weather_message_colour() + weather_msg.substr(1));
 
         // Runs the AI on all active mobiles.
-        AI::tick_mobs();
+        AI::tick_mobs(active_mobs);
         if (player->is_dead()) return true;
 
         std::set<uint32_t> active_rooms;    // This starts empty, but can be re-used if multiple heartbeats need to check active rooms.
@@ -313,8 +354,8 @@ bool TimeWeather::pass_time(float seconds, bool interruptable)
         {
             player->tick_buffs();
             if (player->is_dead()) return true;
-            for (size_t m = 0; m < world->mob_count(); m++)
-                world->mob_vec(m)->tick_buffs();
+            for (auto mob : world->active_mobs())
+                if (!mob->is_dead()) mob->tick_buffs();
         }
 
         // Increases the player's hunger.
@@ -335,8 +376,8 @@ bool TimeWeather::pass_time(float seconds, bool interruptable)
         if (heartbeat_ready(Heartbeat::HP_REGEN))
         {
             player->tick_hp_regen();
-            for (unsigned int i = 0; i < world->mob_count(); i++)
-                world->mob_vec(i)->tick_hp_regen();
+            for (auto mob : world->active_mobs())
+                mob->tick_hp_regen();
         }
 
         // Regenerates stamina points over time.
@@ -353,7 +394,10 @@ bool TimeWeather::pass_time(float seconds, bool interruptable)
 
         // Increases the player's hauling skill if they are over-encumbered.
         if (heartbeat_ready(Heartbeat::CARRY))
-            if (player->carry_weight() > std::round(static_cast<float>(player->max_carry()) * 0.75f)) player->gain_skill_xp("HAULING", XP_WHILE_ENCUMBERED);
+        {
+            static const uint32_t SKILL_HAULING = Symbols::intern("HAULING");
+            if (player->carry_weight() > std::round(static_cast<float>(player->max_carry()) * 0.75f)) player->gain_skill_xp(SKILL_HAULING, XP_WHILE_ENCUMBERED);
+        }
     }
 
     return true;
@@ -362,7 +406,7 @@ bool TimeWeather::pass_time(float seconds, bool interruptable)
 // Saves the time/weather data to disk.
 void TimeWeather::save(std::shared_ptr<SQLite::Database> save_db) const
 {
-    SQLite::Statement query(*save_db, "INSERT INTO time_weather ( day, moon, subsecond, time, time_total, weather ) VALUES ( :day, :moon, :subsecond, :time, :time_total, :weather )");
+    SQLite::Statement &query = core()->sql_statement(save_db, "INSERT INTO time_weather ( day, moon, subsecond, time, time_total, weather ) VALUES ( :day, :moon, :subsecond, :time, :time_total, :weather )");
     query.bind(":day", day_);
     query.bind(":moon", moon_);
     query.bind(":subsecond", subsecond_);
@@ -373,7 +417,7 @@ void TimeWeather::save(std::shared_ptr<SQLite::Database> save_db) const
 
     for (unsigned int h = 0; h < Heartbeat::_TOTAL; h++)
     {
-        SQLite::Statement heartbeat_query(*save_db, "INSERT INTO heartbeats ( id, count ) VALUES ( :id, :count )");
+        SQLite::Statement &heartbeat_query = core()->sql_statement(save_db, "INSERT INTO heartbeats ( id, count ) VALUES ( :id, :count )");
         heartbeat_query.bind(":id", h);
         heartbeat_query.bind(":count", heartbeats_[h]);
         heartbeat_query.exec();
@@ -393,6 +437,21 @@ std::string TimeWeather::season_str(TimeWeather::Season season) const
     }
 }
 
+// Returns the number of seconds until the next heartbeat or time-of-day change (minimum 1).
+int TimeWeather::seconds_until_event() const
+{
+    static const int time_changes[] = { 300, 420, 540, 660, 1020, 1140, 1260, 1380 };   // The minutes at which time_of_day(true) changes, see above.
+    int seconds = Time::DAY - time_;
+    for (auto minute : time_changes)
+        if (minute * Time::MINUTE > time_) seconds = std::min<int>(seconds, minute * Time::MINUTE - time_);
+    for (unsigned int h = 0; h < Heartbeat::_TOTAL; h++)
+    {
+        if (heartbeats_[h] >= HEARTBEAT_TIMERS[h]) return 1;
+        seconds = std::min<int>(seconds, HEARTBEAT_TIMERS[h] - heartbeats_[h]);
+    }
+    return seconds;
+}
+
 // Returns the current time of day (morning, day, dusk, night).
 TimeWeather::TimeOfDay TimeWeather::time_of_day(bool fine) const
 {
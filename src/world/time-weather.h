@@ -25,6 +25,7 @@ public:
     enum class Weather : uint8_t { BLIZZARD, STORMY, RAIN, CLEAR, FAIR, OVERCAST, FOG, LIGHTSNOW, SLEET };
     enum Time { SECOND = 1, MINUTE = 60, HOUR = 3600, DAY = 86400 };
 
+    static const uint32_t   HEARTBEAT_TIMERS[Heartbeat::_TOTAL];    // The heartbeat timers, for triggering various events at periodic intervals.
     static const char   SQL_HEARTBEATS[];   // SQL table construction string for the heartbeat timers.
     static const char   SQL_TIME_WEATHER[]; // SQL table construction string for time and weather data.
 
@@ -55,10 +56,10 @@ private:
     static constexpr int    LUNAR_CYCLE_DAYS =      29;             // How many days are in a lunar cycle?
     static constexpr float  UNINTERRUPTABLE_TIME =  5;              // The maximum amount of time for an action that cannot be interrupted.
     static constexpr int    XP_WHILE_ENCUMBERED =   1;              // How much XP to grant per carry tick for encumbered players.
-    static const uint32_t   HEARTBEAT_TIMERS[Heartbeat::_TOTAL];    // The heartbeat timers, for triggering various events at periodic intervals.
 
     Weather     fix_weather(Weather weather, Season season) const;  // Fixes weather for a specified season, to account for unavailable weather types.
     bool        heartbeat_ready(Heartbeat beat);                    // Checks if a given heartbeat is ready to trigger, and resets its counter.
+    int         seconds_until_event() const;                        // Returns the number of seconds until the next heartbeat or time-of-day change (minimum 1).
     void        trigger_event(Season season, std::string *message_to_append, bool silent);  // Triggers a time-change event.
     std::string weather_desc(Season season) const;                  // Returns a weather description for the current time/weather, based on the specified season.
 
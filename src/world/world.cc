@@ -8,62 +8,117 @@
 #include "core/filex.h"
 #include "core/mathx.h"
 #include "core/strx.h"
+#include "core/symbols.h"
 #include "world/world.h"
 
+#include <algorithm>
+#include <future>
+#include <thread>
+
 
 // The SQL construction table for the world data.
 constexpr char World::SQL_WORLD[] = "CREATE TABLE world ( mob_unique_id INTEGER PRIMARY KEY UNIQUE NOT NULL )";
 
 // Lookup table for converting DamageType text names into enums.
-const std::map<std::string, DamageType> World::DAMAGE_TYPE_MAP = { { "acid", DamageType::ACID }, { "ballistic", DamageType::BALLISTIC }, { "crushing", DamageType::CRUSHING }, { "edged", DamageType::EDGED }, { "explosive", DamageType::EXPLOSIVE }, { "energy", DamageType::ENERGY }, { "kinetic", DamageType::KINETIC }, { "piercing", DamageType::PIERCING }, { "plasma", DamageType::PLASMA }, { "poison", DamageType::POISON }, { "rending", DamageType::RENDING } };
+constexpr KeywordTable<DamageType, 11> World::DAMAGE_TYPE_MAP = { { { "acid", DamageType::ACID }, { "ballistic", DamageType::BALLISTIC }, { "crushing", DamageType::CRUSHING }, { "edged", DamageType::EDGED }, { "explosive", DamageType::EXPLOSIVE }, { "energy", DamageType::ENERGY }, { "kinetic", DamageType::KINETIC }, { "piercing", DamageType::PIERCING }, { "plasma", DamageType::PLASMA }, { "poison", DamageType::POISON }, { "rending", DamageType::RENDING } } };
 
 // Lookup table for converting EquipSlot text names into enums.
-const std::map<std::string, EquipSlot> World::EQUIP_SLOT_MAP = { { "about", EquipSlot::ABOUT_BODY }, { "armour", EquipSlot::ARMOUR }, { "body", EquipSlot::BODY }, { "feet", EquipSlot::FEET }, { "hands", EquipSlot::HANDS }, { "head", EquipSlot::HEAD }, { "held", EquipSlot::HAND_MAIN } };
+constexpr KeywordTable<EquipSlot, 7> World::EQUIP_SLOT_MAP = { { { "about", EquipSlot::ABOUT_BODY }, { "armour", EquipSlot::ARMOUR }, { "body", EquipSlot::BODY }, { "feet", EquipSlot::FEET }, { "hands", EquipSlot::HANDS }, { "head", EquipSlot::HEAD }, { "held", EquipSlot::HAND_MAIN } } };
 
 // Lookup table for converting ItemSub text names into enums.
-const std::map<std::string, ItemSub> World::ITEM_SUBTYPE_MAP = { { "arrow", ItemSub::ARROW }, { "bolt", ItemSub::BOLT }, { "booze", ItemSub::BOOZE }, { "clothing", ItemSub::CLOTHING }, { "corpse", ItemSub::CORPSE }, { "healing", ItemSub::HEALING }, { "heavy", ItemSub::HEAVY }, { "light", ItemSub::LIGHT }, { "medium", ItemSub::MEDIUM }, { "melee", ItemSub::MELEE }, { "none", ItemSub::NONE }, { "ranged", ItemSub::RANGED }, { "unarmed", ItemSub::UNARMED }, { "water_container", ItemSub::WATER_CONTAINER } };
+constexpr KeywordTable<ItemSub, 14> World::ITEM_SUBTYPE_MAP = { { { "arrow", ItemSub::ARROW }, { "bolt", ItemSub::BOLT }, { "booze", ItemSub::BOOZE }, { "clothing", ItemSub::CLOTHING }, { "corpse", ItemSub::CORPSE }, { "healing", ItemSub::HEALING }, { "heavy", ItemSub::HEAVY }, { "light", ItemSub::LIGHT }, { "medium", ItemSub::MEDIUM }, { "melee", ItemSub::MELEE }, { "none", ItemSub::NONE }, { "ranged", ItemSub::RANGED }, { "unarmed", ItemSub::UNARMED }, { "water_container", ItemSub::WATER_CONTAINER } } };
 
 // Lookup table for converting ItemTag text names into enums.
-const std::map<std::string, ItemTag> World::ITEM_TAG_MAP = { { "ammoarrow", ItemTag::AmmoArrow }, { "ammobolt", ItemTag::AmmoBolt }, { "discardwhenempty", ItemTag::DiscardWhenEmpty }, { "handandahalf", ItemTag::HandAndAHalf }, { "noa", ItemTag::NoA }, { "noammo", ItemTag::NoAmmo }, { "noloot", ItemTag::NoLoot }, { "offhandonly", ItemTag::OffHandOnly }, { "pluralname", ItemTag::PluralName }, { "preferoffhand", ItemTag::PreferOffHand }, { "propernoun", ItemTag::ProperNoun }, { "stackable", ItemTag::Stackable }, { "tavernonly", ItemTag::TavernOnly }, { "twohanded", ItemTag::TwoHanded } };
+constexpr KeywordTable<ItemTag, 14> World::ITEM_TAG_MAP = { { { "ammoarrow", ItemTag::AmmoArrow }, { "ammobolt", ItemTag::AmmoBolt }, { "discardwhenempty", ItemTag::DiscardWhenEmpty }, { "handandahalf", ItemTag::HandAndAHalf }, { "noa", ItemTag::NoA }, { "noammo", ItemTag::NoAmmo }, { "noloot", ItemTag::NoLoot }, { "offhandonly", ItemTag::OffHandOnly }, { "pluralname", ItemTag::PluralName }, { "preferoffhand", ItemTag::PreferOffHand }, { "propernoun", ItemTag::ProperNoun }, { "stackable", ItemTag::Stackable }, { "tavernonly", ItemTag::TavernOnly }, { "twohanded", ItemTag::TwoHanded } } };
 
 // Lookup table for converting ItemType text names into enums.
-const std::map<std::string, ItemType> World::ITEM_TYPE_MAP = { { "ammo", ItemType::AMMO }, { "armour", ItemType::ARMOUR }, { "container", ItemType::CONTAINER }, { "drink", ItemType::DRINK }, { "food", ItemType::FOOD }, { "key", ItemType::KEY }, { "light", ItemType::LIGHT }, { "none", ItemType::NONE }, { "potion", ItemType::POTION }, { "shield", ItemType::SHIELD }, { "weapon", ItemType::WEAPON } };
+constexpr KeywordTable<ItemType, 11> World::ITEM_TYPE_MAP = { { { "ammo", ItemType::AMMO }, { "armour", ItemType::ARMOUR }, { "container", ItemType::CONTAINER }, { "drink", ItemType::DRINK }, { "food", ItemType::FOOD }, { "key", ItemType::KEY }, { "light", ItemType::LIGHT }, { "none", ItemType::NONE }, { "potion", ItemType::POTION }, { "shield", ItemType::SHIELD }, { "weapon", ItemType::WEAPON } } };
 
 // Lookup table for converting textual light levels (e.g. "bright") to integer values.
-const std::map<std::string, uint8_t> World::LIGHT_LEVEL_MAP = { { "bright", 7 }, { "dim", 5 }, { "wilderness", 5 }, { "dark", 3 }, { "none", 0 } };
+constexpr KeywordTable<uint8_t, 5> World::LIGHT_LEVEL_MAP = { { { "bright", 7 }, { "dim", 5 }, { "wilderness", 5 }, { "dark", 3 }, { "none", 0 } } };
+
+// Lookup table for the direction prefixes on link tags in area YAML files (e.g. "northlocked").
+constexpr KeywordTable<Direction, 10> World::LINK_DIRECTION_MAP = { { { "down", Direction::DOWN }, { "east", Direction::EAST }, { "north", Direction::NORTH }, { "northeast", Direction::NORTHEAST }, { "northwest", Direction::NORTHWEST }, { "south", Direction::SOUTH }, { "southeast", Direction::SOUTHEAST }, { "southwest", Direction::SOUTHWEST }, { "up", Direction::UP }, { "west", Direction::WEST } } };
 
 // Lookup table for converting LinkTag text names into enums.
-const std::map<std::string, LinkTag> World::LINK_TAG_MAP = { { "autoclose", LinkTag::AutoClose }, { "autolock", LinkTag::AutoLock }, { "decline", LinkTag::Decline }, { "doormetal", LinkTag::DoorMetal }, { "doorshop", LinkTag::DoorShop }, { "doublelength", LinkTag::DoubleLength }, { "hidden", LinkTag::Hidden }, { "incline", LinkTag::Incline }, { "lockable", LinkTag::Lockable },  { "locked", LinkTag::LockedByDefault }, { "lockstrong", LinkTag::LockStrong }, { "lockswhenclosed", LinkTag::LocksWhenClosed }, { "lockweak", LinkTag::LockWeak }, { "noblockexit", LinkTag::NoBlockExit }, { "nomobroam", LinkTag::NoMobRoam }, { "ocean", LinkTag::Ocean }, { "open", LinkTag::Open }, { "openable", LinkTag::Openable }, { "permalock", LinkTag::Permalock }, { "sky", LinkTag::Sky}, { "sky2", LinkTag::Sky2 }, { "sky3", LinkTag::Sky3 }, { "triplelength", LinkTag::TripleLength }, { "window", LinkTag::Window } };
+constexpr KeywordTable<LinkTag, 24> World::LINK_TAG_MAP = { { { "autoclose", LinkTag::AutoClose }, { "autolock", LinkTag::AutoLock }, { "decline", LinkTag::Decline }, { "doormetal", LinkTag::DoorMetal }, { "doorshop", LinkTag::DoorShop }, { "doublelength", LinkTag::DoubleLength }, { "hidden", LinkTag::Hidden }, { "incline", LinkTag::Incline }, { "lockable", LinkTag::Lockable },  { "locked", LinkTag::LockedByDefault }, { "lockstrong", LinkTag::LockStrong }, { "lockswhenclosed", LinkTag::LocksWhenClosed }, { "lockweak", LinkTag::LockWeak }, { "noblockexit", LinkTag::NoBlockExit }, { "nomobroam", LinkTag::NoMobRoam }, { "ocean", LinkTag::Ocean }, { "open", LinkTag::Open }, { "openable", LinkTag::Openable }, { "permalock", LinkTag::Permalock }, { "sky", LinkTag::Sky}, { "sky2", LinkTag::Sky2 }, { "sky3", LinkTag::Sky3 }, { "triplelength", LinkTag::TripleLength }, { "window", LinkTag::Window } } };
 
 // Lookup table for converting MobileTag text names into enums.
-const std::map<std::string, MobileTag> World::MOBILE_TAG_MAP = { { "aggroonsight", MobileTag::AggroOnSight }, { "agile", MobileTag::Agile }, { "anemic", MobileTag::Anemic }, { "beast", MobileTag::Beast}, { "brawny", MobileTag::Brawny }, { "cannotblock", MobileTag::CannotBlock }, { "cannotdodge", MobileTag::CannotDodge }, { "cannotopendoors", MobileTag::CannotOpenDoors }, { "cannotparry", MobileTag::CannotParry }, { "clumsy", MobileTag::Clumsy }, { "coward", MobileTag::Coward }, { "feeble", MobileTag::Feeble }, { "immunitybleed", MobileTag::ImmunityBleed }, { "immunitypoison", MobileTag::ImmunityPoison }, { "mighty", MobileTag::Mighty }, { "pluralname", MobileTag::PluralName }, { "propernoun", MobileTag::ProperNoun }, { "puny", MobileTag::Puny }, { "randomgender", MobileTag::RandomGender }, { "strong", MobileTag::Strong }, { "unliving", MobileTag::Unliving }, { "vigorous", MobileTag::Vigorous } };
+constexpr KeywordTable<MobileTag, 22> World::MOBILE_TAG_MAP = { { { "aggroonsight", MobileTag::AggroOnSight }, { "agile", MobileTag::Agile }, { "anemic", MobileTag::Anemic }, { "beast", MobileTag::Beast}, { "brawny", MobileTag::Brawny }, { "cannotblock", MobileTag::CannotBlock }, { "cannotdodge", MobileTag::CannotDodge }, { "cannotopendoors", MobileTag::CannotOpenDoors }, { "cannotparry", MobileTag::CannotParry }, { "clumsy", MobileTag::Clumsy }, { "coward", MobileTag::Coward }, { "feeble", MobileTag::Feeble }, { "immunitybleed", MobileTag::ImmunityBleed }, { "immunitypoison", MobileTag::ImmunityPoison }, { "mighty", MobileTag::Mighty }, { "pluralname", MobileTag::PluralName }, { "propernoun", MobileTag::ProperNoun }, { "puny", MobileTag::Puny }, { "randomgender", MobileTag::RandomGender }, { "strong", MobileTag::Strong }, { "unliving", MobileTag::Unliving }, { "vigorous", MobileTag::Vigorous } } };
 
 // Lookup table for converting RoomTag text names into enums.
-const std::map<std::string, RoomTag> World::ROOM_TAG_MAP = { { "arena", RoomTag::Arena }, { "canseeoutside", RoomTag::CanSeeOutside }, { "churchaltar", RoomTag::ChurchAltar }, { "digok", RoomTag::DigOK }, { "gamepoker", RoomTag::GamePoker }, { "gameslots", RoomTag::GameSlots }, { "gross", RoomTag::Gross }, { "heatedinterior", RoomTag::HeatedInterior }, { "hidecampfirescar", RoomTag::HideCampfireScar }, { "indoors", RoomTag::Indoors }, { "maze", RoomTag::Maze }, { "nexus", RoomTag::Nexus }, { "noexplorecredit", RoomTag::NoExploreCredit }, { "permacampfire", RoomTag::PermaCampfire }, { "private", RoomTag::Private }, { "radiationlight", RoomTag::RadiationLight }, { "shop", RoomTag::Shop }, { "shopbuyscontraband", RoomTag::ShopBuysContraband }, { "shoprespawningowner", RoomTag::ShopRespawningOwner }, { "sleepok", RoomTag::SleepOK }, { "sludgepit", RoomTag::SludgePit }, { "smelly", RoomTag::Smelly }, { "tavern", RoomTag::Tavern }, { "trees", RoomTag::Trees }, { "underground", RoomTag::Underground }, { "verywide", RoomTag::VeryWide }, { "waterclean", RoomTag::WaterClean }, { "waterdeep", RoomTag::WaterDeep }, { "watersalt", RoomTag::WaterSalt }, { "watershallow", RoomTag::WaterShallow }, { "watertainted", RoomTag::WaterTainted }, { "wide", RoomTag::Wide } };
+constexpr KeywordTable<RoomTag, 32> World::ROOM_TAG_MAP = { { { "arena", RoomTag::Arena }, { "canseeoutside", RoomTag::CanSeeOutside }, { "churchaltar", RoomTag::ChurchAltar }, { "digok", RoomTag::DigOK }, { "gamepoker", RoomTag::GamePoker }, { "gameslots", RoomTag::GameSlots }, { "gross", RoomTag::Gross }, { "heatedinterior", RoomTag::HeatedInterior }, { "hidecampfirescar", RoomTag::HideCampfireScar }, { "indoors", RoomTag::Indoors }, { "maze", RoomTag::Maze }, { "nexus", RoomTag::Nexus }, { "noexplorecredit", RoomTag::NoExploreCredit }, { "permacampfire", RoomTag::PermaCampfire }, { "private", RoomTag::Private }, { "radiationlight", RoomTag::RadiationLight }, { "shop", RoomTag::Shop }, { "shopbuyscontraband", RoomTag::ShopBuysContraband }, { "shoprespawningowner", RoomTag::ShopRespawningOwner }, { "sleepok", RoomTag::SleepOK }, { "sludgepit", RoomTag::SludgePit }, { "smelly", RoomTag::Smelly }, { "tavern", RoomTag::Tavern }, { "trees", RoomTag::Trees }, { "underground", RoomTag::Underground }, { "verywide", RoomTag::VeryWide }, { "waterclean", RoomTag::WaterClean }, { "waterdeep", RoomTag::WaterDeep }, { "watersalt", RoomTag::WaterSalt }, { "watershallow", RoomTag::WaterShallow }, { "watertainted", RoomTag::WaterTainted }, { "wide", RoomTag::Wide } } };
 
 // Lookup table for converting textual room security (e.g. "anarchy") to enum values.
-const std::map<std::string, Room::Security> World::SECURITY_MAP = { { "anarchy", Room::Security::ANARCHY }, { "low", Room::Security::LOW }, { "high", Room::Security::HIGH }, { "sanctuary", Room::Security::SANCTUARY }, { "inaccessible", Room::Security::INACCESSIBLE } };
+constexpr KeywordTable<Room::Security, 5> World::SECURITY_MAP = { { { "anarchy", Room::Security::ANARCHY }, { "low", Room::Security::LOW }, { "high", Room::Security::HIGH }, { "sanctuary", Room::Security::SANCTUARY }, { "inaccessible", Room::Security::INACCESSIBLE } } };
 
 // A list of all valid keys in area YAML files.
-const std::set<std::string> World::VALID_YAML_KEYS_AREAS = { "desc", "exits", "light", "metadata", "name", "security", "shop_type", "spawn_mobs", "tags" };
+constexpr KeywordSet<9> World::VALID_YAML_KEYS_AREAS = { { "desc", "exits", "light", "metadata", "name", "security", "shop_type", "spawn_mobs", "tags" } };
 
 // A list of all valid keys in item YAML files.
-const std::set<std::string> World::VALID_YAML_KEYS_ITEMS = { "ammo_power", "bleed", "block_mod", "capacity", "charge", "crit", "damage_type", "desc", "dodge_mod", "liquid", "metadata", "name", "parry_mod", "poison", "power", "rare", "slot", "speed", "stack", "tags", "type", "value", "warmth", "weight" };
+constexpr KeywordSet<24> World::VALID_YAML_KEYS_ITEMS = { { "ammo_power", "bleed", "block_mod", "capacity", "charge", "crit", "damage_type", "desc", "dodge_mod", "liquid", "metadata", "name", "parry_mod", "poison", "power", "rare", "slot", "speed", "stack", "tags", "type", "value", "warmth", "weight" } };
 
 // A list of all valid keys in mobile YAML files.
-const std::set<std::string> World::VALID_YAML_KEYS_MOBS = { "gear", "hp", "name", "score", "species", "tags" };
+constexpr KeywordSet<6> World::VALID_YAML_KEYS_MOBS = { { "gear", "hp", "name", "score", "species", "tags" } };
 
 
-// Constructor, loads the room YAML data.
+// Constructor, loads the static game data from the data cache, or from the YAML files if the cache is out of date.
 World::World() : mob_unique_id_(0), old_light_level_(0), old_location_(0), player_(std::make_shared<Player>()), time_weather_(std::make_shared<TimeWeather>())
 {
-    load_room_pool();
-    load_item_pool();
-    load_mob_pool();
+    Symbols::set_frozen(false);
+    DataCache cache("world", { "data/areas", "data/items", "data/lists", "data/mobiles", "data/misc/anatomy.yml", "data/misc/generic-descriptions.yml", "data/misc/skills.yml" });
+    if (cache.loaded())
+    {
+        try
+        {
+            load_cache(cache);
+            report_symbol_collisions();
+            Symbols::set_frozen(true);
+            return;
+        }
+        catch (std::exception &e)
+        {
+            core()->guru()->log("Could not read the data cache, so it will be rebuilt: " + std::string(e.what()), Guru::GURU_WARN);
+            anatomy_pool_.clear();
+            generic_descs_.clear();
+            item_pool_.clear();
+            list_pool_.clear();
+            mob_gear_.clear();
+            mob_pool_.clear();
+            room_pool_.clear();
+            skills_.clear();
+            cache.reset();
+        }
+    }
+
+    // The files in the data folders are parsed on worker threads, then the results are merged in a fixed order, exactly as if they'd been parsed one at a time.
+    auto queue = std::make_shared<ParseQueue>();
+    auto area_files = parse_data_dir<Room>("data/areas", parse_room_file, *queue);
+    auto item_files = parse_data_dir<Item>("data/items", parse_item_file, *queue);
+    auto mobile_files = parse_data_dir<Mobile>("data/mobiles", parse_mob_file, *queue);
+    auto list_files = parse_data_dir<List>("data/lists", parse_list_file, *queue);
+
+    // There's one worker thread per CPU core, each taking files from the queue until it's empty, rather than one thread per file.
+    const size_t worker_count = std::max<size_t>(1, std::min<size_t>(std::thread::hardware_concurrency(), queue->files.size()));
+    std::vector<std::future<void>> workers;
+    for (size_t i = 0; i < worker_count; i++)
+        workers.push_back(std::async(std::launch::async, parse_worker, queue));
+
+    load_room_pool(area_files);
+    load_item_pool(item_files);
+    load_mob_pool(mobile_files);
     load_anatomy_pool();
     load_generic_descs();
-    load_lists();
+    load_lists(list_files);
     load_skills();
+    report_symbol_collisions();
+    save_cache(cache);
+    cache.save();
+
+    // The parser threads must be finished with the symbol table before it's frozen.
+    for (auto &worker : workers)
+        worker.wait();
+    Symbols::set_frozen(true);
 }
 
 // Attempts to scan a room for the active rooms list. Only for internal use with recalc_active_rooms().
@@ -82,33 +137,121 @@ void World::active_room_scan(uint32_t target, uint32_t depth)
     }
 }
 
+// Returns all the Mobiles in active rooms, in vector order.
+std::vector<std::shared_ptr<Mobile>> World::active_mobs() const
+{
+    std::vector<size_t> positions;
+    for (auto room : active_rooms_)
+    {
+        const auto occupants = room_mobiles_.find(room);
+        if (occupants != room_mobiles_.end()) positions.insert(positions.end(), occupants->second.begin(), occupants->second.end());
+    }
+    std::sort(positions.begin(), positions.end());
+
+    std::vector<std::shared_ptr<Mobile>> mobs;
+    mobs.reserve(positions.size());
+    for (auto pos : positions)
+        mobs.push_back(mobiles_.at(pos));
+    return mobs;
+}
+
 // Retrieve a list of all active rooms.
-std::set<uint32_t> World::active_rooms() const { return active_rooms_; }
+const std::set<uint32_t>& World::active_rooms() const { return active_rooms_; }
 
 // Adds a Mobile to the world.
 void World::add_mobile(std::shared_ptr<Mobile> mob)
 {
-    bool parser_id_valid;
-    int tries = 0;
-    do
+    // There are only 1000 parser IDs to go around, so mark which are in use first, rather than checking every Mobile on every try. Once they've all been taken, duplicates are unavoidable.
+    std::vector<bool> parser_ids_used(1000, false);
+    size_t parser_ids_free = parser_ids_used.size();
+    for (auto other_mob : mobiles_)
     {
-        parser_id_valid = true;
-        if (!mob->parser_id()) parser_id_valid = false;
-        else
-        {
-            for (size_t i = 0; i < mobiles_.size(); i++)
-                if (mobiles_.at(i)->parser_id() == mob->parser_id()) parser_id_valid = false;
-        }
-        if (!parser_id_valid) mob->new_parser_id();
-    } while (!parser_id_valid && ++tries < 100000);
+        const uint16_t other_id = other_mob->parser_id() % 1000;
+        if (parser_ids_used.at(other_id)) continue;
+        parser_ids_used.at(other_id) = true;
+        parser_ids_free--;
+    }
+    int tries = 0;
+    while (parser_ids_free && (!mob->parser_id() || parser_ids_used.at(mob->parser_id() % 1000)) && ++tries < 100000)
+        mob->new_parser_id();
     if (!mob->id()) mob->set_id(++mob_unique_id_);
     mobiles_.push_back(mob);
+    room_mobiles_[mob->location()].insert(mobiles_.size() - 1);
+    if (!room_active(mob->location())) mob->make_dormant();
+    verify_mob_index();
+}
+
+// Adds a new Room to the world, which isn't in the area data files. Only the scaling benchmark needs to do this, as all the game's Rooms are loaded from YAML.
+void World::add_room(std::shared_ptr<Room> room)
+{
+    if (room_pool_.count(room->id())) throw std::runtime_error("Duplicate room ID: " + std::to_string(room->id()));
+    room_pool_.insert(std::make_pair(room->id(), room));
+}
+
+// Deletes a saved Inventory, and any Inventories nested inside its Items, from the save file.
+void World::delete_saved_inventory(std::shared_ptr<SQLite::Database> save_db, uint32_t inventory_id)
+{
+    if (!inventory_id) return;
+    SQLite::Statement &query = core()->sql_statement(save_db, "WITH RECURSIVE inv(id) AS ( SELECT :id UNION ALL SELECT items.inventory FROM items, inv WHERE items.owner_id = inv.id AND items.inventory IS NOT NULL ) DELETE FROM items WHERE owner_id IN inv");
+    query.bind(":id", inventory_id);
+    query.exec();
+}
+
+// Deletes a saved Mobile, along with its Items and Buffs, from the save file.
+void World::delete_saved_mobile(std::shared_ptr<SQLite::Database> save_db, uint32_t mob_id)
+{
+    SQLite::Statement &query = core()->sql_statement(save_db, "SELECT equipment, inventory, sql_id FROM mobiles WHERE id = :id");
+    query.bind(":id", mob_id);
+    if (!query.executeStep()) return;
+    const uint32_t equipment_id = query.getColumn("equipment").getUInt();
+    const uint32_t inventory_id = query.getColumn("inventory").getUInt();
+    const uint32_t sql_id = query.getColumn("sql_id").getUInt();
+    query.reset();
+
+    delete_saved_inventory(save_db, equipment_id);
+    delete_saved_inventory(save_db, inventory_id);
+    SQLite::Statement &buff_query = core()->sql_statement(save_db, "DELETE FROM buffs WHERE owner = :owner");
+    buff_query.bind(":owner", sql_id);
+    buff_query.exec();
+    SQLite::Statement &mob_query = core()->sql_statement(save_db, "DELETE FROM mobiles WHERE sql_id = :sql_id");
+    mob_query.bind(":sql_id", sql_id);
+    mob_query.exec();
+}
+
+// Deletes a saved Room, along with its Items, from the save file.
+void World::delete_saved_room(std::shared_ptr<SQLite::Database> save_db, uint32_t room_id)
+{
+    SQLite::Statement &query = core()->sql_statement(save_db, "SELECT inventory FROM rooms WHERE id = :id");
+    query.bind(":id", room_id);
+    if (!query.executeStep()) return;
+    const uint32_t inventory_id = query.getColumn("inventory").getUInt();
+    query.reset();
+
+    delete_saved_inventory(save_db, inventory_id);
+    SQLite::Statement &room_query = core()->sql_statement(save_db, "DELETE FROM rooms WHERE id = :id");
+    room_query.bind(":id", room_id);
+    room_query.exec();
+}
+
+// Deletes a saved shop, along with its Items, from the save file.
+void World::delete_saved_shop(std::shared_ptr<SQLite::Database> save_db, uint32_t shop_id)
+{
+    SQLite::Statement &query = core()->sql_statement(save_db, "SELECT inventory_id FROM shops WHERE id = :id");
+    query.bind(":id", shop_id);
+    if (!query.executeStep()) return;
+    const uint32_t inventory_id = query.getColumn("inventory_id").getUInt();
+    query.reset();
+
+    delete_saved_inventory(save_db, inventory_id);
+    SQLite::Statement &shop_query = core()->sql_statement(save_db, "DELETE FROM shops WHERE id = :id");
+    shop_query.bind(":id", shop_id);
+    shop_query.exec();
 }
 
 // Retrieves a generic description string.
 std::string World::generic_desc(const std::string &id) const
 {
-    auto it = generic_descs_.find(id);
+    auto it = generic_descs_.find(Symbols::find(id));
     if (it == generic_descs_.end())
     {
         core()->guru()->nonfatal("Invalid generic description requested: " + id, Guru::GURU_ERROR);
@@ -117,11 +260,32 @@ std::string World::generic_desc(const std::string &id) const
     return it->second;
 }
 
+// As above, but with a generic description symbol.
+std::string World::generic_desc(uint32_t id) const
+{
+    auto it = generic_descs_.find(id);
+    if (it == generic_descs_.end())
+    {
+        core()->guru()->nonfatal("Invalid generic description requested: " + Symbols::str(id), Guru::GURU_ERROR);
+        return "-";
+    }
+    return it->second;
+}
+
 // Retrieves a copy of the anatomy data for a given species.
 const std::vector<std::shared_ptr<BodyPart>>& World::get_anatomy(const std::string &id) const
 {
-    if (anatomy_pool_.count(id) == 0) throw std::runtime_error("Could not find species ID: " + id);
-    return anatomy_pool_.at(id);
+    const auto it = anatomy_pool_.find(Symbols::find(id));
+    if (it == anatomy_pool_.end()) throw std::runtime_error("Could not find species ID: " + id);
+    return it->second;
+}
+
+// As above, but with a species symbol.
+const std::vector<std::shared_ptr<BodyPart>>& World::get_anatomy(uint32_t species) const
+{
+    const auto it = anatomy_pool_.find(species);
+    if (it == anatomy_pool_.end()) throw std::runtime_error("Could not find species ID: " + Symbols::str(species));
+    return it->second;
 }
 
 // Retrieves a specified Item by ID.
@@ -138,8 +302,17 @@ const std::shared_ptr<Item> World::get_item(const std::string &item_id, int stac
 // Retrieves a specified List by ID.
 std::shared_ptr<List> World::get_list(const std::string &list_id) const
 {
-    if (list_pool_.count(list_id) == 0) throw std::runtime_error("Could not find list ID: " + list_id);
-    return std::make_shared<List>(*list_pool_.at(list_id));
+    const auto it = list_pool_.find(Symbols::find(list_id));
+    if (it == list_pool_.end()) throw std::runtime_error("Could not find list ID: " + list_id);
+    return std::make_shared<List>(*it->second);
+}
+
+// As above, but with a List ID symbol.
+std::shared_ptr<List> World::get_list(uint32_t list_sym) const
+{
+    const auto it = list_pool_.find(list_sym);
+    if (it == list_pool_.end()) throw std::runtime_error("Could not find list ID: " + Symbols::str(list_sym));
+    return std::make_shared<List>(*it->second);
 }
 
 // Retrieves a specified Mobile by ID.
@@ -150,6 +323,7 @@ const std::shared_ptr<Mobile> World::get_mob(const std::string &mob_id) const
     const auto it = mob_pool_.find(id_hash);
     if (it == mob_pool_.end()) throw std::runtime_error("Invalid mobile ID requested: " + mob_id);
     auto new_mob = std::make_shared<Mobile>(*it->second);
+    new_mob->new_inventories();     // Otherwise every copy would share the template's inventories, and its gear would pile up with each new Mobile.
 
     if (new_mob->tag(MobileTag::RandomGender))
     {
@@ -158,10 +332,10 @@ const std::shared_ptr<Mobile> World::get_mob(const std::string &mob_id) const
     }
 
     // If this Mobile has a gear list, equip it now.
-    const std::string gear_list_str = mob_gear_.at(id_hash);
-    if (gear_list_str.size())
+    const uint32_t gear_list_sym = mob_gear_.at(id_hash);
+    if (gear_list_sym != Symbols::NONE)
     {
-        auto gear_list = get_list(gear_list_str);
+        auto gear_list = get_list(gear_list_sym);
         bool main_hand_used = false;
         for (size_t i = 0; i < gear_list->size(); i++)
         {
@@ -169,7 +343,7 @@ const std::shared_ptr<Mobile> World::get_mob(const std::string &mob_id) const
             if (gear_str == "-" || !gear_str.size()) continue;
             else if (gear_str[0] == '+')
             {
-                auto sublist = get_list(gear_str.substr(1));
+                auto sublist = get_list(gear_list->at(i).refs[0]);
                 gear_list->merge_with(sublist);
                 continue;
             }
@@ -220,24 +394,24 @@ const std::shared_ptr<Shop> World::get_shop(uint32_t id)
 }
 
 // Retrieves the XP gain multiplier for a specified skill.
-float World::get_skill_multiplier(const std::string &skill)
+float World::get_skill_multiplier(uint32_t skill)
 {
     const auto it = skills_.find(skill);
     if (it == skills_.end())
     {
-        core()->guru()->nonfatal("Invalid skill requested: " + skill, Guru::GURU_ERROR);
+        core()->guru()->nonfatal("Invalid skill requested: " + Symbols::str(skill), Guru::GURU_ERROR);
         return 0;
     }
     return it->second.xp_multi;
 }
 
 // Retrieves the name of a specified skill.
-std::string World::get_skill_name(const std::string &skill)
+std::string World::get_skill_name(uint32_t skill)
 {
     const auto it = skills_.find(skill);
     if (it == skills_.end())
     {
-        core()->guru()->nonfatal("Invalid skill requested: " + skill, Guru::GURU_ERROR);
+        core()->guru()->nonfatal("Invalid skill requested: " + Symbols::str(skill), Guru::GURU_ERROR);
         return "[error]";
     }
     return it->second.name;
@@ -255,36 +429,71 @@ void World::load(std::shared_ptr<SQLite::Database> save_db)
     if (!world_query.executeStep()) throw std::runtime_error("Unable to retrieve world data!");
     mob_unique_id_ = world_query.getColumn("mob_unique_id").getUInt();
 
-    for (auto room : room_pool_)
+    // Items and buffs are loaded first, each in a single pass, then handed out to whatever owns them.
+    const auto items = Inventory::load_all(save_db);
+    const auto buffs = Buff::load_all(save_db);
+
+    // Only Rooms which have changed are saved, so the rows in the table are applied to their Rooms, and every other Room is left as it was built from the area data.
+    uint32_t rooms_loaded = 0, rooms_unknown = 0;
+    SQLite::Statement room_query(*save_db, "SELECT * FROM rooms");
+    while (room_query.executeStep())
     {
-        room.second->load(save_db);
+        const uint32_t room_id = room_query.getColumn("id").getUInt();
+        const auto it = room_pool_.find(room_id);
+        if (it == room_pool_.end())
+        {
+            rooms_unknown++;
+            continue;
+        }
+        it->second->load(room_query, items);
+        rooms_loaded++;
+
         // Check if the Room has the SaveActive tag; if so, add it to the active rooms list, then remove the tag.
-        if (room.second->tag(RoomTag::SaveActive))
+        if (it->second->tag(RoomTag::SaveActive))
         {
-            active_rooms_.insert(room.first);
-            room.second->clear_tag(RoomTag::SaveActive);
+            active_rooms_.insert(room_id);
+            it->second->clear_tag(RoomTag::SaveActive);
         }
     }
-    const uint32_t player_sql_id = player_->load(save_db, 0);
+    core()->guru()->log("Loaded saved state for " + std::to_string(rooms_loaded) + " of " + std::to_string(room_pool_.size()) + " rooms.");
+    if (rooms_unknown) core()->guru()->nonfatal("Saved game has " + std::to_string(rooms_unknown) + " rooms which no longer exist in the area data; they have been skipped.", Guru::GURU_WARN);
+    const uint32_t player_sql_id = player_->load_player(save_db);
     time_weather_->load(save_db);
 
-    SQLite::Statement mob_query(*save_db, "SELECT sql_id FROM mobiles WHERE sql_id != :sql_id ORDER BY sql_id ASC");
-    mob_query.bind(":sql_id", std::to_string(player_sql_id));
+    bool player_loaded = false;
+    // Mobiles are kept in order of their unique IDs, which stays the same even when a save rewrites some of them in place.
+    SQLite::Statement mob_query(*save_db, "SELECT * FROM mobiles ORDER BY id ASC");
     while (mob_query.executeStep())
     {
+        if (mob_query.getColumn("sql_id").getUInt() == player_sql_id)
+        {
+            player_->load(mob_query, items, buffs);
+            player_loaded = true;
+            continue;
+        }
         auto new_mob = std::make_shared<Mobile>();
-        new_mob->load(save_db, mob_query.getColumn("sql_id").getUInt());
+        new_mob->load(mob_query, items, buffs);
         add_mobile(new_mob);
     }
+    if (!player_loaded) throw std::runtime_error("Could not load mobile data!");
 
-    SQLite::Statement shop_query(*save_db, "SELECT id FROM shops ORDER BY id ASC");
+    SQLite::Statement shop_query(*save_db, "SELECT * FROM shops ORDER BY id ASC");
     while (shop_query.executeStep())
     {
         const uint32_t shop_id = shop_query.getColumn("id").getUInt();
         auto new_shop = std::make_shared<Shop>(shop_id);
-        new_shop->load(save_db);
+        new_shop->load(shop_query, items);
         shops_.insert(std::make_pair(shop_id, new_shop));
     }
+
+    // Everything now matches the save file, so nothing needs saving again until it changes.
+    for (auto room : room_pool_)
+        room.second->set_dirty(false);
+    for (auto mob : mobiles_)
+        mob->set_dirty(false);
+    for (auto shop : shops_)
+        shop.second->set_dirty(false);
+    removed_mobs_.clear();
 }
 
 // Triggers events that happen during the main loop, just after player input.
@@ -371,7 +580,7 @@ void World::load_anatomy_pool()
                 anatomy_vec.push_back(new_bp);
             }
 
-            anatomy_pool_.insert(std::pair<std::string, std::vector<std::shared_ptr<BodyPart>>>(species_id, anatomy_vec));
+            anatomy_pool_.insert(std::make_pair(Symbols::intern(species_id), anatomy_vec));
         }
     } catch (std::exception& e)
     {
@@ -379,6 +588,77 @@ void World::load_anatomy_pool()
     }
 }
 
+// Loads all the static game data from the data cache.
+void World::load_cache(DataCache &cache)
+{
+    for (uint64_t r = cache.read_uint(); r > 0; r--)
+    {
+        const auto new_room = std::make_shared<Room>();
+        new_room->cache_read(cache);
+        room_pool_.insert(std::make_pair(new_room->id(), new_room));
+    }
+
+    for (uint64_t i = cache.read_uint(); i > 0; i--)
+    {
+        const uint32_t item_id = cache.read_uint();
+        const auto new_item = std::make_shared<Item>();
+        new_item->cache_read(cache);
+        item_pool_.insert(std::make_pair(item_id, new_item));
+    }
+
+    for (uint64_t m = cache.read_uint(); m > 0; m--)
+    {
+        const uint32_t mobile_id = cache.read_uint();
+        const auto new_mob = std::make_shared<Mobile>();
+        new_mob->cache_read(cache);
+        mob_pool_.insert(std::make_pair(mobile_id, new_mob));
+        mob_gear_.insert(std::make_pair(mobile_id, Symbols::intern(cache.read_string())));
+    }
+
+    for (uint64_t a = cache.read_uint(); a > 0; a--)
+    {
+        const std::string species_id = cache.read_string();
+        std::vector<std::shared_ptr<BodyPart>> anatomy_vec(cache.read_uint());
+        for (auto &bp : anatomy_vec)
+        {
+            bp = std::make_shared<BodyPart>();
+            bp->name = cache.read_string();
+            bp->hit_chance = cache.read_uint();
+            bp->slot = static_cast<EquipSlot>(cache.read_uint());
+        }
+        anatomy_pool_.insert(std::make_pair(Symbols::intern(species_id), anatomy_vec));
+    }
+
+    for (auto desc : cache.read_map())
+        generic_descs_.insert(std::make_pair(Symbols::intern(desc.first), desc.second));
+
+    for (uint64_t l = cache.read_uint(); l > 0; l--)
+    {
+        const std::string list_id = cache.read_string();
+        auto new_list = std::make_shared<List>();
+        for (uint64_t e = cache.read_uint(); e > 0; e--)
+        {
+            ListEntry new_list_entry;
+            new_list_entry.str = cache.read_string();
+            new_list_entry.count = cache.read_uint();
+            new_list->push_back(new_list_entry);
+        }
+        new_list->intern_refs();
+        list_pool_.insert(std::make_pair(Symbols::intern(list_id), new_list));
+    }
+
+    for (uint64_t s = cache.read_uint(); s > 0; s--)
+    {
+        const std::string skill_id = cache.read_string();
+        SkillData new_skill;
+        new_skill.name = cache.read_string();
+        new_skill.xp_multi = cache.read_float();
+        skills_.insert(std::make_pair(Symbols::intern(skill_id), new_skill));
+    }
+
+    cache.finish_read();
+}
+
 // Loads the generic descriptions YAML data into memory.
 void World::load_generic_descs()
 {
@@ -386,7 +666,7 @@ void World::load_generic_descs()
     {
         const YAML::Node yaml_descs = YAML::LoadFile("data/misc/generic-descriptions.yml");
         for (auto desc : yaml_descs)
-            generic_descs_.insert(std::make_pair(desc.first.as<std::string>(), desc.second.as<std::string>()));
+            generic_descs_.insert(std::make_pair(Symbols::intern(desc.first.as<std::string>()), desc.second.as<std::string>()));
     }
     catch (std::exception& e)
     {
@@ -394,206 +674,27 @@ void World::load_generic_descs()
     }
 }
 
-// Loads the Item YAML data into memory.
-void World::load_item_pool()
+// Loads the Item YAML data into memory, merging the files parsed by parse_item_file() in order.
+void World::load_item_pool(std::vector<std::future<DataFile<Item>>> &item_files)
 {
     std::string current_file;
     try
     {
-        const std::vector<std::string> item_files = FileX::files_in_dir("data/items", true);
-        for (auto item_file : item_files)
+        for (auto &future : item_files)
         {
-            current_file = item_file;
-            const YAML::Node yaml_items = YAML::LoadFile("data/items/" + item_file);
-            for (auto item : yaml_items)
+            const DataFile<Item> item_file = future.get();
+            current_file = item_file.filename;
+            for (auto &entry : item_file.entries)
             {
-                const YAML::Node item_data = item.second;
-
-                // Create a new Item object.
-                const std::string item_id_str = item.first.as<std::string>();
-                const uint32_t item_id = StrX::hash(item_id_str);
-                const auto new_item(std::make_shared<Item>());
-
-                // Verify all keys in this file.
-                for (auto key_value : item_data)
-                {
-                    const std::string key = key_value.first.as<std::string>();
-                    if (VALID_YAML_KEYS_ITEMS.find(key) == VALID_YAML_KEYS_ITEMS.end())
-                        core()->guru()->nonfatal("Invalid key in item YAML data (" + key + "): " + item_id_str, Guru::GURU_WARN);
-                }
+                report_warnings(entry.warnings);
+                if (!entry.data) break;
 
                 // Check to make sure there are no hash collisions.
-                if (item_pool_.find(item_id) != item_pool_.end()) throw std::runtime_error("Item ID hash conflict: " + item_id_str);
-
-                // The Item's type and subtype.
-                if (!item_data["type"]) throw std::runtime_error("Missing item type: " + item_id_str);
-                std::string item_type_str, item_subtype_str;
-                if (item_data["type"].IsSequence())
-                {
-                    const unsigned int seq_size = item_data["type"].size();
-                    if (seq_size < 1 || seq_size > 2) throw std::runtime_error("Item type data malforned: " + item_id_str);
-                    item_type_str = item_data["type"][0].as<std::string>();
-                    if (seq_size == 2) item_subtype_str = item_data["type"][1].as<std::string>();
-                }
-                else item_type_str = item_data["type"].as<std::string>();
-                ItemType type = ItemType::NONE;
-                ItemSub subtype = ItemSub::NONE;
-                if (item_type_str.size())
-                {
-                    const auto it = ITEM_TYPE_MAP.find(item_type_str);
-                    if (it == ITEM_TYPE_MAP.end()) core()->guru()->nonfatal("Invalid item type on " + item_id_str + ": " + item_type_str, Guru::GURU_ERROR);
-                    else type = it->second;
-                }
-                if (item_subtype_str.size())
-                {
-                    const auto it = ITEM_SUBTYPE_MAP.find(item_subtype_str);
-                    if (it == ITEM_SUBTYPE_MAP.end()) core()->guru()->nonfatal("Invalid item subtype on " + item_id_str + ": " + item_subtype_str, Guru::GURU_ERROR);
-                    else subtype = it->second;
-                }
-                new_item->set_type(type, subtype);
-
-                // The Item's tags, if any.
-                if (item_data["tags"])
-                {
-                    if (!item_data["tags"].IsSequence()) core()->guru()->nonfatal("{r}Malformed item tags: " + item_id_str, Guru::GURU_ERROR);
-                    else for (auto tag : item_data["tags"])
-                    {
-                        const std::string tag_str = StrX::str_tolower(tag.as<std::string>());
-                        const auto tag_it = ITEM_TAG_MAP.find(tag_str);
-                        if (tag_it == ITEM_TAG_MAP.end()) core()->guru()->nonfatal("Unrecognized item tag (" + tag_str + "): " + item_id_str, Guru::GURU_ERROR);
-                        else new_item->set_tag(tag_it->second);
-                    }
-                }
-
-                // The Item's metadata, if any.
-                if (item_data["metadata"]) StrX::string_to_metadata(item_data["metadata"].as<std::string>(), *new_item->meta_raw());
-
-                // The Item's name.
-                if (!item_data["name"]) throw std::runtime_error("Missing item name: " + item_id_str);
-                if (item_data["name"].IsSequence())
-                {
-                    const unsigned int seq_size = item_data["name"].size();
-                    if (seq_size < 1 || seq_size > 2) throw std::runtime_error("Item name data malforned: " + item_id_str);
-                    new_item->set_name(item_data["name"][0].as<std::string>());
-                    if (seq_size == 2) new_item->set_meta("plural_name", item_data["name"][1].as<std::string>());
-                }
-                else new_item->set_name(item_data["name"].as<std::string>());
-
-                // The Item's damage type, if any.
-                if (item_data["damage_type"])
-                {
-                    const std::string damage_type = item_data["damage_type"].as<std::string>();
-                    const auto type_it = DAMAGE_TYPE_MAP.find(damage_type);
-                    if (type_it == DAMAGE_TYPE_MAP.end()) core()->guru()->nonfatal("Unrecognized damage type (" + damage_type + "): " + item_id_str, Guru::GURU_ERROR);
-                    else new_item->set_meta("damage_type", static_cast<int>(type_it->second));
-                }
-
-                // The item's block% modifier, if a ny.
-                if (item_data["block_mod"]) new_item->set_meta("block_mod", item_data["block_mod"].as<int>());
-
-                // The item's dodge% modifier, if any.
-                if (item_data["dodge_mod"]) new_item->set_meta("dodge_mod", item_data["dodge_mod"].as<int>());
-
-                // The item's parry% modifier, if any.
-                if (item_data["parry_mod"]) new_item->set_meta("parry_mod", item_data["parry_mod"].as<int>());
-
-                // The Item's critical power, if any.
-                if (item_data["crit"]) new_item->set_meta("crit", item_data["crit"].as<int>());
-
-                // The Item's speed, if any.
-                if (item_data["speed"]) new_item->set_meta("speed", item_data["speed"].as<float>());
-
-                // The Item's capacity, if any.
-                if (item_data["capacity"]) new_item->set_meta("capacity", item_data["capacity"].as<int>());
-
-                // The Item's charge, if any.
-                if (item_data["charge"]) new_item->set_meta("charge", item_data["charge"].as<int>());
-
-                // The Item's EquipSlot, if any.
-                if (item_data["slot"])
-                {
-                    const std::string slot_str = item_data["slot"].as<std::string>();
-                    const auto slot_it = EQUIP_SLOT_MAP.find(slot_str);
-                    if (slot_it == EQUIP_SLOT_MAP.end()) core()->guru()->nonfatal("Unrecognized equipment slot (" + slot_str + "): " + item_id_str, Guru::GURU_ERROR);
-                    else
-                    {
-                        EquipSlot chosen_slot = slot_it->second;
-                        if (new_item->type() == ItemType::SHIELD && new_item->equip_slot() == EquipSlot::HAND_MAIN) chosen_slot = EquipSlot::HAND_OFF;
-                        new_item->set_meta("slot", static_cast<int>(chosen_slot));
-                    }
-                }
-
-                // The Item's power, if any.
-                if (item_data["power"]) new_item->set_meta("power", item_data["power"].as<int>());
-
-                // The Item's ammunition power, if any.
-                if (item_data["ammo_power"]) new_item->set_meta("ammo_power", item_data["ammo_power"].as<float>());
-
-                // The Item's warmth rating, if any.
-                if (item_data["warmth"]) new_item->set_meta("warmth", item_data["warmth"].as<int>());
-
-                // The Item's bleed chance, if any.
-                if (item_data["bleed"]) new_item->set_meta("bleed", item_data["bleed"].as<int>());
-
-                // The Item's poison chance, if any.
-                if (item_data["poison"]) new_item->set_meta("poison", item_data["poison"].as<int>());
-
-                // The Item's liquid type, if any.
-                if (item_data["liquid"]) new_item->set_meta("liquid", item_data["liquid"].as<std::string>());
-
-                // The Item's description, if any.
-                if (!item_data["desc"]) core()->guru()->nonfatal("Missing description for item " + item_id_str, Guru::GURU_WARN);
-                else
-                {
-                    const std::string desc = item_data["desc"].as<std::string>();
-                    if (desc != "-") new_item->set_description(desc);
-                }
-
-                // The Item's value.
-                unsigned int item_value = 0;
-                if (!item_data["value"]) core()->guru()->nonfatal("Missing value for item " + item_id_str, Guru::GURU_WARN);
-                else
-                {
-                    const std::string value_str = item_data["value"].as<std::string>();
-                    if (value_str.size() && value_str != "0" && value_str != "-")
-                    {
-                        std::vector<std::string> coins_split = StrX::string_explode(value_str, " ");
-                        while (coins_split.size())
-                        {
-                            const std::string coin_str = coins_split.at(0);
-                            coins_split.erase(coins_split.begin());
-                            if (coin_str.size() < 2) throw std::runtime_error("Malformed item value string on " + item_id);
-                            const char currency = coin_str[coin_str.size() - 1];
-                            unsigned int currency_amount = std::stoi(coin_str.substr(0, coin_str.size() - 1));
-                            if (currency == 'c') item_value += currency_amount;
-                            else if (currency == 's') item_value += currency_amount * 10;
-                            else if (currency == 'g') item_value += currency_amount * 1000;
-                            else if (currency == 'm') item_value += currency_amount * 1000000;
-                            else throw std::runtime_error("Malformed item value string on " + item_id);
-                        }
-                        if (!item_value) throw std::runtime_error("Null coin value on " + item_id);
-                    }
-                }
-                new_item->set_value(item_value);
-
-                // The Item's rarity.
-                if (!item_data["rare"]) core()->guru()->nonfatal("Missing rarity for item " + item_id_str, Guru::GURU_WARN);
-                else new_item->set_rare(item_data["rare"].as<int>());
-
-                // The Item's weight.
-                if (!item_data["weight"]) core()->guru()->nonfatal("Missing weight for item " + item_id_str, Guru::GURU_ERROR);
-                else new_item->set_weight(item_data["weight"].as<uint32_t>());
-
-                // The Item's stack size, if any.
-                if (item_data["stack"])
-                {
-                    if (!new_item->tag(ItemTag::Stackable)) core()->guru()->nonfatal("Stack size specified for nonstackable item: " + item_id_str, Guru::GURU_ERROR);
-                    new_item->set_stack(item_data["stack"].as<uint32_t>());
-                }
-
-                // Add the new Item to the item pool.
-                item_pool_.insert(std::make_pair(item_id, new_item));
+                const uint32_t item_id = StrX::hash(entry.id);
+                if (item_pool_.find(item_id) != item_pool_.end()) throw std::runtime_error("Item ID hash conflict: " + entry.id);
+                item_pool_.insert(std::make_pair(item_id, entry.data));
             }
+            if (item_file.error.size()) throw std::runtime_error(item_file.error);
         }
     }
     catch (std::exception& e)
@@ -603,52 +704,24 @@ void World::load_item_pool()
     }
 }
 
-// Loads the List YAML data into memory.
-void World::load_lists()
+// Loads the List YAML data into memory, merging the files parsed by parse_list_file() in order.
+void World::load_lists(std::vector<std::future<DataFile<List>>> &list_files)
 {
     std::string current_file;
     try
     {
-        const std::vector<std::string> list_files = FileX::files_in_dir("data/lists", true);
-        for (auto list_file : list_files)
+        for (auto &future : list_files)
         {
-            current_file = list_file;
-            const YAML::Node yaml_lists = YAML::LoadFile("data/lists/" + list_file);
-            for (auto list : yaml_lists)
+            const DataFile<List> list_file = future.get();
+            current_file = list_file.filename;
+            for (auto &entry : list_file.entries)
             {
-                // First, determine the List's ID.
-                const std::string list_id = list.first.as<std::string>();
-
-                // Get the rest of the data.
-                const YAML::Node yaml_list = list.second;
-                if (!yaml_list.IsSequence()) throw std::runtime_error("Invalid list data for list " + list_id);
-
-                auto new_list = std::make_shared<List>();
-                bool is_count = false;
-                ListEntry new_list_entry;
-                for (auto le : yaml_list)
-                {
-                    if (is_count)
-                    {
-                        new_list_entry.count = le.as<int>();
-                        new_list->push_back(new_list_entry);
-                        is_count = false;
-                    }
-                    else
-                    {
-                        const std::string str = le.as<std::string>();
-                        new_list_entry.str = str;
-                        if (str.size() && (str[0] == '#' || str[0] == '+' || str[0] == '&'))
-                        {
-                            new_list_entry.count = -1;
-                            new_list->push_back(new_list_entry);
-                        }
-                        else is_count = true;
-                    }
-                }
-                if (is_count) throw std::runtime_error("Invalid list length: " + list_id);
-                list_pool_.insert(std::pair<std::string, std::shared_ptr<List>>(list_id, new_list));
+                report_warnings(entry.warnings);
+                if (!entry.data) break;
+                entry.data->intern_refs();
+                list_pool_.insert(std::make_pair(Symbols::intern(entry.id), entry.data));
             }
+            if (list_file.error.size()) throw std::runtime_error(list_file.error);
         }
     } catch (std::exception& e)
     {
@@ -657,73 +730,28 @@ void World::load_lists()
     }
 }
 
-// Loads the Mobile YAML data into memory.
-void World::load_mob_pool()
+// Loads the Mobile YAML data into memory, merging the files parsed by parse_mob_file() in order.
+void World::load_mob_pool(std::vector<std::future<DataFile<Mobile>>> &mobile_files)
 {
     std::string current_file;
     try
     {
-        const std::vector<std::string> mobile_files = FileX::files_in_dir("data/mobiles", true);
-        for (auto mobile_file : mobile_files)
+        for (auto &future : mobile_files)
         {
-            current_file = mobile_file;
-            const YAML::Node yaml_mobiles = YAML::LoadFile("data/mobiles/" + mobile_file);
-            for (auto mobile : yaml_mobiles)
+            const DataFile<Mobile> mobile_file = future.get();
+            current_file = mobile_file.filename;
+            for (auto &entry : mobile_file.entries)
             {
-                const YAML::Node mobile_data = mobile.second;
-
-                // Create a new Mobile object, and remember its unique ID.
-                const std::string mobile_id_str = mobile.first.as<std::string>();
-                const uint32_t mobile_id = StrX::hash(mobile_id_str);
-                const auto new_mob(std::make_shared<Mobile>());
-
-                // Verify all keys in this file.
-                for (auto key_value : mobile_data)
-                {
-                    const std::string key = key_value.first.as<std::string>();
-                    if (VALID_YAML_KEYS_MOBS.find(key) == VALID_YAML_KEYS_MOBS.end())
-                        core()->guru()->nonfatal("Invalid key in mobile YAML data (" + key + "): " + mobile_id_str, Guru::GURU_WARN);
-                }
+                report_warnings(entry.warnings);
+                if (!entry.data) break;
 
                 // Check to make sure there are no hash collisions.
-                if (mob_pool_.find(mobile_id) != mob_pool_.end()) throw std::runtime_error("Mobile ID hash conflict: " + mobile_id_str);
-
-                // The Mobile's name.
-                if (!mobile_data["name"]) core()->guru()->nonfatal("Missing mobile name: " + mobile_id_str, Guru::GURU_ERROR);
-                else new_mob->set_name(mobile_data["name"].as<std::string>());
-
-                // The Mobile's hit points.
-                if (!mobile_data["hp"]) core()->guru()->nonfatal("Missing mobile hit points: "+ mobile_id_str, Guru::GURU_ERROR);
-                else new_mob->set_hp(mobile_data["hp"].as<int>(), mobile_data["hp"].as<int>());
-
-                // The Mobile's score, if any.
-                if (mobile_data["score"]) new_mob->add_score(mobile_data["score"].as<int>());
-
-                // The Mobile's species.
-                if (!mobile_data["species"]) core()->guru()->nonfatal("Missing species: " + mobile_id_str, Guru::GURU_CRITICAL);
-                else new_mob->set_species(mobile_data["species"].as<std::string>());
-
-                // The Mobile's tags, if any.
-                if (mobile_data["tags"])
-                {
-                    if (!mobile_data["tags"].IsSequence()) core()->guru()->nonfatal("{r}Malformed mobile tags: " + mobile_id_str, Guru::GURU_ERROR);
-                    else for (auto tag : mobile_data["tags"])
-                    {
-                        const std::string tag_str = StrX::str_tolower(tag.as<std::string>());
-                        const auto tag_it = MOBILE_TAG_MAP.find(tag_str);
-                        if (tag_it == MOBILE_TAG_MAP.end()) core()->guru()->nonfatal("Unrecognized mobile tag (" + tag_str + "): " + mobile_id_str, Guru::GURU_ERROR);
-                        else new_mob->set_tag(tag_it->second);
-                    }
-                }
-
-                // The Mobile's gear list.
-                std::string gear_list;
-                if (mobile_data["gear"]) gear_list = mobile_data["gear"].as<std::string>();
-
-                // Add the Mobile to the mob pool.
-                mob_pool_.insert(std::make_pair(mobile_id, new_mob));
-                mob_gear_.insert(std::make_pair(mobile_id, gear_list));
+                const uint32_t mobile_id = StrX::hash(entry.id);
+                if (mob_pool_.find(mobile_id) != mob_pool_.end()) throw std::runtime_error("Mobile ID hash conflict: " + entry.id);
+                mob_pool_.insert(std::make_pair(mobile_id, entry.data));
+                mob_gear_.insert(std::make_pair(mobile_id, Symbols::intern(entry.extra)));
             }
+            if (mobile_file.error.size()) throw std::runtime_error(mobile_file.error);
         }
     }
     catch (std::exception& e)
@@ -733,220 +761,26 @@ void World::load_mob_pool()
     }
 }
 
-// Loads the Room YAML data into memory.
-void World::load_room_pool()
+// Loads the Room YAML data into memory, merging the files parsed by parse_room_file() in order.
+void World::load_room_pool(std::vector<std::future<DataFile<Room>>> &area_files)
 {
     std::string current_file;
     try
     {
-        const std::vector<std::string> area_files = FileX::files_in_dir("data/areas", true);
-        for (auto area_file : area_files)
+        for (auto &future : area_files)
         {
-            current_file = area_file;
-            const YAML::Node yaml_rooms = YAML::LoadFile("data/areas/" + area_file);
-            for (auto room : yaml_rooms)
+            const DataFile<Room> area_file = future.get();
+            current_file = area_file.filename;
+            for (auto &entry : area_file.entries)
             {
-                const YAML::Node room_data = room.second;
-
-                // Create a new Room object, and set its unique ID.
-                const std::string room_id = room.first.as<std::string>();
-                const auto new_room(std::make_shared<Room>(room_id));
-
-                // Verify all keys in this file.
-                for (auto key_value : room_data)
-                {
-                    const std::string key = key_value.first.as<std::string>();
-                    if (VALID_YAML_KEYS_AREAS.find(key) == VALID_YAML_KEYS_AREAS.end())
-                        core()->guru()->nonfatal("Invalid key in room YAML data (" + key + "): " + room_id, Guru::GURU_WARN);
-                }
+                report_warnings(entry.warnings);
+                if (!entry.data) break;
 
                 // Check to make sure there are no hash collisions.
-                if (room_pool_.find(new_room->id()) != room_pool_.end()) throw std::runtime_error("Room ID hash conflict: " + room_id);
-
-                // The Room's long and short names.
-                if (!room_data["name"] || room_data["name"].size() < 2) core()->guru()->nonfatal("Missing or invalid room name(s): " + room_id, Guru::GURU_ERROR);
-                else new_room->set_name(room_data["name"][0].as<std::string>(), room_data["name"][1].as<std::string>());
-
-                // The Room's description.
-                if (!room_data["desc"]) core()->guru()->nonfatal("Missing room description: " + room_id, Guru::GURU_WARN);
-                else
-                {
-                    const std::string desc = room_data["desc"].as<std::string>();
-                    if (desc != "-") new_room->set_desc(desc);
-                }
-
-                // Links to other Rooms.
-                if (room_data["exits"])
-                {
-                    for (unsigned int e = 0; e < Room::ROOM_LINKS_MAX; e++)
-                    {
-                        const Direction dir = static_cast<Direction>(e);
-                        const std::string dir_str = StrX::dir_to_name(dir);
-                        if (room_data["exits"][dir_str]) new_room->set_link(dir, room_data["exits"][dir_str].as<std::string>());
-                    }
-                }
-
-                // The light level of the Room.
-                if (!room_data["light"]) core()->guru()->nonfatal("Missing room light level: " + room_id, Guru::GURU_ERROR);
-                else
-                {
-                    const std::string light_str = room_data["light"].as<std::string>();
-                    auto level_it = LIGHT_LEVEL_MAP.find(light_str);
-                    if (level_it == LIGHT_LEVEL_MAP.end()) core()->guru()->nonfatal("Invalid light level value: " + room_id, Guru::GURU_ERROR);
-                    else new_room->set_base_light(level_it->second);
-                }
-
-                // The security level of this Room.
-                if (!room_data["security"]) core()->guru()->nonfatal("Missing room security level: " + room_id, Guru::GURU_ERROR);
-                else
-                {
-                    const std::string sec_str = room_data["security"].as<std::string>();
-                    auto sec_it = SECURITY_MAP.find(sec_str);
-                    if (sec_it == SECURITY_MAP.end()) core()->guru()->nonfatal("Invalid security level value: " + room_id, Guru::GURU_ERROR);
-                    else new_room->set_security(sec_it->second);
-                }
-
-                // Room tags, if any.
-                if (room_data["tags"])
-                {
-                    if (!room_data["tags"].IsSequence()) core()->guru()->nonfatal("{r}Malformed room tags: " + room_id, Guru::GURU_ERROR);
-                    else for (auto tag : room_data["tags"])
-                    {
-                        const std::string tag_str = StrX::str_tolower(tag.as<std::string>());
-                        bool directional_tag = false;
-                        int dt_int = 0, dt_offset = 0;
-
-                        if (tag_str.size() > 9)
-                        {
-                            if (tag_str.substr(0, 9) == "northeast")
-                            {
-                                directional_tag = true;
-                                dt_int = static_cast<unsigned int>(Direction::NORTHEAST);
-                                dt_offset = 9;
-                            }
-                            else if (tag_str.substr(0, 9) == "northwest")
-                            {
-                                directional_tag = true;
-                                dt_int = static_cast<unsigned int>(Direction::NORTHWEST);
-                                dt_offset = 9;
-                            }
-                            else if (tag_str.substr(0, 9) == "southeast")
-                            {
-                                directional_tag = true;
-                                dt_int = static_cast<unsigned int>(Direction::SOUTHEAST);
-                                dt_offset = 9;
-                            }
-                            else if (tag_str.substr(0, 9) == "southwest")
-                            {
-                                directional_tag = true;
-                                dt_int = static_cast<unsigned int>(Direction::SOUTHWEST);
-                                dt_offset = 9;
-                            }
-                        }
-                        if (tag_str.size() > 5 && !directional_tag)
-                        {
-                            if (tag_str.substr(0, 5) == "north")
-                            {
-                                directional_tag = true;
-                                dt_int = static_cast<unsigned int>(Direction::NORTH);
-                                dt_offset = 5;
-                            }
-                            else if (tag_str.substr(0, 5) == "south")
-                            {
-                                directional_tag = true;
-                                dt_int = static_cast<unsigned int>(Direction::SOUTH);
-                                dt_offset = 5;
-                            }
-                        }
-                        if (tag_str.size() > 4 && !directional_tag)
-                        {
-                            if (tag_str.substr(0, 4) == "east")
-                            {
-                                directional_tag = true;
-                                dt_int = static_cast<unsigned int>(Direction::EAST);
-                                dt_offset = 4;
-                            }
-                            else if (tag_str.substr(0, 4) == "west")
-                            {
-                                directional_tag = true;
-                                dt_int = static_cast<unsigned int>(Direction::WEST);
-                                dt_offset = 4;
-                            }
-                            else if (tag_str.substr(0, 4) == "down")
-                            {
-                                directional_tag = true;
-                                dt_int = static_cast<unsigned int>(Direction::DOWN);
-                                dt_offset = 4;
-                            }
-                        }
-                        if (tag_str.size() > 2 && !directional_tag)
-                        {
-                            if (tag_str.substr(0, 2) == "up")
-                            {
-                                directional_tag = true;
-                                dt_int = static_cast<unsigned int>(Direction::UP);
-                                dt_offset = 2;
-                            }
-                        }
-
-                        if (!directional_tag)
-                        {
-                            const auto tag_it = ROOM_TAG_MAP.find(tag_str);
-                            if (tag_it == ROOM_TAG_MAP.end()) core()->guru()->nonfatal("Unrecognized room tag (" + tag_str + "): " + room_id, Guru::GURU_WARN);
-                            else new_room->set_tag(tag_it->second);
-                        }
-                        else
-                        {
-                            const std::string dtag_str = tag_str.substr(dt_offset);
-                            const auto dtag_it = LINK_TAG_MAP.find(dtag_str);
-                            if (dtag_it == LINK_TAG_MAP.end()) core()->guru()->nonfatal("Unrecognized link tag (" + dtag_str + "): " + room_id, Guru::GURU_WARN);
-                            else
-                            {
-                                const LinkTag lt = dtag_it->second;
-                                switch (lt)
-                                {
-                                    case LinkTag::Lockable:
-                                    case LinkTag::Window:
-                                        new_room->set_link_tag(dt_int, LinkTag::Openable);
-                                        break;
-                                    case LinkTag::LockedByDefault:
-                                        new_room->set_link_tag(dt_int, LinkTag::Lockable);
-                                        new_room->set_link_tag(dt_int, LinkTag::Openable);
-                                        break;
-                                    case LinkTag::Open:
-                                        new_room->set_link_tag(dt_int, LinkTag::Openable);
-                                        break;
-                                    default: break;
-                                }
-                                new_room->set_link_tag(dt_int, lt);
-                            }
-                        }
-                    }
-                }
-
-                // Mobile spawns, if any.
-                if (room_data["spawn_mobs"])
-                {
-                    if (room_data["spawn_mobs"].IsSequence())
-                    {
-                        for (auto e : room_data["spawn_mobs"])
-                            new_room->add_mob_spawn(e.as<std::string>());
-                    }
-                    else new_room->add_mob_spawn(room_data["spawn_mobs"].as<std::string>());
-                }
-
-                // The Room's metadata, if any.
-                if (room_data["metadata"]) StrX::string_to_metadata(room_data["metadata"].as<std::string>(), *new_room->meta_raw());
-
-                // The room's  shop type, if any.
-                if (room_data["shop_type"]) new_room->set_meta("shop_type", room_data["shop_type"].as<std::string>());
-
-                // Clear the meta changed tag, since this is static data.
-                new_room->clear_tag(RoomTag::MetaChanged);
-
-                // Add the new Room to the room pool.
-                room_pool_.insert(std::make_pair(new_room->id(), new_room));
+                if (room_pool_.find(entry.data->id()) != room_pool_.end()) throw std::runtime_error("Room ID hash conflict: " + entry.id);
+                room_pool_.insert(std::make_pair(entry.data->id(), entry.data));
             }
+            if (area_file.error.size()) throw std::runtime_error(area_file.error);
         }
     }
     catch (std::exception& e)
@@ -969,7 +803,7 @@ void World::load_skills()
             if (!skill_data["name"]) throw std::runtime_error("Skill name not specified: " + skill_id);
             if (!skill_data["xp_multi"]) throw std::runtime_error("Skill XP multiplier not specified: " + skill_id);
             SkillData new_skill = { skill_data["name"].as<std::string>(), skill_data["xp_multi"].as<float>() };
-            skills_.insert(std::make_pair(skill_id, new_skill));
+            skills_.insert(std::make_pair(Symbols::intern(skill_id), new_skill));
         }
     }
     catch (std::exception& e)
@@ -991,6 +825,15 @@ const std::shared_ptr<Mobile> World::mob_vec(size_t vec_pos) const
     return mobiles_.at(vec_pos);
 }
 
+// Returns the vector positions of all Mobiles in a specified Room.
+const std::set<size_t>& World::mobs_in_room(uint32_t room_id) const
+{
+    static const std::set<size_t> empty_room;
+    const auto result = room_mobiles_.find(room_id);
+    if (result == room_mobiles_.end()) return empty_room;
+    return result->second;
+}
+
 // Sets up for a new game.
 void World::new_game()
 {
@@ -1000,6 +843,496 @@ void World::new_game()
     ActionLook::look();
 }
 
+// Lists the YAML files in a data folder in a fixed order, and adds each of them to the queue for the worker threads to parse.
+template<class T> std::vector<std::future<World::DataFile<T>>> World::parse_data_dir(const std::string &dir, void (*parser)(const std::string&, DataFile<T>&), ParseQueue &queue)
+{
+    std::vector<std::string> files = FileX::files_in_dir(dir, true);
+    std::sort(files.begin(), files.end());
+    std::vector<std::future<DataFile<T>>> futures;
+    for (auto file : files)
+    {
+        auto task = std::make_shared<std::packaged_task<DataFile<T>()>>([file, parser]()
+        {
+            DataFile<T> data_file;
+            data_file.filename = file;
+            try
+            {
+                parser(file, data_file);
+            }
+            catch (std::exception &e)
+            {
+                data_file.error = e.what();
+            }
+            return data_file;
+        });
+        futures.push_back(task->get_future());
+        queue.files.push_back([task]() { (*task)(); });
+    }
+    return futures;
+}
+
+// Parses one of the Item YAML files. This runs on a worker thread, so rather than touching the item pool or reporting errors itself, it leaves them for load_item_pool().
+void World::parse_item_file(const std::string &filename, DataFile<Item> &data_file)
+{
+    const YAML::Node yaml_items = YAML::LoadFile("data/items/" + filename);
+    for (auto item : yaml_items)
+    {
+        data_file.entries.emplace_back();
+        auto &entry = data_file.entries.back();
+        const YAML::Node item_data = item.second;
+
+        // Create a new Item object.
+        const std::string item_id_str = item.first.as<std::string>();
+        entry.id = item_id_str;
+        const auto new_item(std::make_shared<Item>());
+
+        // Verify all keys in this file.
+        for (auto key_value : item_data)
+        {
+            const std::string key = key_value.first.as<std::string>();
+            if (!VALID_YAML_KEYS_ITEMS.contains(key))
+                entry.warnings.emplace_back("Invalid key in item YAML data (" + key + "): " + item_id_str, Guru::GURU_WARN);
+        }
+
+        // The Item's type and subtype.
+        if (!item_data["type"]) throw std::runtime_error("Missing item type: " + item_id_str);
+        std::string item_type_str, item_subtype_str;
+        if (item_data["type"].IsSequence())
+        {
+            const unsigned int seq_size = item_data["type"].size();
+            if (seq_size < 1 || seq_size > 2) throw std::runtime_error("Item type data malforned: " + item_id_str);
+            item_type_str = item_data["type"][0].as<std::string>();
+            if (seq_size == 2) item_subtype_str = item_data["type"][1].as<std::string>();
+        }
+        else item_type_str = item_data["type"].as<std::string>();
+        ItemType type = ItemType::NONE;
+        ItemSub subtype = ItemSub::NONE;
+        if (item_type_str.size())
+        {
+            const auto type_ptr = ITEM_TYPE_MAP.find(item_type_str);
+            if (!type_ptr) entry.warnings.emplace_back("Invalid item type on " + item_id_str + ": " + item_type_str, Guru::GURU_ERROR);
+            else type = *type_ptr;
+        }
+        if (item_subtype_str.size())
+        {
+            const auto subtype_ptr = ITEM_SUBTYPE_MAP.find(item_subtype_str);
+            if (!subtype_ptr) entry.warnings.emplace_back("Invalid item subtype on " + item_id_str + ": " + item_subtype_str, Guru::GURU_ERROR);
+            else subtype = *subtype_ptr;
+        }
+        new_item->set_type(type, subtype);
+
+        // The Item's tags, if any.
+        if (item_data["tags"])
+        {
+            if (!item_data["tags"].IsSequence()) entry.warnings.emplace_back("{r}Malformed item tags: " + item_id_str, Guru::GURU_ERROR);
+            else for (auto tag : item_data["tags"])
+            {
+                const std::string tag_str = StrX::str_tolower(tag.as<std::string>());
+                const auto tag_ptr = ITEM_TAG_MAP.find(tag_str);
+                if (!tag_ptr) entry.warnings.emplace_back("Unrecognized item tag (" + tag_str + "): " + item_id_str, Guru::GURU_ERROR);
+                else new_item->set_tag(*tag_ptr);
+            }
+        }
+
+        // The Item's metadata, if any.
+        if (item_data["metadata"])
+        {
+            std::map<std::string, std::string> item_metadata;
+            StrX::string_to_metadata(item_data["metadata"].as<std::string>(), item_metadata);
+            for (auto meta : item_metadata)
+                new_item->set_meta(meta.first, meta.second);
+        }
+
+        // The Item's name.
+        if (!item_data["name"]) throw std::runtime_error("Missing item name: " + item_id_str);
+        if (item_data["name"].IsSequence())
+        {
+            const unsigned int seq_size = item_data["name"].size();
+            if (seq_size < 1 || seq_size > 2) throw std::runtime_error("Item name data malforned: " + item_id_str);
+            new_item->set_name(item_data["name"][0].as<std::string>());
+            if (seq_size == 2) new_item->set_meta("plural_name", item_data["name"][1].as<std::string>());
+        }
+        else new_item->set_name(item_data["name"].as<std::string>());
+
+        // The Item's damage type, if any.
+        if (item_data["damage_type"])
+        {
+            const std::string damage_type = item_data["damage_type"].as<std::string>();
+            const auto type_ptr = DAMAGE_TYPE_MAP.find(damage_type);
+            if (!type_ptr) entry.warnings.emplace_back("Unrecognized damage type (" + damage_type + "): " + item_id_str, Guru::GURU_ERROR);
+            else new_item->set_meta("damage_type", static_cast<int>(*type_ptr));
+        }
+
+        // The item's block% modifier, if a ny.
+        if (item_data["block_mod"]) new_item->set_meta("block_mod", item_data["block_mod"].as<int>());
+
+        // The item's dodge% modifier, if any.
+        if (item_data["dodge_mod"]) new_item->set_meta("dodge_mod", item_data["dodge_mod"].as<int>());
+
+        // The item's parry% modifier, if any.
+        if (item_data["parry_mod"]) new_item->set_meta("parry_mod", item_data["parry_mod"].as<int>());
+
+        // The Item's critical power, if any.
+        if (item_data["crit"]) new_item->set_meta("crit", item_data["crit"].as<int>());
+
+        // The Item's speed, if any.
+        if (item_data["speed"]) new_item->set_meta("speed", item_data["speed"].as<float>());
+
+        // The Item's capacity, if any.
+        if (item_data["capacity"]) new_item->set_meta("capacity", item_data["capacity"].as<int>());
+
+        // The Item's charge, if any.
+        if (item_data["charge"]) new_item->set_meta("charge", item_data["charge"].as<int>());
+
+        // The Item's EquipSlot, if any.
+        if (item_data["slot"])
+        {
+            const std::string slot_str = item_data["slot"].as<std::string>();
+            const auto slot_ptr = EQUIP_SLOT_MAP.find(slot_str);
+            if (!slot_ptr) entry.warnings.emplace_back("Unrecognized equipment slot (" + slot_str + "): " + item_id_str, Guru::GURU_ERROR);
+            else
+            {
+                EquipSlot chosen_slot = *slot_ptr;
+                if (new_item->type() == ItemType::SHIELD && new_item->equip_slot() == EquipSlot::HAND_MAIN) chosen_slot = EquipSlot::HAND_OFF;
+                new_item->set_meta("slot", static_cast<int>(chosen_slot));
+            }
+        }
+
+        // The Item's power, if any.
+        if (item_data["power"]) new_item->set_meta("power", item_data["power"].as<int>());
+
+        // The Item's ammunition power, if any.
+        if (item_data["ammo_power"]) new_item->set_meta("ammo_power", item_data["ammo_power"].as<float>());
+
+        // The Item's warmth rating, if any.
+        if (item_data["warmth"]) new_item->set_meta("warmth", item_data["warmth"].as<int>());
+
+        // The Item's bleed chance, if any.
+        if (item_data["bleed"]) new_item->set_meta("bleed", item_data["bleed"].as<int>());
+
+        // The Item's poison chance, if any.
+        if (item_data["poison"]) new_item->set_meta("poison", item_data["poison"].as<int>());
+
+        // The Item's liquid type, if any.
+        if (item_data["liquid"]) new_item->set_meta("liquid", item_data["liquid"].as<std::string>());
+
+        // The Item's description, if any.
+        if (!item_data["desc"]) entry.warnings.emplace_back("Missing description for item " + item_id_str, Guru::GURU_WARN);
+        else
+        {
+            const std::string desc = item_data["desc"].as<std::string>();
+            if (desc != "-") new_item->set_description(desc);
+        }
+
+        // The Item's value.
+        unsigned int item_value = 0;
+        if (!item_data["value"]) entry.warnings.emplace_back("Missing value for item " + item_id_str, Guru::GURU_WARN);
+        else
+        {
+            const std::string value_str = item_data["value"].as<std::string>();
+            if (value_str.size() && value_str != "0" && value_str != "-")
+            {
+                std::vector<std::string> coins_split = StrX::string_explode(value_str, " ");
+                while (coins_split.size())
+                {
+                    const std::string coin_str = coins_split.at(0);
+                    coins_split.erase(coins_split.begin());
+                    if (coin_str.size() < 2) throw std::runtime_error("Malformed item value string on " + item_id_str);
+                    const char currency = coin_str[coin_str.size() - 1];
+                    unsigned int currency_amount = std::stoi(coin_str.substr(0, coin_str.size() - 1));
+                    if (currency == 'c') item_value += currency_amount;
+                    else if (currency == 's') item_value += currency_amount * 10;
+                    else if (currency == 'g') item_value += currency_amount * 1000;
+                    else if (currency == 'm') item_value += currency_amount * 1000000;
+                    else throw std::runtime_error("Malformed item value string on " + item_id_str);
+                }
+                if (!item_value) throw std::runtime_error("Null coin value on " + item_id_str);
+            }
+        }
+        new_item->set_value(item_value);
+
+        // The Item's rarity.
+        if (!item_data["rare"]) entry.warnings.emplace_back("Missing rarity for item " + item_id_str, Guru::GURU_WARN);
+        else new_item->set_rare(item_data["rare"].as<int>());
+
+        // The Item's weight.
+        if (!item_data["weight"]) entry.warnings.emplace_back("Missing weight for item " + item_id_str, Guru::GURU_ERROR);
+        else new_item->set_weight(item_data["weight"].as<uint32_t>());
+
+        // The Item's stack size, if any.
+        if (item_data["stack"])
+        {
+            if (!new_item->tag(ItemTag::Stackable)) entry.warnings.emplace_back("Stack size specified for nonstackable item: " + item_id_str, Guru::GURU_ERROR);
+            new_item->set_stack(item_data["stack"].as<uint32_t>());
+        }
+
+        // The Item is only added to the item pool once it's merged on the main thread.
+        entry.data = new_item;
+    }
+}
+
+// Parses one of the List YAML files. This runs on a worker thread, so rather than touching the list pool itself, it leaves that for load_lists().
+void World::parse_list_file(const std::string &filename, DataFile<List> &data_file)
+{
+    const YAML::Node yaml_lists = YAML::LoadFile("data/lists/" + filename);
+    for (auto list : yaml_lists)
+    {
+        data_file.entries.emplace_back();
+        auto &entry = data_file.entries.back();
+
+        // First, determine the List's ID.
+        const std::string list_id = list.first.as<std::string>();
+        entry.id = list_id;
+
+        // Get the rest of the data.
+        const YAML::Node yaml_list = list.second;
+        if (!yaml_list.IsSequence()) throw std::runtime_error("Invalid list data for list " + list_id);
+
+        auto new_list = std::make_shared<List>();
+        bool is_count = false;
+        ListEntry new_list_entry;
+        for (auto le : yaml_list)
+        {
+            if (is_count)
+            {
+                new_list_entry.count = le.as<int>();
+                new_list->push_back(new_list_entry);
+                is_count = false;
+            }
+            else
+            {
+                const std::string str = le.as<std::string>();
+                new_list_entry.str = str;
+                if (str.size() && (str[0] == '#' || str[0] == '+' || str[0] == '&'))
+                {
+                    new_list_entry.count = -1;
+                    new_list->push_back(new_list_entry);
+                }
+                else is_count = true;
+            }
+        }
+        if (is_count) throw std::runtime_error("Invalid list length: " + list_id);
+        entry.data = new_list;
+    }
+}
+
+// Parses one of the Mobile YAML files. This runs on a worker thread, so rather than touching the mob pool or reporting errors itself, it leaves them for load_mob_pool().
+void World::parse_mob_file(const std::string &filename, DataFile<Mobile> &data_file)
+{
+    const YAML::Node yaml_mobiles = YAML::LoadFile("data/mobiles/" + filename);
+    for (auto mobile : yaml_mobiles)
+    {
+        data_file.entries.emplace_back();
+        auto &entry = data_file.entries.back();
+        const YAML::Node mobile_data = mobile.second;
+
+        // Create a new Mobile object.
+        const std::string mobile_id_str = mobile.first.as<std::string>();
+        entry.id = mobile_id_str;
+        const auto new_mob(std::make_shared<Mobile>());
+
+        // Verify all keys in this file.
+        for (auto key_value : mobile_data)
+        {
+            const std::string key = key_value.first.as<std::string>();
+            if (!VALID_YAML_KEYS_MOBS.contains(key))
+                entry.warnings.emplace_back("Invalid key in mobile YAML data (" + key + "): " + mobile_id_str, Guru::GURU_WARN);
+        }
+
+        // The Mobile's name.
+        if (!mobile_data["name"]) entry.warnings.emplace_back("Missing mobile name: " + mobile_id_str, Guru::GURU_ERROR);
+        else new_mob->set_name(mobile_data["name"].as<std::string>());
+
+        // The Mobile's hit points.
+        if (!mobile_data["hp"]) entry.warnings.emplace_back("Missing mobile hit points: "+ mobile_id_str, Guru::GURU_ERROR);
+        else new_mob->set_hp(mobile_data["hp"].as<int>(), mobile_data["hp"].as<int>());
+
+        // The Mobile's score, if any.
+        if (mobile_data["score"]) new_mob->add_score(mobile_data["score"].as<int>());
+
+        // The Mobile's species.
+        if (!mobile_data["species"]) entry.warnings.emplace_back("Missing species: " + mobile_id_str, Guru::GURU_CRITICAL);
+        else new_mob->set_species(mobile_data["species"].as<std::string>());
+
+        // The Mobile's tags, if any.
+        if (mobile_data["tags"])
+        {
+            if (!mobile_data["tags"].IsSequence()) entry.warnings.emplace_back("{r}Malformed mobile tags: " + mobile_id_str, Guru::GURU_ERROR);
+            else for (auto tag : mobile_data["tags"])
+            {
+                const std::string tag_str = StrX::str_tolower(tag.as<std::string>());
+                const auto tag_ptr = MOBILE_TAG_MAP.find(tag_str);
+                if (!tag_ptr) entry.warnings.emplace_back("Unrecognized mobile tag (" + tag_str + "): " + mobile_id_str, Guru::GURU_ERROR);
+                else new_mob->set_tag(*tag_ptr);
+            }
+        }
+
+        // The Mobile's gear list.
+        if (mobile_data["gear"]) entry.extra = mobile_data["gear"].as<std::string>();
+
+        // The Mobile is only added to the mob pool once it's merged on the main thread.
+        entry.data = new_mob;
+    }
+}
+
+// Parses one of the area YAML files. This runs on a worker thread, so rather than touching the room pool or reporting errors itself, it leaves them for load_room_pool().
+void World::parse_room_file(const std::string &filename, DataFile<Room> &data_file)
+{
+    const YAML::Node yaml_rooms = YAML::LoadFile("data/areas/" + filename);
+    for (auto room : yaml_rooms)
+    {
+        data_file.entries.emplace_back();
+        auto &entry = data_file.entries.back();
+        const YAML::Node room_data = room.second;
+
+        // Create a new Room object, and set its unique ID.
+        const std::string room_id = room.first.as<std::string>();
+        entry.id = room_id;
+        const auto new_room(std::make_shared<Room>(room_id));
+
+        // Verify all keys in this file.
+        for (auto key_value : room_data)
+        {
+            const std::string key = key_value.first.as<std::string>();
+            if (!VALID_YAML_KEYS_AREAS.contains(key))
+                entry.warnings.emplace_back("Invalid key in room YAML data (" + key + "): " + room_id, Guru::GURU_WARN);
+        }
+
+        // The Room's long and short names.
+        if (!room_data["name"] || room_data["name"].size() < 2) entry.warnings.emplace_back("Missing or invalid room name(s): " + room_id, Guru::GURU_ERROR);
+        else new_room->set_name(room_data["name"][0].as<std::string>(), room_data["name"][1].as<std::string>());
+
+        // The Room's description.
+        if (!room_data["desc"]) entry.warnings.emplace_back("Missing room description: " + room_id, Guru::GURU_WARN);
+        else
+        {
+            const std::string desc = room_data["desc"].as<std::string>();
+            if (desc != "-") new_room->set_desc(desc);
+        }
+
+        // Links to other Rooms.
+        if (room_data["exits"])
+        {
+            for (unsigned int e = 0; e < Room::ROOM_LINKS_MAX; e++)
+            {
+                const Direction dir = static_cast<Direction>(e);
+                const std::string dir_str = StrX::dir_to_name(dir);
+                if (room_data["exits"][dir_str]) new_room->set_link(dir, room_data["exits"][dir_str].as<std::string>());
+            }
+        }
+
+        // The light level of the Room.
+        if (!room_data["light"]) entry.warnings.emplace_back("Missing room light level: " + room_id, Guru::GURU_ERROR);
+        else
+        {
+            const std::string light_str = room_data["light"].as<std::string>();
+            const auto level_ptr = LIGHT_LEVEL_MAP.find(light_str);
+            if (!level_ptr) entry.warnings.emplace_back("Invalid light level value: " + room_id, Guru::GURU_ERROR);
+            else new_room->set_base_light(*level_ptr);
+        }
+
+        // The security level of this Room.
+        if (!room_data["security"]) entry.warnings.emplace_back("Missing room security level: " + room_id, Guru::GURU_ERROR);
+        else
+        {
+            const std::string sec_str = room_data["security"].as<std::string>();
+            const auto sec_ptr = SECURITY_MAP.find(sec_str);
+            if (!sec_ptr) entry.warnings.emplace_back("Invalid security level value: " + room_id, Guru::GURU_ERROR);
+            else new_room->set_security(*sec_ptr);
+        }
+
+        // Room tags, if any.
+        if (room_data["tags"])
+        {
+            if (!room_data["tags"].IsSequence()) entry.warnings.emplace_back("{r}Malformed room tags: " + room_id, Guru::GURU_ERROR);
+            else for (auto tag : room_data["tags"])
+            {
+                const std::string tag_str = StrX::str_tolower(tag.as<std::string>());
+
+                // Tags starting with a direction (e.g. "northlocked") are tags for the link in that direction, anything else is a tag on the Room itself.
+                size_t dir_len = 0;
+                const auto dir_ptr = LINK_DIRECTION_MAP.find_prefix(tag_str, dir_len);
+                if (!dir_ptr)
+                {
+                    const auto tag_ptr = ROOM_TAG_MAP.find(tag_str);
+                    if (!tag_ptr) entry.warnings.emplace_back("Unrecognized room tag (" + tag_str + "): " + room_id, Guru::GURU_WARN);
+                    else new_room->set_tag(*tag_ptr);
+                }
+                else
+                {
+                    const Direction dir = *dir_ptr;
+                    const auto dtag_ptr = LINK_TAG_MAP.find(tag_str.data() + dir_len, tag_str.size() - dir_len);
+                    if (!dtag_ptr) entry.warnings.emplace_back("Unrecognized link tag (" + tag_str.substr(dir_len) + ") on " + LINK_DIRECTION_MAP.name(dir) + " link: " + room_id, Guru::GURU_WARN);
+                    else
+                    {
+                        const LinkTag lt = *dtag_ptr;
+                        switch (lt)
+                        {
+                            case LinkTag::Lockable:
+                            case LinkTag::Window:
+                                new_room->set_link_tag(dir, LinkTag::Openable);
+                                break;
+                            case LinkTag::LockedByDefault:
+                                new_room->set_link_tag(dir, LinkTag::Lockable);
+                                new_room->set_link_tag(dir, LinkTag::Openable);
+                                break;
+                            case LinkTag::Open:
+                                new_room->set_link_tag(dir, LinkTag::Openable);
+                                break;
+                            default: break;
+                        }
+                        new_room->set_link_tag(dir, lt);
+                    }
+                }
+            }
+        }
+
+        // Mobile spawns, if any.
+        if (room_data["spawn_mobs"])
+        {
+            if (room_data["spawn_mobs"].IsSequence())
+            {
+                for (auto e : room_data["spawn_mobs"])
+                    new_room->add_mob_spawn(e.as<std::string>());
+            }
+            else new_room->add_mob_spawn(room_data["spawn_mobs"].as<std::string>());
+        }
+
+        // The Room's metadata, if any.
+        if (room_data["metadata"])
+        {
+            std::map<std::string, std::string> room_metadata;
+            StrX::string_to_metadata(room_data["metadata"].as<std::string>(), room_metadata);
+            *new_room->meta_raw() = Symbols::intern_keys(room_metadata);
+        }
+
+        // The room's  shop type, if any.
+        if (room_data["shop_type"]) new_room->set_meta("shop_type", room_data["shop_type"].as<std::string>());
+
+        // Clear the meta changed tag, since this is static data.
+        new_room->clear_tag(RoomTag::MetaChanged);
+
+        // The Room is only added to the room pool once it's merged on the main thread.
+        entry.data = new_room;
+    }
+}
+
+// Takes files from the queue and parses them, until the queue is empty. Runs on a worker thread.
+void World::parse_worker(std::shared_ptr<ParseQueue> queue)
+{
+    while (true)
+    {
+        std::function<void()> parse_file;
+        {
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            if (!queue->files.size()) return;
+            parse_file = std::move(queue->files.front());
+            queue->files.pop_front();
+        }
+        parse_file();
+    }
+}
+
 // Retrieves a pointer to the Player object.
 const std::shared_ptr<Player> World::player() const { return player_; }
 
@@ -1024,15 +1357,38 @@ void World::remove_mobile(size_t id)
 {
     for (size_t i = 0; i < mobiles_.size(); i++)
     {
-        if (mobiles_.at(i)->id() == id)
+        if (mobiles_.at(i)->id() != id) continue;
+        removed_mobs_.insert(id);
+
+        // The Mobiles after the removed one keep their order, as the order Mobiles act in has to match a reloaded game. Each of them moves down a position, so only their room index entries need to change.
+        unindex_mobile(i, mobiles_.at(i)->location());
+        for (size_t j = i + 1; j < mobiles_.size(); j++)
         {
-            mobiles_.erase(mobiles_.begin() + i);
-            return;
+            auto &room = room_mobiles_[mobiles_.at(j)->location()];
+            room.erase(j);
+            room.insert(j - 1);
         }
+        mobiles_.erase(mobiles_.begin() + i);
+        verify_mob_index();
+        return;
     }
     core()->guru()->nonfatal("Attempt to remove mobile that does not exist in the world.", Guru::GURU_ERROR);
 }
 
+// Logs any interned ID strings which share the same hash, as they'd clash if ever used as IDs in the same hash-keyed pool.
+void World::report_symbol_collisions()
+{
+    for (auto collision : Symbols::collisions())
+        core()->guru()->log("ID hash collision between " + collision.first + " and " + collision.second + ".", Guru::GURU_WARN);
+}
+
+// Reports the nonfatal errors found while a data file entry was being parsed on a worker thread.
+void World::report_warnings(const std::vector<std::pair<std::string, int>> &warnings)
+{
+    for (auto warning : warnings)
+        core()->guru()->nonfatal(warning.first, warning.second);
+}
+
 // Checks if a room is currently active.
 bool World::room_active(uint32_t id) const { return active_rooms_.count(id); }
 
@@ -1040,42 +1396,143 @@ bool World::room_active(uint32_t id) const { return active_rooms_.count(id); }
 bool World::room_exists(const std::string &str) const { return room_pool_.count(StrX::hash(str)); }
 
 // Saves the World and all things within it.
-void World::save(std::shared_ptr<SQLite::Database> save_db)
+void World::save(std::shared_ptr<SQLite::Database> save_db, bool in_place)
 {
-    save_db->exec(Buff::SQL_BUFFS);
-    save_db->exec(Item::SQL_ITEMS);
-    save_db->exec(MessageLog::SQL_MSGLOG);
-    save_db->exec(Mobile::SQL_MOBILES);
-    save_db->exec(Player::SQL_PLAYER);
-    save_db->exec(Player::SQL_SKILLS);
-    save_db->exec(Room::SQL_ROOMS);
-    save_db->exec(Shop::SQL_SHOPS);
-    save_db->exec(TimeWeather::SQL_HEARTBEATS);
-    save_db->exec(TimeWeather::SQL_TIME_WEATHER);
-    save_db->exec(SQL_WORLD);
-
-    SQLite::Statement query(*save_db, "INSERT INTO world ( mob_unique_id ) VALUES ( :mob_unique_id )");
+    if (in_place)
+    {
+        // The small single-row tables are simply cleared and written again. The Player is always saved, as is anything in an active Room.
+        save_db->exec("DELETE FROM heartbeats; DELETE FROM player; DELETE FROM skills; DELETE FROM time_weather; DELETE FROM world");
+        delete_saved_mobile(save_db, player_->id());
+        for (auto id : removed_mobs_)
+            delete_saved_mobile(save_db, id);
+    }
+    else
+    {
+        save_db->exec(Buff::SQL_BUFFS);
+        save_db->exec(Item::SQL_ITEMS);
+        save_db->exec(MessageLog::SQL_MSGLOG);
+        save_db->exec(Mobile::SQL_MOBILES);
+        save_db->exec(Player::SQL_PLAYER);
+        save_db->exec(Player::SQL_SKILLS);
+        save_db->exec(Room::SQL_ROOMS);
+        save_db->exec(Shop::SQL_SHOPS);
+        save_db->exec(TimeWeather::SQL_HEARTBEATS);
+        save_db->exec(TimeWeather::SQL_TIME_WEATHER);
+        save_db->exec(SQL_WORLD);
+    }
+    removed_mobs_.clear();
+
+    SQLite::Statement &query = core()->sql_statement(save_db, "INSERT INTO world ( mob_unique_id ) VALUES ( :mob_unique_id )");
     query.bind(":mob_unique_id", mob_unique_id_);
     query.exec();
 
     player_->save(save_db);
-    core()->messagelog()->save(save_db);
+    core()->messagelog()->save(save_db, in_place);
     time_weather_->save(save_db);
 
     for (auto room : room_pool_)
     {
-        // Temporarily tag the room with SaveActive, if it's in the active rooms list.
+        // Active Rooms are always saved, as anything could have happened in them; inactive Rooms only if they've changed.
         const bool is_active = room_active(room.first);
+        if (in_place)
+        {
+            if (!is_active && !room.second->dirty()) continue;
+            delete_saved_room(save_db, room.first);
+        }
+
+        // Temporarily tag the room with SaveActive, if it's in the active rooms list.
         if (is_active) room.second->set_tag(RoomTag::SaveActive);
         room.second->save(save_db);
         if (is_active) room.second->clear_tag(RoomTag::SaveActive);
     }
 
+    // Dormant Mobiles don't change, so they only need to be saved again if they've gone dormant since the last save.
     for (auto mob : mobiles_)
+    {
+        if (in_place)
+        {
+            if (mob->is_dormant() && !mob->dirty()) continue;
+            delete_saved_mobile(save_db, mob->id());
+        }
         mob->save(save_db);
+    }
 
     for (auto shop : shops_)
+    {
+        if (in_place)
+        {
+            if (!shop.second->dirty()) continue;
+            delete_saved_shop(save_db, shop.first);
+        }
         shop.second->save(save_db);
+    }
+
+    // The owner indexes are built last, as it's quicker to build them in one go than to update them with every insert.
+    if (in_place) return;
+    save_db->exec(Buff::SQL_BUFFS_INDEX);
+    save_db->exec(Item::SQL_ITEMS_INDEX);
+}
+
+// Writes all the static game data to the data cache.
+void World::save_cache(DataCache &cache) const
+{
+    cache.write_uint(room_pool_.size());
+    for (auto room : room_pool_)
+        room.second->cache_write(cache);
+
+    cache.write_uint(item_pool_.size());
+    for (auto item : item_pool_)
+    {
+        cache.write_uint(item.first);
+        item.second->cache_write(cache);
+    }
+
+    cache.write_uint(mob_pool_.size());
+    for (auto mob : mob_pool_)
+    {
+        cache.write_uint(mob.first);
+        mob.second->cache_write(cache);
+        cache.write_string(Symbols::str(mob_gear_.at(mob.first)));
+    }
+
+    cache.write_uint(anatomy_pool_.size());
+    for (auto anatomy : anatomy_pool_)
+    {
+        cache.write_string(Symbols::str(anatomy.first));
+        cache.write_uint(anatomy.second.size());
+        for (auto bp : anatomy.second)
+        {
+            cache.write_string(bp->name);
+            cache.write_uint(bp->hit_chance);
+            cache.write_uint(static_cast<uint8_t>(bp->slot));
+        }
+    }
+
+    std::map<std::string, std::string> generic_descs;
+    for (auto desc : generic_descs_)
+        generic_descs.insert(std::make_pair(Symbols::str(desc.first), desc.second));
+    cache.write_map(generic_descs);
+
+    cache.write_uint(list_pool_.size());
+    for (auto list : list_pool_)
+    {
+        cache.write_string(Symbols::str(list.first));
+        cache.write_uint(list.second->size());
+        for (size_t e = 0; e < list.second->size(); e++)
+        {
+            const ListEntry entry = list.second->at(e, true);
+            cache.write_string(entry.str);
+            cache.write_uint(entry.count);
+        }
+    }
+
+    cache.write_uint(skills_.size());
+    for (auto skill : skills_)
+    {
+        cache.write_string(Symbols::str(skill.first));
+        cache.write_string(skill.second.name);
+        cache.write_float(skill.second.xp_multi);
+    }
 }
 
 // Assigns the player starter equipment from a list.
@@ -1096,3 +1553,52 @@ void World::starter_equipment(const std::string &list_name)
 
 // Gets a pointer to the TimeWeather object.
 const std::shared_ptr<TimeWeather> World::time_weather() const { return time_weather_; }
+
+// Removes a Mobile's vector position from the room index.
+void World::unindex_mobile(size_t pos, uint32_t location)
+{
+    const auto room = room_mobiles_.find(location);
+    if (room == room_mobiles_.end()) return;
+    room->second.erase(pos);
+    if (!room->second.size()) room_mobiles_.erase(room);
+}
+
+// Updates the room index when a Mobile changes location.
+void World::update_mob_location(const Mobile *mob, uint32_t old_location)
+{
+    if (mob->location() == old_location) return;
+    const auto old_room = room_mobiles_.find(old_location);
+    if (old_room == room_mobiles_.end()) return;    // Mobiles that haven't been added to the world yet won't be in the index.
+    for (auto pos : old_room->second)
+    {
+        if (mobiles_.at(pos).get() != mob) continue;
+        room_mobiles_[mob->location()].insert(pos);
+        old_room->second.erase(pos);
+        if (!old_room->second.size()) room_mobiles_.erase(old_room);
+
+        // Mobiles wandering away from the player go dormant; Mobiles brought back into an active room wake up again.
+        if (room_active(mob->location())) mobiles_.at(pos)->wake_up();
+        else mobiles_.at(pos)->make_dormant();
+        verify_mob_index();
+        return;
+    }
+}
+
+// Checks the room index against the Mobiles vector, and that the Mobiles are still in order of their unique IDs. Only does anything in debug builds.
+void World::verify_mob_index() const
+{
+#ifndef NDEBUG
+    for (size_t i = 1; i < mobiles_.size(); i++)
+        if (mobiles_.at(i - 1)->id() >= mobiles_.at(i)->id()) core()->guru()->nonfatal("Mobiles are out of order!", Guru::GURU_ERROR);
+    size_t indexed = 0;
+    for (auto room : room_mobiles_)
+    {
+        for (auto pos : room.second)
+        {
+            if (pos >= mobiles_.size() || mobiles_.at(pos)->location() != room.first) core()->guru()->nonfatal("Mobile room index is out of sync!", Guru::GURU_ERROR);
+            indexed++;
+        }
+    }
+    if (indexed != mobiles_.size()) core()->guru()->nonfatal("Mobile room index is missing entries!", Guru::GURU_ERROR);
+#endif
+}
@@ -5,6 +5,8 @@
 #define GREAVE_WORLD_WORLD_H_
 
 #include "3rdparty/SQLiteCpp/Database.h"
+#include "core/data-cache.h"
+#include "core/keyword-table.h"
 #include "core/list.h"
 #include "world/player.h"
 #include "world/room.h"
@@ -13,8 +15,12 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <vector>
@@ -23,19 +29,24 @@
 class World
 {
 public:
-                    World();                                                    // Constructor, loads the room YAML data.
-    std::set<uint32_t>  active_rooms() const;                                   // Retrieve a list of all active rooms.
+                    World();                                                    // Constructor, loads the static game data from the data cache, or from the YAML files if the cache is out of date.
+    std::vector<std::shared_ptr<Mobile>>    active_mobs() const;                // Returns all the Mobiles in active rooms, in vector order.
+    const std::set<uint32_t>&   active_rooms() const;                           // Retrieve a list of all active rooms.
     void            add_mobile(std::shared_ptr<Mobile> mob);                    // Adds a Mobile to the world.
+    void            add_room(std::shared_ptr<Room> room);                       // Adds a new Room to the world, which isn't in the area data files.
     std::string     generic_desc(const std::string &id) const;                  // Retrieves a generic description string.
+    std::string     generic_desc(uint32_t id) const;                            // As above, but with a generic description symbol.
     const std::vector<std::shared_ptr<BodyPart>>& get_anatomy(const std::string &id) const; // Retrieves a copy of the anatomy data for a given species.
+    const std::vector<std::shared_ptr<BodyPart>>& get_anatomy(uint32_t species) const;      // As above, but with a species symbol.
     const std::shared_ptr<Item>     get_item(const std::string &item_id, int stack_size = 0) const; // Retrieves a specified Item by ID.
     std::shared_ptr<List>           get_list(const std::string &list_id) const; // Retrieves a specified List by ID.
+    std::shared_ptr<List>           get_list(uint32_t list_sym) const;          // As above, but with a List ID symbol.
     const std::shared_ptr<Mobile>   get_mob(const std::string &mob_id) const;   // Retrieves a specified Mobile by ID.
     const std::shared_ptr<Room>     get_room(uint32_t room_id) const;           // Retrieves a specified Room by ID.
     const std::shared_ptr<Room>     get_room(const std::string &room_id) const; // As above, but with a Room ID string.
     const std::shared_ptr<Shop> get_shop(uint32_t id);                          // Returns a specified shop, or creates a new shop if this ID doesn't yet exist.
-    float           get_skill_multiplier(const std::string &skill);             // Retrieves the XP gain multiplier for a specified skill.
-    std::string     get_skill_name(const std::string &skill);                   // Retrieves the name of a specified skill.
+    float           get_skill_multiplier(uint32_t skill);                       // Retrieves the XP gain multiplier for a specified skill symbol.
+    std::string     get_skill_name(uint32_t skill);                             // Retrieves the name of a specified skill symbol.
     bool            item_exists(const std::string &str) const;                  // Checks if a specified item ID exists.
     void            load(std::shared_ptr<SQLite::Database> save_db);            // Loads the World and all things within it.
     void            main_loop_events_post_input();                              // Triggers events that happen during the main loop, just after player input.
@@ -43,15 +54,17 @@ public:
     size_t          mob_count() const;                                          // Returns the number of Mobiles currently active.
     bool            mob_exists(const std::string &str) const;                   // Checks if a specified mobile ID exists.
     const std::shared_ptr<Mobile>   mob_vec(size_t vec_pos) const;              // Retrieves a Mobile by vector position.
+    const std::set<size_t>& mobs_in_room(uint32_t room_id) const;               // Returns the vector positions of all Mobiles in a specified Room.
     void            new_game();                                                 // Sets up for a new game.
     const std::shared_ptr<Player>   player() const;                             // Retrieves a pointer to the Player object.
     void            recalc_active_rooms();                                      // Recalculates the list of active rooms.
     void            remove_mobile(size_t id);                                   // Removes a Mobile from the world.
     bool            room_active(uint32_t id) const;                             // Checks if a room is currently active.
     bool            room_exists(const std::string &str) const;                  // Checks if a specified room ID exists.
-    void            save(std::shared_ptr<SQLite::Database> save_db);            // Saves the World and all things within it.
+    void            save(std::shared_ptr<SQLite::Database> save_db, bool in_place = false); // Saves the World and all things within it, optionally only rewriting what changed since the last save.
     void            starter_equipment(const std::string &list_name);            // Assigns the player starter equipment from a list.
     const std::shared_ptr<TimeWeather> time_weather() const;                    // Gets a pointer to the TimeWeather object.
+    void            update_mob_location(const Mobile *mob, uint32_t old_location);  // Updates the room index when a Mobile changes location.
 
 private:
     struct SkillData
@@ -60,47 +73,89 @@ private:
         float       xp_multi;   // The multiplier applied to the XP gained when using this skill.
     };
 
+    // The results of parsing one of the YAML files in a data folder on a worker thread, which are merged into the World's pools on the main thread, in file order.
+    template<class T> struct DataFile
+    {
+        struct Entry
+        {
+            std::shared_ptr<T>  data;   // The parsed Room, Item, Mobile or List, or nullptr if parsing stopped partway through this entry.
+            std::string         extra;  // Anything else parsed alongside this entry, such as a Mobile's gear list.
+            std::string         id;     // The entry's ID, as written in the YAML file.
+            std::vector<std::pair<std::string, int>>    warnings;   // Nonfatal errors found while parsing this entry, which are reported when it's merged.
+        };
+
+        std::vector<Entry>  entries;    // The entries parsed from this file, in file order.
+        std::string         error;      // The error that stopped this file being parsed, if any.
+        std::string         filename;   // The file's name, relative to its data folder.
+    };
+
+    // The data files waiting to be parsed, which a fixed number of worker threads take from in turn.
+    struct ParseQueue
+    {
+        std::deque<std::function<void()>>   files;  // One job per file, which parses it and hands the result to that file's future.
+        std::mutex                          mutex;  // Locked while a worker thread takes a file from the queue.
+    };
+
     static constexpr int                                ROOM_SCAN_DISTANCE =    10; // The distance to scan for active rooms.
-    static const std::map<std::string, DamageType>      DAMAGE_TYPE_MAP;        // Lookup table for converting DamageType text names into enums.
-    static const std::map<std::string, EquipSlot>       EQUIP_SLOT_MAP;         // Lookup table for converting EquipSlot text names into enums.
-    static const std::map<std::string, ItemSub>         ITEM_SUBTYPE_MAP;       // Lookup table for converting ItemSub text names into enums.
-    static const std::map<std::string, ItemTag>         ITEM_TAG_MAP;           // Lookup table for converting ItemTag text names into enums.
-    static const std::map<std::string, ItemType>        ITEM_TYPE_MAP;          // Lookup table for converting ItemType text names into enums.
-    static const std::map<std::string, uint8_t>         LIGHT_LEVEL_MAP;        // Lookup table for converting textual light levels (e.g. "bright") to integer values.
-    static const std::map<std::string, LinkTag>         LINK_TAG_MAP;           // Lookup table for converting LinkTag text names into enums.
-    static const std::map<std::string, MobileTag>       MOBILE_TAG_MAP;         // Lookup table for converting MobileTag text names into enums.
-    static const std::map<std::string, RoomTag>         ROOM_TAG_MAP;           // Lookup table for converting RoomTag text names into enums.
-    static const std::map<std::string, Room::Security>  SECURITY_MAP;           // Lookup table for converting textual room security (e.g. "anarchy") to enum values.
+    static const KeywordTable<DamageType, 11>           DAMAGE_TYPE_MAP;        // Lookup table for converting DamageType text names into enums.
+    static const KeywordTable<EquipSlot, 7>             EQUIP_SLOT_MAP;         // Lookup table for converting EquipSlot text names into enums.
+    static const KeywordTable<ItemSub, 14>              ITEM_SUBTYPE_MAP;       // Lookup table for converting ItemSub text names into enums.
+    static const KeywordTable<ItemTag, 14>              ITEM_TAG_MAP;           // Lookup table for converting ItemTag text names into enums.
+    static const KeywordTable<ItemType, 11>             ITEM_TYPE_MAP;          // Lookup table for converting ItemType text names into enums.
+    static const KeywordTable<uint8_t, 5>               LIGHT_LEVEL_MAP;        // Lookup table for converting textual light levels (e.g. "bright") to integer values.
+    static const KeywordTable<Direction, 10>            LINK_DIRECTION_MAP;     // Lookup table for the direction prefixes on link tags in area YAML files (e.g. "northlocked").
+    static const KeywordTable<LinkTag, 24>              LINK_TAG_MAP;           // Lookup table for converting LinkTag text names into enums.
+    static const KeywordTable<MobileTag, 22>            MOBILE_TAG_MAP;         // Lookup table for converting MobileTag text names into enums.
+    static const KeywordTable<RoomTag, 32>              ROOM_TAG_MAP;           // Lookup table for converting RoomTag text names into enums.
+    static const KeywordTable<Room::Security, 5>        SECURITY_MAP;           // Lookup table for converting textual room security (e.g. "anarchy") to enum values.
     static const char                                   SQL_WORLD[];            // The SQL construction table for the world data.
-    static const std::set<std::string>                  VALID_YAML_KEYS_AREAS;  // A list of all valid keys in area YAML files.
-    static const std::set<std::string>                  VALID_YAML_KEYS_ITEMS;  // A list of all valid keys in item YAML files.
-    static const std::set<std::string>                  VALID_YAML_KEYS_MOBS;   // A list of all valid keys in mobile YAML files.
+    static const KeywordSet<9>                          VALID_YAML_KEYS_AREAS;  // A list of all valid keys in area YAML files.
+    static const KeywordSet<24>                         VALID_YAML_KEYS_ITEMS;  // A list of all valid keys in item YAML files.
+    static const KeywordSet<6>                          VALID_YAML_KEYS_MOBS;   // A list of all valid keys in mobile YAML files.
 
     std::set<uint32_t>                              active_rooms_;      // Rooms relatively close to the player, where AI/respawning/etc. will be active.
-    std::map<std::string, std::vector<std::shared_ptr<BodyPart>>>   anatomy_pool_;  // The anatomy pool, containing body part data for Mobiles.
-    std::map<std::string, std::string>              generic_descs_;     // Generic descriptions for items and rooms, where multiple share a description.
+    std::map<uint32_t, std::vector<std::shared_ptr<BodyPart>>>  anatomy_pool_;  // The anatomy pool, containing body part data for Mobiles, indexed by species symbol.
+    std::map<uint32_t, std::string>                 generic_descs_;     // Generic descriptions for items and rooms, where multiple share a description, indexed by symbol.
     std::map<uint32_t, std::shared_ptr<Item>>       item_pool_;         // All the Item templates in the game.
-    std::map<std::string, std::shared_ptr<List>>    list_pool_;         // List data from lists.yml
-    std::map<uint32_t, std::string>                 mob_gear_;          // Equipment lists for gearing up Mobiles.
+    std::map<uint32_t, std::shared_ptr<List>>       list_pool_;         // List data from lists.yml, indexed by list ID symbol.
+    std::map<uint32_t, uint32_t>                    mob_gear_;          // Equipment list symbols for gearing up Mobiles.
     std::map<uint32_t, std::shared_ptr<Mobile>>     mob_pool_;          // All the Mobile templates in the game.
     uint32_t                                        mob_unique_id_;     // The unique ID counter for Mobiles.
     std::vector<std::shared_ptr<Mobile>>            mobiles_;           // All the Mobiles currently active in the game.
     int                                             old_light_level_;   // Used to check when the light level changes in the player's room.
     uint32_t                                        old_location_;      // Also used for light level change checks.
     std::shared_ptr<Player>                         player_;            // The player character.
+    std::set<uint32_t>                              removed_mobs_;      // The IDs of Mobiles removed from the world since the last save, which need deleting from the save file.
+    std::map<uint32_t, std::set<size_t>>            room_mobiles_;      // The vector positions of the Mobiles in each Room, indexed by Room ID.
     std::map<uint32_t, std::shared_ptr<Room>>       room_pool_;         // All the Room templates in the game.
     std::map<uint32_t, std::shared_ptr<Shop>>       shops_;             // Any and all shops in the game.
-    std::map<std::string, SkillData>                skills_;            // The skills the player can use.
+    std::map<uint32_t, SkillData>                   skills_;            // The skills the player can use, indexed by skill ID symbol.
     std::shared_ptr<TimeWeather>                    time_weather_;      // The World's TimeWeather object, for tracking... well, the time and weather.
 
     void    active_room_scan(uint32_t target, uint32_t depth);  // Attempts to scan a room for the active rooms list. Only for internal use with recalc_active_rooms().
+    void    delete_saved_inventory(std::shared_ptr<SQLite::Database> save_db, uint32_t inventory_id);   // Deletes a saved Inventory, and any Inventories nested inside its Items, from the save file.
+    void    delete_saved_mobile(std::shared_ptr<SQLite::Database> save_db, uint32_t mob_id);    // Deletes a saved Mobile, along with its Items and Buffs, from the save file.
+    void    delete_saved_room(std::shared_ptr<SQLite::Database> save_db, uint32_t room_id);     // Deletes a saved Room, along with its Items, from the save file.
+    void    delete_saved_shop(std::shared_ptr<SQLite::Database> save_db, uint32_t shop_id);     // Deletes a saved shop, along with its Items, from the save file.
     void    load_anatomy_pool();    // Loads the anatomy YAML data into memory.
+    void    load_cache(DataCache &cache);   // Loads all the static game data from the data cache.
     void    load_generic_descs();   // Loads the generic descriptions YAML data into memory.
-    void    load_item_pool();       // Loads the Item YAML data into memory.
-    void    load_lists();           // Loads the List YAML data into memory.
-    void    load_mob_pool();        // Loads the Mobile YAML data into memory.
-    void    load_room_pool();       // Loads the Room YAML data into memory.
+    void    load_item_pool(std::vector<std::future<DataFile<Item>>> &item_files);  // Loads the Item YAML data into memory, merging the files parsed by parse_item_file() in order.
+    void    load_lists(std::vector<std::future<DataFile<List>>> &list_files);      // Loads the List YAML data into memory, merging the files parsed by parse_list_file() in order.
+    void    load_mob_pool(std::vector<std::future<DataFile<Mobile>>> &mobile_files);   // Loads the Mobile YAML data into memory, merging the files parsed by parse_mob_file() in order.
+    void    load_room_pool(std::vector<std::future<DataFile<Room>>> &area_files);  // Loads the Room YAML data into memory, merging the files parsed by parse_room_file() in order.
     void    load_skills();          // Laods the skills YAML data into memory.
+    template<class T> static std::vector<std::future<DataFile<T>>> parse_data_dir(const std::string &dir, void (*parser)(const std::string&, DataFile<T>&), ParseQueue &queue);   // Lists the YAML files in a data folder in a fixed order, and adds each of them to the queue for the worker threads to parse.
+    static void parse_item_file(const std::string &filename, DataFile<Item> &data_file);    // Parses one of the Item YAML files. This runs on a worker thread, so rather than touching the item pool or reporting errors itself, it leaves them for load_item_pool().
+    static void parse_list_file(const std::string &filename, DataFile<List> &data_file);    // Parses one of the List YAML files. This runs on a worker thread, so rather than touching the list pool itself, it leaves that for load_lists().
+    static void parse_mob_file(const std::string &filename, DataFile<Mobile> &data_file);   // Parses one of the Mobile YAML files. This runs on a worker thread, so rather than touching the mob pool or reporting errors itself, it leaves them for load_mob_pool().
+    static void parse_room_file(const std::string &filename, DataFile<Room> &data_file);    // Parses one of the area YAML files. This runs on a worker thread, so rather than touching the room pool or reporting errors itself, it leaves them for load_room_pool().
+    static void parse_worker(std::shared_ptr<ParseQueue> queue);    // Takes files from the queue and parses them, until the queue is empty. Runs on a worker thread.
+    static void report_symbol_collisions(); // Logs any interned ID strings which share the same hash, as they'd clash if ever used as IDs in the same hash-keyed pool.
+    static void report_warnings(const std::vector<std::pair<std::string, int>> &warnings); // Reports the nonfatal errors found while a data file entry was being parsed on a worker thread.
+    void    save_cache(DataCache &cache) const; // Writes all the static game data to the data cache.
+    void    unindex_mobile(size_t pos, uint32_t location);  // Removes a Mobile's vector position from the room index.
+    void    verify_mob_index() const;   // Checks the room index against the Mobiles vector, and that the Mobiles are still in order of their unique IDs. Only does anything in debug builds.
 };
 
 #endif  // GREAVE_WORLD_WORLD_H_